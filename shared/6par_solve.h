@@ -34,6 +34,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __6_PAR_SOLVE_H__
 #define __6_PAR_SOLVE_H__
 
+#include <algorithm>
+#include <vector>
+
 #include "6par_gamma.h"
 #include "6par_newton.h"
 #include "lib_util.h"
@@ -303,6 +306,18 @@ public:
 
 
 
+	}
+
+	void guess_from( const module6par &ref )
+	{
+		// initial conditions scaled from a similar module that has already been solved
+		a = ref.a;
+		Il = ref.Il * Isc / ref.Isc;
+		Io = ref.Io * ( Il / ref.Il ) * exp( (ref.Voc - Voc) / a );
+		double Rscale = ( Vmp / Imp ) / ( ref.Vmp / ref.Imp );
+		Rs = ref.Rs * Rscale;
+		Rsh = ref.Rsh * Rscale;
+		Adj = ref.Adj;
 	}
 
 	void guess_ees()
@@ -350,6 +365,19 @@ public:
 		return 0;
 	}
 
+	double max_residual()
+	{
+		// largest absolute residual of the six equations at the current parameters
+		__Module6ParNonlinear<double> eqns( 0, Vmp, Imp, Voc, Isc, bVoc, aIsc, gPmp, bandgap(), Tref );
+		double x[6] = { a, Il, Io, Rs, Rsh, Adj };
+		double f[6];
+		eqns( x, f );
+		double r = 0;
+		for (int i = 0; i < 6; i++)
+			r = std::max( r, std::abs( f[i] ) );
+		return r;
+	}
+
 	double max_slope( double Vstart, double Vend )
 	{
 		if (Vend <= Vstart) Vend *= 1.01;
@@ -539,4 +567,74 @@ public:
 
 };
 
+/**
+* Solves a table of modules on a pool of threads. Modules are ordered by technology, cells in series, Voc and Isc,
+* then split into fixed-size blocks so that the results do not depend on the number of threads. Within a block, each
+* module is first solved from the parameters of the previous successfully solved module when it has the same
+* technology and number of cells, and falls back to solve_with_sanity_and_heuristics otherwise.
+* A warm-started module gets the same parameters as a cold solve of its own, except where the cold solve only
+* converges with a perturbed Isc, in which case the warm start fits the datasheet values exactly.
+*/
+class module6par_batch
+{
+public:
+	std::vector<module6par> modules;
+	std::vector<int> err;				///< sanity check code for each module, 0 on success
+	std::vector<int> warm_started;		///< 1 if the module was solved from a neighboring module's parameters
+	std::vector<double> residual;		///< largest absolute residual of the six equations at the solution
+
+	static const size_t block_size = 32;
+
+	void solve( int max_iter, double tol, int nthreads = 0, bool warm_start = true )
+	{
+		size_t n = modules.size();
+		err.assign( n, 0 );
+		warm_started.assign( n, 0 );
+		residual.assign( n, 0.0 );
+		if (n == 0) return;
+
+		m_order.resize( n );
+		for (size_t i = 0; i < n; i++)
+			m_order[i] = i;
+		std::sort( m_order.begin(), m_order.end(), [this]( size_t i, size_t j ) {
+			const module6par &mi = modules[i], &mj = modules[j];
+			if (mi.Type != mj.Type) return mi.Type < mj.Type;
+			if (mi.Nser != mj.Nser) return mi.Nser < mj.Nser;
+			if (mi.Voc != mj.Voc) return mi.Voc < mj.Voc;
+			return mi.Isc < mj.Isc;
+		} );
+
+		size_t nblocks = (n + block_size - 1) / block_size;
+		util::parallel_for( nblocks, nthreads, [&]( size_t b, int ) {
+			solve_block( b * block_size, std::min( n, (b + 1) * block_size ), max_iter, tol, warm_start );
+		} );
+	}
+
+private:
+	std::vector<size_t> m_order;
+
+	void solve_block( size_t begin, size_t end, int max_iter, double tol, bool warm_start )
+	{
+		const module6par *prev = 0;
+		for (size_t k = begin; k < end; k++)
+		{
+			size_t idx = m_order[k];
+			module6par &m = modules[idx];
+			int e = -1;
+			if (warm_start && prev != 0 && prev->Type == m.Type && prev->Nser == m.Nser)
+			{
+				m.guess_from( *prev );
+				e = m.solve<double>( max_iter, tol );
+				if (e >= 0) warm_started[idx] = 1;
+			}
+			if (e < 0)
+				e = m.solve_with_sanity_and_heuristics<double>( max_iter, tol );
+
+			err[idx] = e;
+			residual[idx] = m.max_residual();
+			if (e >= 0) prev = &m;
+		}
+	}
+};
+
 #endif
@@ -749,6 +749,16 @@ double battery_t::SOC() { return capacity->SOC(); }
 
 double battery_t::I() { return capacity->I(); }
 
+double battery_t::P() { return state->P; }
+
+double battery_t::P_chargeable() { return state->P_chargeable; }
+
+double battery_t::P_dischargeable() { return state->P_dischargeable; }
+
+double battery_t::T_battery() { return thermal->T_battery(); }
+
+size_t battery_t::last_idx() { return state->last_idx; }
+
 double battery_t::calculate_loss(double power, size_t lifetimeIndex) {
     size_t indexYearOne = util::yearOneIndex(params->dt_hr, lifetimeIndex);
     auto hourOfYear = (size_t)std::floor(indexYearOne * params->dt_hr);
@@ -777,12 +787,18 @@ double battery_t::getLoss() {
 
 battery_state battery_t::get_state() { return *state; }
 
+void battery_t::get_state(battery_state& state_copy) { state_copy = *state; }
+
 battery_params battery_t::get_params() { return *params; }
 
 void battery_t::set_state(const battery_state& tmp_state) {
     *state = tmp_state;
 }
 
+void battery_t::set_state(const battery_t& battery) {
+    *state = *battery.state;
+}
+
 void battery_t::update_state(double I) {
     state->I = I;
     state->Q = capacity->q0();
@@ -405,6 +405,16 @@ public:
 
     double I();
 
+    double P(); // the power dispatched in the last time step [kW]
+
+    double P_chargeable(); // the estimated max charge power for the next time step [kW]
+
+    double P_dischargeable(); // the estimated max discharge power for the next time step [kW]
+
+    double T_battery(); // the battery temperature averaged over the last time step [C]
+
+    size_t last_idx(); // the lifetime index of the last time step
+
     // Get estimated losses
     double calculate_loss(double power, size_t lifetimeIndex);
 
@@ -413,10 +423,16 @@ public:
 
     battery_state get_state();
 
+    // Copy the state into an existing state, reusing its storage instead of allocating new substates
+    void get_state(battery_state& state_copy);
+
     battery_params get_params();
 
     void set_state(const battery_state& state);
 
+    // Copy the state of another battery with the same parameters, without an intermediate battery_state
+    void set_state(const battery_t& battery);
+
 private:
     std::unique_ptr<capacity_t> capacity;
     std::unique_ptr<thermal_t> thermal;
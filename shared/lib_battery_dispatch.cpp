@@ -115,8 +115,8 @@ dispatch_t::dispatch_t(const dispatch_t& dispatch)
 // shallow copy from dispatch to this
 void dispatch_t::copy(const dispatch_t* dispatch)
 {
-    _Battery->set_state(dispatch->_Battery->get_state());
-    _Battery_initial->set_state(dispatch->_Battery_initial->get_state());
+    _Battery->set_state(*dispatch->_Battery);
+    _Battery_initial->set_state(*dispatch->_Battery_initial);
     init(_Battery, dispatch->_dt_hour, dispatch->_current_choice, dispatch->_t_min, dispatch->_mode);
 
     // can't create shallow copy of unique ptr
@@ -146,7 +146,7 @@ dispatch_t::~dispatch_t()
 }
 void dispatch_t::finalize(size_t idx, double& I)
 {
-	_Battery->set_state(_Battery_initial->get_state());
+	_Battery->set_state(*_Battery_initial);
 	m_batteryPower->powerBatteryDC = 0;
 	m_batteryPower->powerBatteryAC = 0;
 	m_batteryPower->powerGridToBattery = 0;
@@ -270,7 +270,7 @@ bool dispatch_t::check_constraints(double& I, size_t count)
     // reset
     if (iterate)
     {
-        _Battery->set_state(_Battery_initial->get_state());
+        _Battery->set_state(*_Battery_initial);
         m_batteryPowerFlow->calculate();
     }
 
@@ -427,7 +427,7 @@ void dispatch_t::runDispatch(size_t lifetimeIndex)
     double I = current_controller(m_batteryPower->powerBatteryDC);
 
     // Setup battery iteration
-    _Battery_initial->set_state(_Battery->get_state());
+    _Battery_initial->set_state(*_Battery);
 
     bool iterate = true;
     size_t count = 0;
@@ -448,7 +448,7 @@ void dispatch_t::runDispatch(size_t lifetimeIndex)
             m_batteryPower->powerBatteryDC = I * _Battery->V() * util::watt_to_kilowatt;
         }
         else {
-            _Battery->set_state(_Battery_initial->get_state());
+            _Battery->set_state(*_Battery_initial);
         }
         count++;
 
@@ -488,7 +488,7 @@ void dispatch_t::dispatch_dc_outage_step(size_t lifetimeIndex) {
     double batt_losses = _Battery->calculate_loss(max_charge_kwdc, lifetimeIndex);
 
     // Setup battery iteration
-    auto Battery_initial = _Battery->get_state();
+    _Battery->get_state(m_outage_state);
 
     if ((pv_kwac - batt_losses) * (1 - ac_loss_percent) > crit_load_kwac) {
         double remaining_kwdc = -(pv_kwac * (1 - ac_loss_percent) - crit_load_kwac) / dc_ac_eff + pv_clipped;
@@ -499,7 +499,7 @@ void dispatch_t::dispatch_dc_outage_step(size_t lifetimeIndex) {
         double dc_input = pv_kwdc + remaining_kwdc;
         double est_crit_load_unmet = m_batteryPower->powerCritLoadUnmet;
         while (m_batteryPower->powerCritLoadUnmet > tolerance) {
-            _Battery->set_state(Battery_initial);
+            _Battery->set_state(m_outage_state);
             dc_input = pv_kwdc + remaining_kwdc + (m_batteryPower->powerCritLoadUnmet) / dc_ac_eff;
             // remaining_kw_dc is a negative number, so add it to pv_kwdc to reduce inverter dc power
             m_batteryPower->sharedInverter->calculateACPower(dc_input, V_pv, m_batteryPower->sharedInverter->Tdry_C);
@@ -532,7 +532,7 @@ void dispatch_t::dispatch_dc_outage_step(size_t lifetimeIndex) {
                     if (m_batteryPower->powerCritLoadUnmet < tolerance)
                         break;
                     discharge_kwdc *= 1.01;
-                    _Battery->set_state(Battery_initial);
+                    _Battery->set_state(m_outage_state);
                     m_batteryPower->powerBatteryTarget = discharge_kwdc;
                     m_batteryPower->powerBatteryDC = discharge_kwdc;
                     runDispatch(lifetimeIndex);
@@ -576,7 +576,7 @@ void dispatch_t::dispatch_ac_outage_step(size_t lifetimeIndex) {
             double discharge_kwdc = required_kwdc;
 
             // iterate in case the dispatched power is slightly less (by tolerance) than required
-            auto Battery_initial = _Battery->get_state();
+            _Battery->get_state(m_outage_state);
             m_batteryPower->powerBatteryTarget = discharge_kwdc;
             m_batteryPower->powerBatteryDC = discharge_kwdc;
             runDispatch(lifetimeIndex);
@@ -585,7 +585,7 @@ void dispatch_t::dispatch_ac_outage_step(size_t lifetimeIndex) {
                     if (m_batteryPower->powerCritLoadUnmet < tolerance)
                         break;
                     discharge_kwdc *= 1.01;
-                    _Battery->set_state(Battery_initial);
+                    _Battery->set_state(m_outage_state);
                     m_batteryPower->powerBatteryTarget = discharge_kwdc;
                     m_batteryPower->powerBatteryDC = discharge_kwdc;
                     runDispatch(lifetimeIndex);
@@ -627,6 +627,7 @@ double dispatch_t::battery_power_to_fill() { return _Battery->power_to_fill(m_ba
 double dispatch_t::battery_soc() { return _Battery->SOC(); }
 BatteryPowerFlow * dispatch_t::getBatteryPowerFlow() { return m_batteryPowerFlow.get(); }
 BatteryPower * dispatch_t::getBatteryPower() { return m_batteryPower; }
+const BatteryPower * dispatch_t::getBatteryPower() const { return m_batteryPower; }
 
 dispatch_automatic_t::dispatch_automatic_t(
 	battery_t * Battery,
@@ -901,7 +902,7 @@ bool dispatch_automatic_t::check_constraints(double& I, size_t count)
         // reset
         if (iterate)
         {
-            _Battery->set_state(_Battery_initial->get_state());
+            _Battery->set_state(*_Battery_initial);
             //			m_batteryPower->powerBatteryAC = 0;
             //			m_batteryPower->powerGridToBattery = 0;
             //			m_batteryPower->powerBatteryToGrid = 0;
@@ -56,7 +56,7 @@ class dispatch_t
 {
 public:
 
-	enum FOM_MODES { FOM_AUTOMATED_ECONOMIC, FOM_PV_SMOOTHING, FOM_CUSTOM_DISPATCH, FOM_MANUAL };
+	enum FOM_MODES { FOM_AUTOMATED_ECONOMIC, FOM_PV_SMOOTHING, FOM_CUSTOM_DISPATCH, FOM_MANUAL, FOM_OPTIMIZED };
 	enum BTM_MODES { PEAK_SHAVING, MAINTAIN_TARGET, CUSTOM_DISPATCH, MANUAL, FORECAST, SELF_CONSUMPTION };
 	enum METERING { BEHIND, FRONT };
     enum WEATHER_FORECAST_CHOICE { WF_LOOK_AHEAD, WF_LOOK_BEHIND, WF_CUSTOM };
@@ -146,6 +146,7 @@ public:
 
 	/// Return a pointer to the underlying calculated power quantities
 	BatteryPower * getBatteryPower();
+	const BatteryPower * getBatteryPower() const;
 
 	/// Return a pointer to the object which calculates the battery power flow
 	BatteryPowerFlow * getBatteryPowerFlow();
@@ -178,12 +179,15 @@ protected:
 	battery_t * _Battery;
 	battery_t * _Battery_initial;
 
+	// battery state at the start of an outage step, kept to reuse its storage across steps
+	battery_state m_outage_state;
+
 	double _dt_hour;
 
 	/**
 	The dispatch mode.
 	For behind-the-meter dispatch: 0 = PEAK_SHAVING, 1 = MAINTAIN_TARGET, 2 = CUSTOM, 3 = MANUAL, 4 = FORECAST, 5 = SELF_CONSUMPTION
-	For front-of-meter dispatch: 0 = FOM_AUTOMATED_ECONOMIC, 1 = FOM_PV_SMOOTHING, 2 = FOM_CUSTOM_DISPATCH, 3 = FOM_MANUAL
+	For front-of-meter dispatch: 0 = FOM_AUTOMATED_ECONOMIC, 1 = FOM_PV_SMOOTHING, 2 = FOM_CUSTOM_DISPATCH, 3 = FOM_MANUAL, 4 = FOM_OPTIMIZED
 	*/
 	int _mode;
 
@@ -348,7 +352,7 @@ public:
 	virtual void update_pv_data(std::vector<double> P_pv_ac);
 
     /// Update cliploss data [kW]
-    void update_cliploss_data(double_vec P_cliploss);
+    virtual void update_cliploss_data(double_vec P_cliploss);
 
 	/*! Pass in the user-defined dispatch power vector */
 	virtual void set_custom_dispatch(std::vector<double> P_batt_dc);
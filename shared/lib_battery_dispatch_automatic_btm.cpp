@@ -573,75 +573,105 @@ void dispatch_automatic_behind_the_meter_t::apply_target_power(size_t day_index)
 void dispatch_automatic_behind_the_meter_t::cost_based_target_power(size_t idx, size_t year, size_t hour_of_year, double no_dispatch_cost, double E_max, FILE* p, const bool debug)
 {
     double startingEnergy = compute_available_energy(p, debug);
-    std::vector<dispatch_plan> plans(_num_steps / _steps_per_hour / 2);
-    
-    plans[0].dispatch_hours = 0;
-    plans[0].plannedDispatch.resize(_num_steps);
-    plans[0].cost = no_dispatch_cost;
+    size_t num_plans = _num_steps / _steps_per_hour / 2;
 
-    double lowest_cost = no_dispatch_cost;
-    size_t lowest_index = 0;
+    // Keep the best plan so far and the one being evaluated, swapping buffers when the candidate wins
+    dispatch_plan best_plan;
+    best_plan.dispatch_hours = 0;
+    best_plan.plannedDispatch.resize(_num_steps);
+    best_plan.cost = no_dispatch_cost;
 
-    for (size_t i = 1; i < plans.size(); i++)
+    dispatch_plan plan;
+    plan.plannedGridUse.reserve(_num_steps);
+
+    // A single copy of the forecast is reset between plans instead of copying the rate data for every plan
+    UtilityRateForecast midDispatchForecast(*rate_forecast);
+    bool orders_fixed = false;
+
+    for (size_t i = 1; i < num_plans; i++)
     {
-        plans[i].dispatch_hours = i;
-        plans[i].plannedDispatch.resize(_num_steps);
-        plans[i].plannedGridUse.clear();
-        plans[i].plannedDispatch = std::vector<double>(plans[i].plannedDispatch.size());
-        plans[i].num_cycles = 0;
-        plan_dispatch_for_cost(plans[i], idx, E_max, startingEnergy);
-        UtilityRateForecast midDispatchForecast(*rate_forecast);
-        plans[i].cost = midDispatchForecast.forecastCost(plans[i].plannedGridUse, year, hour_of_year, 0) + cost_to_cycle() * plans[i].num_cycles + plans[i].kWhDischarged * omCost() - plans[i].kWhRemaining * plans[i].lowestMarginalCost;
-
-        if (plans[i].cost <= lowest_cost)
+        if (!orders_fixed)
+        {
+            orders_fixed = sort_grid_for_plans();
+        }
+
+        plan.dispatch_hours = i;
+        plan.plannedDispatch.assign(_num_steps, 0.0);
+        plan.plannedGridUse.clear();
+        plan.num_cycles = 0;
+        plan_dispatch_for_cost(plan, idx, E_max, startingEnergy);
+        if (i > 1)
+        {
+            midDispatchForecast.restoreState(*rate_forecast);
+        }
+        plan.cost = midDispatchForecast.forecastCost(plan.plannedGridUse, year, hour_of_year, 0) + cost_to_cycle() * plan.num_cycles + plan.kWhDischarged * omCost() - plan.kWhRemaining * plan.lowestMarginalCost;
+
+        if (plan.cost <= best_plan.cost)
         {
-            lowest_index = i;
-            lowest_cost = plans[i].cost;
+            std::swap(best_plan, plan);
         }
     }
 
     // Copy from best dispatch plan to _P_battery_use.
-    _P_battery_use.assign(plans[lowest_index].plannedDispatch.begin(), plans[lowest_index].plannedDispatch.end());
+    _P_battery_use.assign(best_plan.plannedDispatch.begin(), best_plan.plannedDispatch.end());
 
 }
 
+bool dispatch_automatic_behind_the_meter_t::sort_grid_for_plans()
+{
+    // Each plan starts sorting from the order the previous plan left sorted_grid in, and ties keep that order.
+    // Once a pass ends where it started every later plan would repeat the same sorts, so the caller can stop calling this
+    plan_grid_by_cost.assign(sorted_grid.begin(), sorted_grid.end());
+    std::stable_sort(plan_grid_by_cost.begin(), plan_grid_by_cost.end(), byCost());
+    plan_grid_by_grid.assign(plan_grid_by_cost.begin(), plan_grid_by_cost.end());
+    std::stable_sort(plan_grid_by_grid.begin(), plan_grid_by_grid.end(), byGrid());
+    plan_grid_by_marginal_cost.assign(plan_grid_by_grid.begin(), plan_grid_by_grid.end());
+    std::stable_sort(plan_grid_by_marginal_cost.begin(), plan_grid_by_marginal_cost.end(), byLowestMarginalCost());
+
+    bool unchanged = true;
+    for (size_t i = 0; i < sorted_grid.size() && unchanged; i++)
+    {
+        unchanged = sorted_grid[i].Hour() == plan_grid_by_marginal_cost[i].Hour() && sorted_grid[i].Step() == plan_grid_by_marginal_cost[i].Step();
+    }
+    sorted_grid.assign(plan_grid_by_marginal_cost.begin(), plan_grid_by_marginal_cost.end());
+
+    // Sum no-dispatch cost of the top n grid points for every n. In case forecast is testing hours that include negative cost, don't dispatch during those
+    plan_cost_sums.assign(plan_grid_by_cost.size() + 1, 0.0);
+    for (size_t i = 0; i < plan_grid_by_cost.size(); i++)
+    {
+        double costAtStep = plan_grid_by_cost[i].Cost();
+        plan_cost_sums[i + 1] = costAtStep > 1e-7 ? plan_cost_sums[i] + costAtStep : plan_cost_sums[i];
+    }
+    return unchanged;
+}
+
 void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan& plan, size_t idx, double E_max, double startingEnergy)
 {
     size_t i = 0, index = 0;
 
-    std::stable_sort(sorted_grid.begin(), sorted_grid.end(), byCost());
-    // Iterating over sorted grid
-    double costDuringDispatchHours = 0.0;
+    // Iterating over grid sorted by cost, see sort_grid_for_plans
+    size_t dispatch_steps = std::min(plan.dispatch_hours * _steps_per_hour, plan_grid_by_cost.size());
+    double costDuringDispatchHours = plan_cost_sums[dispatch_steps];
     double costAtStep = 0.0;
-    // Sum no-dispatch cost of top n grid points (dispatch hours * steps per hour). Units: % of cost -> don't need to record this, can re-compute after iteration
-    for (i = 0; (i < plan.dispatch_hours * _steps_per_hour) && (i < sorted_grid.size()); i++)
-    {
-        costAtStep = sorted_grid[i].Cost();
-        // In case forecast is testing hours that include negative cost, don't dispatch during those
-        if (costAtStep > 1e-7)
-        {
-            costDuringDispatchHours += sorted_grid[i].Cost();
-        }
-    }
     double remainingEnergy = E_max;
     double powerAtMaxCost = 0;
-    plan.lowestMarginalCost = sorted_grid[0].MarginalCost();
-    for (i = 0; i < (plan.dispatch_hours * _steps_per_hour) && (i < sorted_grid.size()); i++)
+    plan.lowestMarginalCost = plan_grid_by_cost[0].MarginalCost();
+    for (i = 0; i < dispatch_steps; i++)
     {
-        costAtStep = sorted_grid[i].Cost();
+        costAtStep = plan_grid_by_cost[i].Cost();
         if (costAtStep > 1e-7)
         {
             double costPercent = costAtStep / costDuringDispatchHours;
             double desiredPower = remainingEnergy * costPercent / _dt_hour;
 
             // Prevent the wierd signals from demand charges from reducing dispatch (maybe fix this upstream in the future)
-            if (desiredPower < powerAtMaxCost && sorted_grid[i].Grid() >= powerAtMaxCost) {
+            if (desiredPower < powerAtMaxCost && plan_grid_by_cost[i].Grid() >= powerAtMaxCost) {
                 desiredPower = powerAtMaxCost;
             }
 
-            if (desiredPower > sorted_grid[i].Grid())
+            if (desiredPower > plan_grid_by_cost[i].Grid())
             {
-                desiredPower = sorted_grid[i].Grid();
+                desiredPower = plan_grid_by_cost[i].Grid();
             }
             
             // Account for discharging constraints assuming voltage is constant over forecast period
@@ -652,7 +682,7 @@ void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan
             costDuringDispatchHours -= costAtStep;
 
             // Add to dispatch plan
-            index = sorted_grid[i].Hour() * _steps_per_hour + sorted_grid[i].Step(); // Assumes we're always running this function on the hour
+            index = plan_grid_by_cost[i].Hour() * _steps_per_hour + plan_grid_by_cost[i].Step(); // Assumes we're always running this function on the hour
             plan.plannedDispatch[index] = desiredPower;
 
             if (powerAtMaxCost == 0) {
@@ -685,15 +715,14 @@ void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan
         }
     }
     // Get max grid use during charging. Choose highest percentile < 25% where we aren't planning on discharging
-    std::stable_sort(sorted_grid.begin(), sorted_grid.end(), byGrid());
     bool lookingForGridUse = true;
     double peakDesiredGridUse = 0.0;
     i = _num_steps / 4;
     while (lookingForGridUse && i < _num_steps)
     {
-        index = sorted_grid[i].Hour() * _steps_per_hour + sorted_grid[i].Step();
+        index = plan_grid_by_grid[i].Hour() * _steps_per_hour + plan_grid_by_grid[i].Step();
 
-        if (sorted_grid[i].Grid() <= 0)
+        if (plan_grid_by_grid[i].Grid() <= 0)
         {
             lookingForGridUse = false;
         }
@@ -702,18 +731,17 @@ void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan
             i++;
         }
         else {
-            peakDesiredGridUse = sorted_grid[i].Grid() > 0 ? sorted_grid[i].Grid() : 0.0;
+            peakDesiredGridUse = plan_grid_by_grid[i].Grid() > 0 ? plan_grid_by_grid[i].Grid() : 0.0;
             lookingForGridUse = false;
         }
     }
 
     // Iterating over sorted grid
-    std::stable_sort(sorted_grid.begin(), sorted_grid.end(), byLowestMarginalCost());
     // Find m hours to get required energy - hope we got today's energy yesterday (for morning peaks). Apportion between hrs of lowest marginal cost
     i = 0;
     while (requiredEnergy > 0 && i < _num_steps)
     {
-        index = sorted_grid[i].Hour() * _steps_per_hour + sorted_grid[i].Step();
+        index = plan_grid_by_marginal_cost[i].Hour() * _steps_per_hour + plan_grid_by_marginal_cost[i].Step();
         // Don't plan to charge if we were already planning to discharge. 0 is no plan, negative is clipped energy
         if (plan.plannedDispatch[index] <= 0.0)
         {
@@ -735,8 +763,8 @@ void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan
                 // Powerflow considerations are different between AC and DC connected batteries for system charging
                 if (m_batteryPower->connectionMode == m_batteryPower->AC_CONNECTED) {
                     // AC connected assumes PV goes to load first. Need net generation in this case
-                    if (sorted_grid[i].Grid() < 0) {
-                        requiredPower = sorted_grid[i].Grid();
+                    if (plan_grid_by_marginal_cost[i].Grid() < 0) {
+                        requiredPower = plan_grid_by_marginal_cost[i].Grid();
                     }
                 }
                 else {
@@ -752,10 +780,10 @@ void dispatch_automatic_behind_the_meter_t::plan_dispatch_for_cost(dispatch_plan
             {
                 check_power_restrictions(requiredPower);
                 // Restrict to up to 25th percentile grid use to avoid creating new peaks
-                double projectedGrid = sorted_grid[i].Grid() - requiredPower;
+                double projectedGrid = plan_grid_by_marginal_cost[i].Grid() - requiredPower;
                 if (projectedGrid > peakDesiredGridUse)
                 {
-                    requiredPower = -(peakDesiredGridUse - sorted_grid[i].Grid());
+                    requiredPower = -(peakDesiredGridUse - plan_grid_by_marginal_cost[i].Grid());
                     requiredPower = requiredPower < 0.0 ? requiredPower : 0.0;
                 }
 
@@ -157,6 +157,7 @@ protected:
     /*! Functions used by price signal dispatch */
     double compute_costs(size_t idx, size_t year, size_t hour_of_year, FILE* p = NULL, bool debug = false); // Initial computation of no-dispatch costs, assigned hourly to grid points
     void cost_based_target_power(size_t idx, size_t year, size_t hour_of_year, double no_dispatch_cost, double E_max, FILE* p = NULL, const bool debug = false); // Optimizing loop, runs twelve possible dispatch scenarios
+    bool sort_grid_for_plans(); // Sorts sorted_grid into the orders used by plan_dispatch_for_cost, returns true once further plans would see the same orders
     void plan_dispatch_for_cost(dispatch_plan& plan, size_t idx, double E_max, double startingEnergy); // Generates each dispatch plan (input argument)
     double compute_available_energy(FILE* p = NULL, const bool debug = false); // Determine how much energy is available at the start of a dispatch plan
     void check_power_restrictions(double& power); // Call some constraints functions to ensure dispatch doesn't exceed power/current limits
@@ -188,6 +189,12 @@ protected:
 	/* Vector of length (24 hours * steps_per_hour) containing sorted grid calculation [P_grid, hour, step] */
 	grid_vec sorted_grid;
 
+	/* Copies of sorted_grid ordered by cost, grid power and marginal cost for the price signal dispatch plans, with running sums of the positive costs in cost order */
+	grid_vec plan_grid_by_cost;
+	grid_vec plan_grid_by_grid;
+	grid_vec plan_grid_by_marginal_cost;
+	std::vector<double> plan_cost_sums;
+
     /* Utility rate data structure for cost aware dispatch algorithms */
     std::shared_ptr<rate_data> rate;
 
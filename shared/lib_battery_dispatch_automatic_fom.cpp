@@ -35,8 +35,29 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "lib_battery_powerflow.h"
 #include "lib_utility_rate.h"
 
+#include <deque>
 #include <numeric>
 
+/// Extreme value of x over each window [i, i + window), using a monotonic deque of candidate indices
+template <typename Compare>
+static void sliding_window_extreme(const std::vector<double>& x, size_t window, std::vector<double>& extremes, Compare better)
+{
+    extremes.clear();
+    if (window == 0 || x.size() < window)
+        return;
+    extremes.reserve(x.size() - window + 1);
+    std::deque<size_t> candidates;
+    for (size_t i = 0; i < x.size(); i++) {
+        while (!candidates.empty() && !better(x[candidates.back()], x[i]))
+            candidates.pop_back();
+        candidates.push_back(i);
+        if (candidates.front() + window <= i)
+            candidates.pop_front();
+        if (i + 1 >= window)
+            extremes.push_back(x[candidates.front()]);
+    }
+}
+
 dispatch_automatic_front_of_meter_t::dispatch_automatic_front_of_meter_t(
 	battery_t * Battery,
 	double dt_hour,
@@ -92,12 +113,19 @@ dispatch_automatic_front_of_meter_t::dispatch_automatic_front_of_meter_t(
 	m_etaDischarge = etaDischarge * 0.01;
 
 	revenueToClipCharge = revenueToDischarge = revenueToGridCharge = revenueToPVCharge = 0;
+	forecast_pv_on_threshold = 0;
 
     discharge_hours = (size_t) std::ceil(_Battery->energy_max(m_batteryPower->stateOfChargeMax, m_batteryPower->stateOfChargeMin) / m_batteryPower->powerBatteryDischargeMaxDC) - 1;
 
     costToCycle();
     omCost();
 	setup_cost_forecast_vector();
+
+    lp_horizon_start = SIZE_MAX;
+    if (_mode == dispatch_t::FOM_OPTIMIZED) {
+        m_dispatch_lp = fom_dispatch_lp_t(_forecast_hours * _steps_per_hour, _dt_hour,
+            m_batteryPower->powerBatteryChargeMaxDC, m_etaPVCharge, m_etaGridCharge, m_etaDischarge);
+    }
 }
 dispatch_automatic_front_of_meter_t::~dispatch_automatic_front_of_meter_t(){ /* NOTHING TO DO */}
 void dispatch_automatic_front_of_meter_t::init_with_pointer(const dispatch_automatic_front_of_meter_t* tmp)
@@ -105,7 +133,22 @@ void dispatch_automatic_front_of_meter_t::init_with_pointer(const dispatch_autom
 	_forecast_hours = tmp->_forecast_hours;
 	_inverter_paco = tmp->_inverter_paco;
 	_forecast_price_rt_series = tmp->_forecast_price_rt_series;
-    ppa_prices = tmp->ppa_prices;
+    forecast_price_max = tmp->forecast_price_max;
+    forecast_price_min = tmp->forecast_price_min;
+    forecast_price_charge = tmp->forecast_price_charge;
+    forecast_price_discharge = tmp->forecast_price_discharge;
+    forecast_rate_min = tmp->forecast_rate_min;
+    forecast_pv_on_steps = tmp->forecast_pv_on_steps;
+    forecast_pv_on_price_min = tmp->forecast_pv_on_price_min;
+    forecast_pv_on_threshold = tmp->forecast_pv_on_threshold;
+    cliploss_cumulative = tmp->cliploss_cumulative;
+
+    m_dispatch_lp = tmp->m_dispatch_lp;
+    lp_horizon_start = tmp->lp_horizon_start;
+
+    // the forecast statistics above are only consistent with the forecasts they were computed from
+    _P_pv_ac = tmp->_P_pv_ac;
+    _P_cliploss_dc = tmp->_P_cliploss_dc;
 
     discharge_hours = tmp->discharge_hours;
 	m_etaPVCharge = tmp->m_etaPVCharge;
@@ -133,11 +176,80 @@ void dispatch_automatic_front_of_meter_t::setup_cost_forecast_vector()
 	}
 	_forecast_price_rt_series = ppa_price_series;
 
-    ppa_prices.reserve(_forecast_hours * _steps_per_hour);
     if (discharge_hours >= _forecast_hours * _steps_per_hour) {
         // -1 for 0 indexed arrays, additional -1 to ensure there is always a charging price lower than the discharing price if the forecast hours is = to battery capacity in hourrs
         discharge_hours = _forecast_hours * _steps_per_hour - 2; 
     }
+
+    setup_price_forecast_statistics();
+}
+
+void dispatch_automatic_front_of_meter_t::setup_price_forecast_statistics()
+{
+    size_t idx_lookahead = _forecast_hours * _steps_per_hour;
+    sliding_window_extreme(_forecast_price_rt_series, idx_lookahead, forecast_price_max, std::greater<double>());
+    sliding_window_extreme(_forecast_price_rt_series, idx_lookahead, forecast_price_min, std::less<double>());
+
+    // slide a sorted copy of the window to read the charge and discharge prices off its order statistics
+    forecast_price_charge.clear();
+    forecast_price_discharge.clear();
+    if (idx_lookahead > 0 && _forecast_price_rt_series.size() >= idx_lookahead) {
+        size_t n_windows = _forecast_price_rt_series.size() - idx_lookahead + 1;
+        forecast_price_charge.reserve(n_windows);
+        forecast_price_discharge.reserve(n_windows);
+        std::vector<double> window(_forecast_price_rt_series.begin(), _forecast_price_rt_series.begin() + idx_lookahead);
+        std::sort(window.begin(), window.end());
+        for (size_t i = 0; i < n_windows; i++) {
+            forecast_price_charge.push_back(window[discharge_hours]);
+            forecast_price_discharge.push_back(window[window.size() - discharge_hours - 1]);
+            if (i + 1 == n_windows)
+                break;
+            window.erase(std::lower_bound(window.begin(), window.end(), _forecast_price_rt_series[i]));
+            double next = _forecast_price_rt_series[i + idx_lookahead];
+            window.insert(std::upper_bound(window.begin(), window.end(), next), next);
+        }
+    }
+
+    // energy rates only depend on the hour of year, so the forecast wraps around the year
+    forecast_rate_min.clear();
+    if (m_utilityRateCalculator) {
+        std::vector<double> rates;
+        rates.reserve(8760 + _forecast_hours);
+        for (size_t i = 0; i < 8760 + _forecast_hours - 1; i++)
+            rates.push_back(m_utilityRateCalculator->getEnergyRate(i % 8760));
+        sliding_window_extreme(rates, _forecast_hours, forecast_rate_min, std::less<double>());
+    }
+}
+
+void dispatch_automatic_front_of_meter_t::setup_pv_forecast_statistics()
+{
+    // steps where PV output could charge the battery at full power, and the lowest price among them
+    size_t idx_lookahead = _forecast_hours * _steps_per_hour;
+    size_t n = std::min(_P_pv_ac.size(), _forecast_price_rt_series.size());
+    forecast_pv_on_threshold = m_batteryPower->powerBatteryChargeMaxDC;
+    forecast_pv_on_steps.assign(n, 0);
+    forecast_pv_on_price_min.assign(n, 0);
+
+    std::deque<size_t> candidates;
+    size_t n_on = 0;
+    size_t end = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (; end < std::min(i + idx_lookahead, n); end++) {
+            if (_P_pv_ac[end] >= forecast_pv_on_threshold) {
+                while (!candidates.empty() && _forecast_price_rt_series[candidates.back()] >= _forecast_price_rt_series[end])
+                    candidates.pop_back();
+                candidates.push_back(end);
+                n_on++;
+            }
+        }
+        if (!candidates.empty() && candidates.front() < i)
+            candidates.pop_front();
+        if (i > 0 && _P_pv_ac[i - 1] >= forecast_pv_on_threshold)
+            n_on--;
+        forecast_pv_on_steps[i] = n_on;
+        if (!candidates.empty())
+            forecast_pv_on_price_min[i] = _forecast_price_rt_series[candidates.front()];
+    }
 }
 
 // deep copy from dispatch to this
@@ -176,7 +288,19 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t year, size_t ho
 	m_batteryPower->powerBatteryTarget = 0;
 
 
-	if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
+	if (_mode == dispatch_t::FOM_OPTIMIZED)
+	{
+		m_batteryPower->powerBatteryTarget = update_dispatch_optimized(hour_of_year, lifetimeIndex);
+		double loss_kw = _Battery->calculate_loss(m_batteryPower->powerBatteryTarget, lifetimeIndex); // Battery is responsible for covering discharge losses
+		if (m_batteryPower->connectionMode == AC_CONNECTED) {
+			m_batteryPower->powerBatteryTarget = m_batteryPower->adjustForACEfficiencies(m_batteryPower->powerBatteryTarget, loss_kw);
+		}
+		else if (m_batteryPower->powerBatteryTarget > 0) {
+			// Adjust for DC discharge losses
+			m_batteryPower->powerBatteryTarget += loss_kw;
+		}
+	}
+	else if (_mode != dispatch_t::FOM_CUSTOM_DISPATCH)
 	{
 
 		// Power to charge (<0) or discharge (>0)
@@ -190,56 +314,36 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t year, size_t ho
         // Compute forecast variables
         size_t idx_lookahead = _forecast_hours * _steps_per_hour;
 
-        ppa_prices.clear();
-        std::copy(_forecast_price_rt_series.begin() + lifetimeIndex, _forecast_price_rt_series.begin() + lifetimeIndex + idx_lookahead, std::back_inserter(ppa_prices));
-        std::sort(ppa_prices.begin(), ppa_prices.end());
-        auto max_ppa_cost = std::max_element(_forecast_price_rt_series.begin() + lifetimeIndex, _forecast_price_rt_series.begin() + lifetimeIndex + idx_lookahead);
-        auto min_ppa_cost = std::min_element(_forecast_price_rt_series.begin() + lifetimeIndex, _forecast_price_rt_series.begin() + lifetimeIndex + idx_lookahead);
-        auto charge_ppa_cost = ppa_prices[discharge_hours];
-        auto discharge_ppa_cost = ppa_prices[ppa_prices.size() - discharge_hours - 1]; 
+        double max_ppa_cost = forecast_price_max[lifetimeIndex];
+        double charge_ppa_cost = forecast_price_charge[lifetimeIndex];
+        double discharge_ppa_cost = forecast_price_discharge[lifetimeIndex];
         double ppa_cost = _forecast_price_rt_series[lifetimeIndex];
 
         /*! Cost to purchase electricity from the utility */
         double usage_cost = ppa_cost;
-        std::vector<double> usage_cost_forecast;
+        double usage_cost_forecast_min = forecast_price_min[lifetimeIndex];
         if (m_utilityRateCalculator) {
             usage_cost = m_utilityRateCalculator->getEnergyRate(hour_of_year);
-            for (size_t i = hour_of_year; i < hour_of_year + _forecast_hours; i++)
-            {
-                for (size_t s = 0; s < _steps_per_hour; s++) {
-                    usage_cost_forecast.push_back(m_utilityRateCalculator->getEnergyRate(i % 8760));
-                }
-            }
+            usage_cost_forecast_min = forecast_rate_min[hour_of_year];
         }
 
         // Compute forecast variables which potentially do change from year to year
         double energyToStoreClipped = 0;
-        if (_P_cliploss_dc.size() > lifetimeIndex + _forecast_hours) {
-            energyToStoreClipped = std::accumulate(_P_cliploss_dc.begin() + lifetimeIndex, _P_cliploss_dc.begin() + lifetimeIndex + _forecast_hours * _steps_per_hour, 0.0) * _dt_hour;
+        if (_P_cliploss_dc.size() > lifetimeIndex + _forecast_hours && lifetimeIndex + idx_lookahead < cliploss_cumulative.size()) {
+            energyToStoreClipped = (cliploss_cumulative[lifetimeIndex + idx_lookahead] - cliploss_cumulative[lifetimeIndex]) * _dt_hour;
         }
 
         /*! Economic benefit of charging from the grid in current time step to discharge sometime in next X hours ($/kWh)*/
-        revenueToGridCharge = *max_ppa_cost * m_etaDischarge - usage_cost / m_etaGridCharge - m_cycleCost - m_omCost;
+        revenueToGridCharge = max_ppa_cost * m_etaDischarge - usage_cost / m_etaGridCharge - m_cycleCost - m_omCost;
 
-        /*! Computed revenue to charge from Grid in each of next X hours ($/kWh)*/
+        /*! Computed revenue to charge from Grid in each of next X hours ($/kWh), which is highest at the lowest price */
         double revenueToGridChargeMax = 0;
         if (m_batteryPower->canGridCharge) {
-            std::vector<double> revenueToGridChargeForecast;
-            size_t j = 0;
-            for (size_t i = lifetimeIndex; i < lifetimeIndex + idx_lookahead; i++) {
-                if (m_utilityRateCalculator) {
-                    revenueToGridChargeForecast.push_back(*max_ppa_cost * m_etaDischarge - usage_cost_forecast[j] / m_etaGridCharge - m_cycleCost - m_omCost);
-                }
-                else {
-                    revenueToGridChargeForecast.push_back(*max_ppa_cost * m_etaDischarge - _forecast_price_rt_series[i] / m_etaGridCharge - m_cycleCost - m_omCost);
-                }
-                j++;
-            }
-            revenueToGridChargeMax = *std::max_element(std::begin(revenueToGridChargeForecast), std::end(revenueToGridChargeForecast));
+            revenueToGridChargeMax = max_ppa_cost * m_etaDischarge - usage_cost_forecast_min / m_etaGridCharge - m_cycleCost - m_omCost;
         }
 
         /*! Economic benefit of charging from regular PV in current time step to discharge sometime in next X hours ($/kWh)*/
-        revenueToPVCharge = _P_pv_ac[lifetimeIndex] > 0 ? *max_ppa_cost * m_etaDischarge - ppa_cost / m_etaPVCharge - m_cycleCost -m_omCost : 0;
+        revenueToPVCharge = _P_pv_ac[lifetimeIndex] > 0 ? max_ppa_cost * m_etaDischarge - ppa_cost / m_etaPVCharge - m_cycleCost -m_omCost : 0;
 
         /*! Computed revenue to charge from PV in each of next X hours ($/kWh)*/
         size_t t_duration = static_cast<size_t>(ceilf( (float)
@@ -247,20 +351,17 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t year, size_t ho
         size_t pv_hours_on;
         double revenueToPVChargeMax = 0;
         if (m_batteryPower->canSystemCharge) {
-            std::vector<double> revenueToPVChargeForecast;
-            for (size_t i = lifetimeIndex; i < lifetimeIndex + idx_lookahead && i < _P_pv_ac.size(); i++) {
-                // when considering grid charging, require PV output to exceed battery input capacity before accepting as a better option
-                bool system_on = _P_pv_ac[i] >= m_batteryPower->powerBatteryChargeMaxDC ? 1 : 0;
-                if (system_on) {
-                    revenueToPVChargeForecast.push_back(system_on * (*max_ppa_cost * m_etaDischarge - _forecast_price_rt_series[i] / m_etaPVCharge - m_cycleCost - m_omCost));
-                }
-            }
-            pv_hours_on = revenueToPVChargeForecast.size() / _steps_per_hour;
-            revenueToPVChargeMax = pv_hours_on >= t_duration ? *std::max_element(std::begin(revenueToPVChargeForecast), std::end(revenueToPVChargeForecast)): 0;
+            // when considering grid charging, require PV output to exceed battery input capacity before accepting as a better option
+            if (forecast_pv_on_threshold != m_batteryPower->powerBatteryChargeMaxDC)
+                setup_pv_forecast_statistics();
+            size_t pv_steps_on = lifetimeIndex < forecast_pv_on_steps.size() ? forecast_pv_on_steps[lifetimeIndex] : 0;
+            pv_hours_on = pv_steps_on / _steps_per_hour;
+            if (pv_steps_on > 0 && pv_hours_on >= t_duration)
+                revenueToPVChargeMax = max_ppa_cost * m_etaDischarge - forecast_pv_on_price_min[lifetimeIndex] / m_etaPVCharge - m_cycleCost - m_omCost;
         }
 
         /*! Economic benefit of charging from clipped PV in current time step to discharge sometime in the next X hours (clipped PV is free) ($/kWh) */
-        revenueToClipCharge = _P_cliploss_dc[lifetimeIndex] > 0 ? *max_ppa_cost * m_etaDischarge - m_cycleCost - m_omCost : 0;
+        revenueToClipCharge = _P_cliploss_dc[lifetimeIndex] > 0 ? max_ppa_cost * m_etaDischarge - m_cycleCost - m_omCost : 0;
 
         /*! Economic benefit of discharging in current time step ($/kWh) */
         revenueToDischarge = ppa_cost * m_etaDischarge - m_cycleCost - m_omCost;
@@ -359,6 +460,46 @@ void dispatch_automatic_front_of_meter_t::update_dispatch(size_t year, size_t ho
 	m_batteryPower->powerBatteryDC = m_batteryPower->powerBatteryTarget;
 }
 
+double dispatch_automatic_front_of_meter_t::update_dispatch_optimized(size_t hour_of_year, size_t lifetimeIndex)
+{
+    size_t n_steps = m_dispatch_lp.n_steps();
+    size_t steps_per_update = std::min(std::max((size_t)std::round(_dt_hour_update * _steps_per_hour), (size_t)1), n_steps);
+    bool in_horizon = lp_horizon_start != SIZE_MAX && lifetimeIndex >= lp_horizon_start;
+
+    if (!in_horizon || lifetimeIndex - lp_horizon_start >= steps_per_update) {
+        costToCycle();
+        omCost();
+
+        fom_dispatch_lp_t::horizon_t horizon;
+        horizon.price_sell.resize(n_steps);
+        horizon.price_buy.resize(n_steps);
+        horizon.power_pv_max.resize(n_steps);
+        horizon.power_clipped_max.resize(n_steps);
+        horizon.power_discharge_max.resize(n_steps);
+        for (size_t t = 0; t < n_steps; t++) {
+            size_t idx = lifetimeIndex + t;
+            double pv = idx < _P_pv_ac.size() ? _P_pv_ac[idx] : 0;
+            horizon.price_sell[t] = idx < _forecast_price_rt_series.size() ? _forecast_price_rt_series[idx] : 0;
+            horizon.price_buy[t] = m_utilityRateCalculator ? m_utilityRateCalculator->getEnergyRate((hour_of_year + t / _steps_per_hour) % 8760) : horizon.price_sell[t];
+            horizon.power_pv_max[t] = m_batteryPower->canSystemCharge ? pv : 0;
+            horizon.power_clipped_max[t] = m_batteryPower->canClipCharge && idx < _P_cliploss_dc.size() ? _P_cliploss_dc[idx] : 0;
+            horizon.power_discharge_max[t] = m_batteryPower->powerBatteryDischargeMaxDC;
+            // a DC-connected battery shares the inverter with the PV array
+            if (m_batteryPower->connectionMode == DC_CONNECTED)
+                horizon.power_discharge_max[t] = std::fmin(horizon.power_discharge_max[t], std::fmax(_inverter_paco - pv, 0));
+        }
+        horizon.power_grid_charge_max = m_batteryPower->canGridCharge ? m_batteryPower->powerBatteryChargeMaxDC : 0;
+        horizon.energy_initial = _Battery->energy_available(m_batteryPower->stateOfChargeMin);
+        horizon.energy_max = _Battery->energy_max(m_batteryPower->stateOfChargeMax, m_batteryPower->stateOfChargeMin);
+        horizon.cost_discharge = m_cycleCost + m_omCost;
+
+        // if no schedule is found the battery idles until the next update
+        m_dispatch_lp.solve(horizon);
+        lp_horizon_start = lifetimeIndex;
+    }
+    return m_dispatch_lp.power_battery(lifetimeIndex - lp_horizon_start);
+}
+
 void dispatch_automatic_front_of_meter_t::update_pv_data(double_vec P_pv_ac)
 {
 	_P_pv_ac = P_pv_ac;
@@ -366,6 +507,18 @@ void dispatch_automatic_front_of_meter_t::update_pv_data(double_vec P_pv_ac)
 	// append to end to allow for look-ahead
 	for (size_t i = 0; i != _forecast_hours * _steps_per_hour; i++)
 		_P_pv_ac.push_back(P_pv_ac[i]);
+
+	setup_pv_forecast_statistics();
+}
+
+void dispatch_automatic_front_of_meter_t::update_cliploss_data(double_vec P_cliploss)
+{
+    dispatch_automatic_t::update_cliploss_data(P_cliploss);
+
+    cliploss_cumulative.resize(_P_cliploss_dc.size() + 1);
+    cliploss_cumulative[0] = 0;
+    for (size_t i = 0; i < _P_cliploss_dc.size(); i++)
+        cliploss_cumulative[i + 1] = cliploss_cumulative[i] + _P_cliploss_dc[i];
 }
 
 void dispatch_automatic_front_of_meter_t::costToCycle()
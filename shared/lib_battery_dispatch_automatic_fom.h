@@ -34,6 +34,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __LIB_BATTERY_DISPATCH_AUTOMATIC_FOM_H__
 
 #include "lib_battery_dispatch.h"
+#include "lib_battery_dispatch_lp.h"
 
 /*! Automated Front of Meter DC-connected battery dispatch */
 class dispatch_automatic_front_of_meter_t : public dispatch_automatic_t
@@ -46,6 +47,8 @@ public:
 	 2. Charging from the grid during times of low electricity buy-rates (if grid charging allowed)
 	 3. Charging from the PV array during times of low PPA sell rates
 	 4. Charging from the PV array during times where the PV power would be clipped due to inverter limits (if DC-connected)
+	 With dispatch mode FOM_OPTIMIZED, the battery instead follows the revenue-optimal schedule of a linear program over the look ahead hours,
+	 re-solved every dispatch update frequency hours
 	*/
 	dispatch_automatic_front_of_meter_t(
 		battery_t * Battery,
@@ -102,6 +105,9 @@ public:
 	/// Pass in the PV power forecast [kW]
     void update_pv_data(double_vec P_pv_ac);
 
+    /// Pass in the clipping loss forecast [kW]
+    void update_cliploss_data(double_vec P_cliploss) override;
+
 	/// Return benefit calculations
 	double benefit_charge(){ return revenueToPVCharge; }
 	double benefit_gridcharge() { return revenueToGridCharge; }
@@ -114,6 +120,15 @@ protected:
 	void init_with_pointer(const dispatch_automatic_front_of_meter_t* tmp);
 	void setup_cost_forecast_vector();
 
+    /*! Compute the price statistics of the forecast window at every index, sliding the window instead of sorting it each step */
+    void setup_price_forecast_statistics();
+
+    /*! Compute the PV charging opportunities of the forecast window at every index */
+    void setup_pv_forecast_statistics();
+
+    /*! Battery power of the optimized schedule, re-solving the horizon starting at lifetimeIndex when the update frequency has passed [kW] */
+    double update_dispatch_optimized(size_t hour_of_year, size_t lifetimeIndex);
+
     /*! Calculate the cost to cycle per kWh */
     void costToCycle();
 
@@ -125,7 +140,23 @@ protected:
 
 	/*! Market real time and forecast prices */
 	std::vector<double> _forecast_price_rt_series;
-    std::vector<double> ppa_prices; // Smaller vector for copying and sorting
+
+    /*! Highest, lowest, charge and discharge prices over the forecast window starting at each index */
+    std::vector<double> forecast_price_max;
+    std::vector<double> forecast_price_min;
+    std::vector<double> forecast_price_charge; // discharge_hours-th lowest price
+    std::vector<double> forecast_price_discharge; // discharge_hours-th highest price
+
+    /*! Lowest utility energy rate over the forecast hours starting at each hour of year */
+    std::vector<double> forecast_rate_min;
+
+    /*! Steps with PV output above the charge limit over the forecast window starting at each index, and their lowest price */
+    std::vector<size_t> forecast_pv_on_steps;
+    std::vector<double> forecast_pv_on_price_min;
+    double forecast_pv_on_threshold; // charge limit [kW] the PV statistics were computed for
+
+    /*! Cumulative sum of the clipping loss forecast, i-th entry is the sum of the first i steps [kW] */
+    std::vector<double> cliploss_cumulative;
 
     size_t discharge_hours; // Battery size in hours
 
@@ -137,6 +168,10 @@ protected:
 	double m_etaGridCharge;
 	double m_etaDischarge;
 
+	/*! Rolling horizon dispatch optimization and the lifetime index its horizon starts at, for FOM_OPTIMIZED */
+	fom_dispatch_lp_t m_dispatch_lp;
+	size_t lp_horizon_start;
+
 	/* Computed benefits to charge, discharge, gridcharge, clipcharge */
 	double revenueToPVCharge;
 	double revenueToGridCharge;
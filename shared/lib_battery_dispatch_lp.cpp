@@ -0,0 +1,283 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "lib_battery_dispatch_lp.h"
+#include "../lpsolve/lp_lib.h"
+
+fom_dispatch_lp_t::fom_dispatch_lp_t() :
+    m_n_steps(0),
+    m_dt_hour(0),
+    m_power_charge_max(0),
+    m_eta_pv_charge(1),
+    m_eta_grid_charge(1),
+    m_eta_discharge(1),
+    m_lp(nullptr),
+    m_has_solution(false),
+    m_objective(0),
+    m_iterations(0)
+{
+}
+
+fom_dispatch_lp_t::fom_dispatch_lp_t(size_t n_steps, double dt_hour, double power_charge_max,
+    double eta_pv_charge, double eta_grid_charge, double eta_discharge) :
+    m_n_steps(n_steps),
+    m_dt_hour(dt_hour),
+    m_power_charge_max(power_charge_max),
+    m_eta_pv_charge(eta_pv_charge),
+    m_eta_grid_charge(eta_grid_charge),
+    m_eta_discharge(eta_discharge),
+    m_lp(nullptr),
+    m_has_solution(false),
+    m_objective(0),
+    m_iterations(0)
+{
+    construct_model();
+}
+
+fom_dispatch_lp_t::fom_dispatch_lp_t(const fom_dispatch_lp_t& orig) :
+    m_lp(nullptr)
+{
+    copy(orig);
+}
+
+fom_dispatch_lp_t& fom_dispatch_lp_t::operator=(const fom_dispatch_lp_t& rhs)
+{
+    if (this != &rhs)
+        copy(rhs);
+    return *this;
+}
+
+fom_dispatch_lp_t::~fom_dispatch_lp_t()
+{
+    if (m_lp)
+        delete_lp(m_lp);
+}
+
+void fom_dispatch_lp_t::copy(const fom_dispatch_lp_t& orig)
+{
+    if (m_lp)
+        delete_lp(m_lp);
+    m_lp = nullptr;
+
+    m_n_steps = orig.m_n_steps;
+    m_dt_hour = orig.m_dt_hour;
+    m_power_charge_max = orig.m_power_charge_max;
+    m_eta_pv_charge = orig.m_eta_pv_charge;
+    m_eta_grid_charge = orig.m_eta_grid_charge;
+    m_eta_discharge = orig.m_eta_discharge;
+    m_has_solution = orig.m_has_solution;
+    m_solution = orig.m_solution;
+    m_basis = orig.m_basis;
+    m_objective = orig.m_objective;
+    m_iterations = orig.m_iterations;
+
+    if (orig.m_lp)
+        construct_model();
+}
+
+void fom_dispatch_lp_t::construct_model()
+{
+    if (m_n_steps == 0)
+        throw std::runtime_error("Battery dispatch optimization requires a forecast horizon of at least one step.");
+
+    int n_columns = (int)(N_VARIABLES * m_n_steps);
+    m_lp = make_lp(0, n_columns);
+    if (!m_lp)
+        throw std::runtime_error("Failed to create the battery dispatch optimization problem.");
+
+    set_verbose(m_lp, NEUTRAL);
+    set_maxim(m_lp);
+    set_add_rowmode(m_lp, TRUE);
+
+    // energy balance, the right hand side of the first step is the initial energy
+    for (size_t t = 0; t < m_n_steps; t++) {
+        REAL row[6];
+        int col[6];
+        int n = 0;
+        row[n] = 1; col[n++] = column(ENERGY, t);
+        if (t > 0) {
+            row[n] = -1; col[n++] = column(ENERGY, t - 1);
+        }
+        row[n] = -m_dt_hour; col[n++] = column(CHARGE_GRID, t);
+        row[n] = -m_dt_hour; col[n++] = column(CHARGE_PV, t);
+        row[n] = -m_dt_hour; col[n++] = column(CHARGE_CLIPPED, t);
+        row[n] = m_dt_hour; col[n++] = column(DISCHARGE, t);
+        add_constraintex(m_lp, n, row, col, EQ, 0);
+    }
+
+    // total charge power, which is zero while discharging
+    for (size_t t = 0; t < m_n_steps; t++) {
+        REAL row[4] = { 1, 1, 1, m_power_charge_max };
+        int col[4] = { column(CHARGE_GRID, t), column(CHARGE_PV, t), column(CHARGE_CLIPPED, t), column(DISCHARGING, t) };
+        add_constraintex(m_lp, 4, row, col, LE, m_power_charge_max);
+    }
+
+    // discharge power only while discharging, inactive until the step both charges and discharges
+    for (size_t t = 0; t < m_n_steps; t++) {
+        REAL row[2] = { 1, 0 };
+        int col[2] = { column(DISCHARGE, t), column(DISCHARGING, t) };
+        add_constraintex(m_lp, 2, row, col, LE, get_infinite(m_lp));
+    }
+
+    set_add_rowmode(m_lp, FALSE);
+}
+
+bool fom_dispatch_lp_t::solve(const horizon_t& horizon)
+{
+    if (!m_lp)
+        return false;
+
+    int n_columns = (int)(N_VARIABLES * m_n_steps);
+    int n_rows = get_Nrows(m_lp);
+
+    // objective, with the energy left at the end valued at the worst discharge revenue in the horizon
+    std::vector<REAL> objective(n_columns);
+    std::vector<int> columns(n_columns);
+    double revenue_discharge_min = 0;
+    for (size_t t = 0; t < m_n_steps; t++) {
+        double revenue_discharge = horizon.price_sell[t] * m_eta_discharge - horizon.cost_discharge;
+        revenue_discharge_min = t == 0 ? revenue_discharge : std::min(revenue_discharge_min, revenue_discharge);
+        objective[column(CHARGE_GRID, t) - 1] = -m_dt_hour * horizon.price_buy[t] / m_eta_grid_charge;
+        objective[column(CHARGE_PV, t) - 1] = -m_dt_hour * horizon.price_sell[t] / m_eta_pv_charge;
+        objective[column(CHARGE_CLIPPED, t) - 1] = 0;
+        objective[column(DISCHARGE, t) - 1] = m_dt_hour * revenue_discharge;
+        objective[column(ENERGY, t) - 1] = 0;
+        objective[column(DISCHARGING, t) - 1] = 0;
+    }
+    objective[column(ENERGY, m_n_steps - 1) - 1] = std::max(revenue_discharge_min, 0.0);
+    for (int i = 0; i < n_columns; i++)
+        columns[i] = i + 1;
+    set_obj_fnex(m_lp, n_columns, objective.data(), columns.data());
+
+    // bounds of this horizon
+    std::vector<double> upper(n_columns + 1);
+    for (size_t t = 0; t < m_n_steps; t++) {
+        upper[column(CHARGE_GRID, t)] = std::max(horizon.power_grid_charge_max, 0.0);
+        upper[column(CHARGE_PV, t)] = std::max(horizon.power_pv_max[t], 0.0);
+        upper[column(CHARGE_CLIPPED, t)] = std::max(horizon.power_clipped_max[t], 0.0);
+        upper[column(DISCHARGE, t)] = std::max(horizon.power_discharge_max[t], 0.0);
+        upper[column(ENERGY, t)] = std::max(horizon.energy_max, 0.0);
+        upper[column(DISCHARGING, t)] = 0;
+    }
+    for (int i = 1; i <= n_columns; i++)
+        set_upbo(m_lp, i, upper[i]);
+    set_rh(m_lp, 1, std::min(std::max(horizon.energy_initial, 0.0), upper[column(ENERGY, 0)]));
+
+    // release the discharging indicators of the previous horizon
+    for (size_t t = 0; t < m_n_steps; t++) {
+        if (is_int(m_lp, column(DISCHARGING, t))) {
+            set_int(m_lp, column(DISCHARGING, t), FALSE);
+            set_rh(m_lp, row_discharge(t), get_infinite(m_lp));
+        }
+    }
+
+    // warm start from the basis of the previous horizon, which only differs in its bounds and costs
+    if (m_has_solution)
+        set_basis(m_lp, m_basis.data(), TRUE);
+
+    // the linear program only charges and discharges in the same step where that pays, e.g. storing clipped energy
+    // while discharging or cycling at negative prices. If it does, the discharging indicators of all steps where it
+    // pays are made binary and the horizon re-solved. Most horizons never cycle and stay a single linear program
+    const double power_tolerance = 1e-6;
+    m_iterations = 0;
+    m_solution.resize(n_columns);
+    bool cycling = true;
+    int state = NOTRUN;
+    while (cycling) {
+        state = ::solve(m_lp);
+        if (state != OPTIMAL && state != SUBOPTIMAL) {
+            // retry from the default basis without scaling, which resolves most numerical failures
+            int scaling = get_scaling(m_lp);
+            default_basis(m_lp);
+            set_scaling(m_lp, SCALE_NONE);
+            state = ::solve(m_lp);
+            set_scaling(m_lp, scaling);
+        }
+        m_iterations += get_total_iter(m_lp);
+        if (state != OPTIMAL && state != SUBOPTIMAL)
+            break;
+
+        get_variables(m_lp, m_solution.data());
+        bool cycled = false;
+        for (size_t t = 0; t < m_n_steps && !cycled; t++) {
+            double charge = m_solution[column(CHARGE_GRID, t) - 1] + m_solution[column(CHARGE_PV, t) - 1]
+                + m_solution[column(CHARGE_CLIPPED, t) - 1];
+            cycled = charge > power_tolerance && m_solution[column(DISCHARGE, t) - 1] > power_tolerance;
+        }
+        cycling = false;
+        for (size_t t = 0; t < m_n_steps && cycled; t++) {
+            bool cycling_pays = false;
+            for (int charge : { CHARGE_GRID, CHARGE_PV, CHARGE_CLIPPED }) {
+                if (upper[column(charge, t)] > 0 && upper[column(DISCHARGE, t)] > 0
+                    && objective[column(charge, t) - 1] + objective[column(DISCHARGE, t) - 1] > 0)
+                    cycling_pays = true;
+            }
+            if (cycling_pays && !is_int(m_lp, column(DISCHARGING, t))) {
+                set_mat(m_lp, row_discharge(t), column(DISCHARGING, t), -upper[column(DISCHARGE, t)]);
+                set_rh(m_lp, row_discharge(t), 0);
+                set_upbo(m_lp, column(DISCHARGING, t), 1);
+                set_int(m_lp, column(DISCHARGING, t), TRUE);
+                cycling = true;
+            }
+        }
+    }
+
+    if (state != OPTIMAL && state != SUBOPTIMAL) {
+        m_has_solution = false;
+        default_basis(m_lp);
+        return false;
+    }
+
+    m_basis.resize(n_rows + n_columns + 1);
+    get_basis(m_lp, m_basis.data(), TRUE);
+    m_objective = get_objective(m_lp);
+    m_has_solution = true;
+    return true;
+}
+
+double fom_dispatch_lp_t::power_battery(size_t t) const
+{
+    if (!m_has_solution || t >= m_n_steps)
+        return 0;
+    return m_solution[column(DISCHARGE, t) - 1] - m_solution[column(CHARGE_GRID, t) - 1]
+        - m_solution[column(CHARGE_PV, t) - 1] - m_solution[column(CHARGE_CLIPPED, t) - 1];
+}
+
+double fom_dispatch_lp_t::energy(size_t t) const
+{
+    if (!m_has_solution || t >= m_n_steps)
+        return 0;
+    return m_solution[column(ENERGY, t) - 1];
+}
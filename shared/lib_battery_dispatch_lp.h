@@ -0,0 +1,130 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __LIB_BATTERY_DISPATCH_LP_H__
+#define __LIB_BATTERY_DISPATCH_LP_H__
+
+#include <vector>
+
+struct _lprec;
+
+/*! Linear program for revenue-optimal front of meter battery dispatch over a forecast horizon
+
+ The model is built once for a fixed number of steps and re-solved as the horizon rolls forward: only the
+ objective, the variable bounds and the initial energy change between solves, so each solve is warm-started
+ from the basis of the previous solution.
+
+ Per step t the variables are the DC charge power from the grid, PV and clipped PV, the DC discharge power [kW]
+ and the energy stored above the minimum state of charge at the end of the step [kWh].
+ Energy charged from the grid or PV costs its price divided by the charging efficiency, clipped energy is free,
+ and discharged energy earns its price times the discharge efficiency, less the cycling and O&M cost.
+ A discharging indicator per step keeps the battery from charging and discharging in the same step. It is fixed at
+ zero, and only made binary on steps where doing both pays, such as storing clipped energy while discharging or
+ cycling at negative prices, once the linear program does so; most horizons still solve as a single linear program.
+*/
+class fom_dispatch_lp_t
+{
+public:
+    /// Forecast over one horizon, vectors have one entry per step
+    struct horizon_t
+    {
+        std::vector<double> price_sell;             // price of energy delivered to the grid [$/kWh]
+        std::vector<double> price_buy;              // price of energy bought from the grid [$/kWh]
+        std::vector<double> power_pv_max;           // PV power available to charge the battery [kW]
+        std::vector<double> power_clipped_max;      // clipped PV power available to charge the battery [kW]
+        std::vector<double> power_discharge_max;    // battery discharge power limit [kW]
+        double power_grid_charge_max;               // grid charging power limit, 0 if grid charging is not allowed [kW]
+        double energy_initial;                      // energy stored above the minimum state of charge [kWh]
+        double energy_max;                          // energy between the minimum and maximum state of charge [kWh]
+        double cost_discharge;                      // cycling and O&M cost per energy discharged [$/kWh]
+    };
+
+    /// Empty model, which has no steps and never solves
+    fom_dispatch_lp_t();
+
+    fom_dispatch_lp_t(size_t n_steps, double dt_hour, double power_charge_max,
+        double eta_pv_charge, double eta_grid_charge, double eta_discharge);
+
+    /// Copies rebuild the model and keep the last solution and basis to warm-start from
+    fom_dispatch_lp_t(const fom_dispatch_lp_t& orig);
+
+    fom_dispatch_lp_t& operator=(const fom_dispatch_lp_t& rhs);
+
+    ~fom_dispatch_lp_t();
+
+    /// Solve the horizon, warm-started from the previous solution. Returns false if no solution was found.
+    bool solve(const horizon_t& horizon);
+
+    /// Battery DC power at step t of the last solution, > 0 for discharging [kW]
+    double power_battery(size_t t) const;
+
+    /// Energy stored above the minimum state of charge at the end of step t of the last solution [kWh]
+    double energy(size_t t) const;
+
+    /// Revenue of the last solution [$]
+    double objective() const { return m_objective; }
+
+    /// Simplex iterations taken by the last solve
+    long long iterations() const { return m_iterations; }
+
+    size_t n_steps() const { return m_n_steps; }
+
+private:
+    enum VARIABLES { CHARGE_GRID, CHARGE_PV, CHARGE_CLIPPED, DISCHARGE, ENERGY, DISCHARGING, N_VARIABLES };
+
+    /// lp_solve column of variable at step t, starting at 1
+    int column(int variable, size_t t) const { return (int)(variable * m_n_steps + t + 1); }
+
+    /// lp_solve row limiting the discharge power at step t while not discharging
+    int row_discharge(size_t t) const { return (int)(2 * m_n_steps + t + 1); }
+
+    void construct_model();
+
+    void copy(const fom_dispatch_lp_t& orig);
+
+    size_t m_n_steps;
+    double m_dt_hour;
+    double m_power_charge_max;
+    double m_eta_pv_charge;
+    double m_eta_grid_charge;
+    double m_eta_discharge;
+
+    _lprec* m_lp;
+
+    bool m_has_solution;
+    std::vector<double> m_solution;     // column values, m_solution[0] is column 1
+    std::vector<int> m_basis;           // lp_solve basis of the last solution
+    double m_objective;
+    long long m_iterations;
+};
+
+#endif
@@ -233,7 +233,7 @@ bool dispatch_manual_t::check_constraints(double &I, size_t count)
 		// reset
 		if (iterate)
 		{
-            _Battery->set_state(_Battery_initial->get_state());
+            _Battery->set_state(*_Battery_initial);
 			m_batteryPower->powerBatteryAC = 0;
 			m_batteryPower->powerGridToBattery = 0;
 			m_batteryPower->powerBatteryToGrid = 0;
@@ -53,6 +53,7 @@ void lifetime_cycle_t::initialize() {
     state->cycle->rainflow_Xlt = 0;
     state->cycle->rainflow_Ylt = 0;
     state->cycle->rainflow_peaks.clear();
+    state->cycle->rainflow_peaks_max.clear();
     if (params->model_choice == lifetime_params::CALCYC)
         init_cycle_counts();
     else
@@ -103,6 +104,7 @@ lifetime_cycle_t &lifetime_cycle_t::operator=(const lifetime_cycle_t &rhs) {
     if (this != &rhs) {
         *state = *rhs.state;
         *params = *rhs.params;
+        index_cycling_matrix();
     }
     return *this;
 }
@@ -127,11 +129,24 @@ double lifetime_cycle_t::runCycleLifetime(double DOD) {
     return state->cycle->q_relative_cycle;
 }
 
+void lifetime_cycle_t::sync_peaks_max() {
+    auto &peaks = state->cycle->rainflow_peaks;
+    auto &peaks_max = state->cycle->rainflow_peaks_max;
+    if (peaks_max.size() == peaks.size())
+        return;
+    peaks_max.resize(peaks.size());
+    for (size_t i = 0; i < peaks.size(); i++)
+        peaks_max[i] = i == 0 ? peaks[0] : fmax(peaks_max[i - 1], peaks[i]);
+}
+
 void lifetime_cycle_t::rainflow(double DOD) {
     // initialize return code
     int retCode = cycle_state::LT_GET_DATA;
 
     // Begin algorithm
+    sync_peaks_max();
+    auto &peaks_max = state->cycle->rainflow_peaks_max;
+    peaks_max.push_back(peaks_max.empty() ? DOD : fmax(peaks_max.back(), DOD));
     state->cycle->rainflow_peaks.push_back(DOD);
     bool atStepTwo = true;
 
@@ -188,7 +203,7 @@ int lifetime_cycle_t::rainflow_compareRanges() {
     // Step 5: Count range Y, discard peak & valley of Y, go to Step 2
     if (!contained) {
         state->cycle_range = state->cycle->rainflow_Ylt;
-        state->cycle_DOD = *std::max_element(state->cycle->rainflow_peaks.begin(), state->cycle->rainflow_peaks.end());
+        state->cycle_DOD = state->cycle->rainflow_peaks_max.back();
         state->average_range = (state->average_range * state->n_cycles + state->cycle_range) / (double)(state->n_cycles + (size_t) 1);
         state->n_cycles++;
 
@@ -222,6 +237,9 @@ int lifetime_cycle_t::rainflow_compareRanges() {
         state->cycle->rainflow_peaks.pop_back();
         state->cycle->rainflow_peaks.pop_back();
         state->cycle->rainflow_peaks.push_back(save);
+        auto &peaks_max = state->cycle->rainflow_peaks_max;
+        peaks_max.resize(peaks_max.size() - 3);
+        peaks_max.push_back(peaks_max.empty() ? save : fmax(peaks_max.back(), save));
         state->cycle->rainflow_jlt -= 2;
         // stay in while loop
         retCode = cycle_state::LT_RERANGE;
@@ -251,6 +269,7 @@ void lifetime_cycle_t::replaceBattery(double replacement_percent) {
     state->cycle->rainflow_Xlt = 0;
     state->cycle->rainflow_Ylt = 0;
     state->cycle->rainflow_peaks.clear();
+    state->cycle->rainflow_peaks_max.clear();
 }
 
 int lifetime_cycle_t::cycles_elapsed() { return state->n_cycles; }
@@ -326,129 +345,104 @@ double lifetime_cycle_t::predictAvgSOC(double DOD) {
 
 lifetime_state lifetime_cycle_t::get_state() { return *state; }
 
-double lifetime_cycle_t::bilinear(double DOD, int cycle_number) {
-    /*
-    Work could be done to make this simpler
-    Current idea is to interpolate first along the C = f(n) curves for each DOD to get C_DOD_, C_DOD_+
-    Then interpolate C_, C+ to get C at the DOD of interest
-    */
+void lifetime_cycle_t::index_cycling_matrix() {
+    const auto &cycling_matrix = params->cal_cyc->cycling_matrix;
+    size_t n_rows = cycling_matrix.nrows();
+    cycling_index = cycling_curves();
+    cycling_index.n_rows = n_rows;
+    cycling_index.n_cols = cycling_matrix.ncols();
 
-    std::vector<double> D_unique_vect;
-    std::vector<double> C_n_low_vect;
-    std::vector<double> D_high_vect;
-    std::vector<double> C_n_high_vect;
-    std::vector<size_t> low_indices;
-    std::vector<size_t> high_indices;
-    double D = 0.;
-    size_t n = 0;
-    double C = 100;
-    size_t n_rows = params->cal_cyc->cycling_matrix.nrows();
-
-    // get unique values of D
-    D_unique_vect.push_back(params->cal_cyc->cycling_matrix.at(0, calendar_cycle_params::DOD));
+    double D_min = 100.;
     for (size_t i = 0; i < n_rows; i++) {
-        bool contained = false;
-        for (double j : D_unique_vect) {
-            if (params->cal_cyc->cycling_matrix.at(i, calendar_cycle_params::DOD) == j) {
-                contained = true;
-                break;
-            }
-        }
-        if (!contained) {
-            D_unique_vect.push_back(params->cal_cyc->cycling_matrix.at(i, calendar_cycle_params::DOD));
-        }
-    }
-    n = D_unique_vect.size();
-
-    if (n > 1) {
-        // get where DOD is bracketed [D_lo, DOD, D_hi]
-        double D_lo = 0;
-        double D_hi = 100;
+        double D = cycling_matrix.at(i, calendar_cycle_params::DOD);
+        if (std::find(cycling_index.DOD_levels.begin(), cycling_index.DOD_levels.end(), D) == cycling_index.DOD_levels.end())
+            cycling_index.DOD_levels.push_back(D);
 
-        for (size_t i = 0; i < n_rows; i++) {
-            D = params->cal_cyc->cycling_matrix.at(i, calendar_cycle_params::DOD);
-            if (D < DOD && D > D_lo)
-                D_lo = D;
-            else if (D >= DOD && D < D_hi)
-                D_hi = D;
-        }
+        // keep the same scan that picked the upper curve when the DOD is beyond the table
+        if (D < D_min) { D_min = D; }
+        else if (D > cycling_index.D_max) { cycling_index.D_max = D; }
+    }
+    std::sort(cycling_index.DOD_levels.begin(), cycling_index.DOD_levels.end());
 
-        // Separate table into bins
-        double D_min = 100.;
-        double D_max = 0.;
+    if (cycling_index.DOD_levels.size() < 2 || cycling_index.n_cols <= calendar_cycle_params::CAPACITY_CYCLE)
+        return;
 
+    size_t n_cols = 2;
+    for (double level : cycling_index.DOD_levels) {
+        std::vector<double> C_n_vect;
         for (size_t i = 0; i < n_rows; i++) {
-            D = params->cal_cyc->cycling_matrix.at(i, calendar_cycle_params::DOD);
-            if (D == D_lo)
-                low_indices.push_back(i);
-            else if (D == D_hi)
-                high_indices.push_back(i);
-
-            if (D < D_min) { D_min = D; }
-            else if (D > D_max) { D_max = D; }
-        }
-
-        // if we're out of the bounds, just make the upper bound equal to the highest input
-        if (high_indices.empty()) {
-            for (size_t i = 0; i != n_rows; i++) {
-                if (params->cal_cyc->cycling_matrix.at(i, calendar_cycle_params::DOD) == D_max)
-                    high_indices.push_back(i);
-            }
-        }
-
-        size_t n_rows_lo = low_indices.size();
-        size_t n_rows_hi = high_indices.size();
-        size_t n_cols = 2;
-
-        // If we aren't bounded, fill in values
-        if (n_rows_lo == 0) {
-            // Assumes 0% DOD
-            for (int i = 0; i < n_rows_hi; i++) {
-                C_n_low_vect.push_back(0. + (double)i * 500); // cycles
-                C_n_low_vect.push_back(100.); // 100 % capacity
+            if (cycling_matrix.at(i, calendar_cycle_params::DOD) == level) {
+                C_n_vect.push_back(cycling_matrix.at(i, calendar_cycle_params::CYCLE));
+                C_n_vect.push_back(cycling_matrix.at(i, calendar_cycle_params::CAPACITY_CYCLE));
             }
         }
-
-        if (n_rows_lo != 0) {
-            for (int i = 0; i < (int) n_rows_lo; i++) {
-                C_n_low_vect.push_back(params->cal_cyc->cycling_matrix.at(low_indices[i], calendar_cycle_params::CYCLE));
-                C_n_low_vect.push_back(params->cal_cyc->cycling_matrix.at(low_indices[i], calendar_cycle_params::CAPACITY_CYCLE));
-            }
+        size_t n_level_rows = C_n_vect.size() / n_cols;
+        cycling_index.curves.emplace_back(n_level_rows, n_cols, &C_n_vect);
+
+        // Assumes 0% DOD
+        std::vector<double> C_n_0_vect;
+        for (size_t i = 0; i < n_level_rows; i++) {
+            C_n_0_vect.push_back(0. + (double)i * 500); // cycles
+            C_n_0_vect.push_back(100.); // 100 % capacity
         }
-        if (n_rows_hi != 0) {
-            for (int i = 0; i < (int) n_rows_hi; i++) {
-                C_n_high_vect.push_back(params->cal_cyc->cycling_matrix.at(high_indices[i], calendar_cycle_params::CYCLE));
-                C_n_high_vect.push_back(params->cal_cyc->cycling_matrix.at(high_indices[i], calendar_cycle_params::CAPACITY_CYCLE));
-            }
-        }
-        n_rows_lo = C_n_low_vect.size() / n_cols;
-        n_rows_hi = C_n_high_vect.size() / n_cols;
+        cycling_index.curves_0_DOD.emplace_back(n_level_rows, n_cols, &C_n_0_vect);
+    }
+}
 
-        if (n_rows_lo == 0 || n_rows_hi == 0) {
-            // need a safeguard here
-        }
+size_t lifetime_cycle_t::find_DOD_level(double DOD) {
+    auto &levels = cycling_index.DOD_levels;
+    auto it = std::lower_bound(levels.begin(), levels.end(), DOD);
+    if (it != levels.end() && *it == DOD)
+        return (size_t)(it - levels.begin());
+    return levels.size();
+}
 
-        util::matrix_t<double> C_n_low(n_rows_lo, n_cols, &C_n_low_vect);
-        util::matrix_t<double> C_n_high(n_rows_hi, n_cols, &C_n_high_vect);
+double lifetime_cycle_t::bilinear(double DOD, int cycle_number) {
+    /*
+    Interpolate first along the C = f(n) curves for the DOD levels bracketing DOD to get C_DOD_, C_DOD_+
+    Then interpolate C_, C+ to get C at the DOD of interest
+    */
+    if (cycling_index.n_rows != params->cal_cyc->cycling_matrix.nrows() ||
+        cycling_index.n_cols != params->cal_cyc->cycling_matrix.ncols())
+        index_cycling_matrix();
+
+    auto &levels = cycling_index.DOD_levels;
+    size_t n = levels.size();
+
+    // just have one row, single level interpolation
+    if (n <= 1 || cycling_index.curves.empty())
+        return util::linterp_col(params->cal_cyc->cycling_matrix, 1, cycle_number, 2);
+
+    // get where DOD is bracketed [D_lo, DOD, D_hi], with D_lo in (0, DOD) and D_hi in [DOD, 100)
+    size_t i_hi = (size_t)(std::lower_bound(levels.begin(), levels.end(), DOD) - levels.begin());
+    double D_lo = (i_hi > 0 && levels[i_hi - 1] > 0) ? levels[i_hi - 1] : 0;
+    double D_hi = (i_hi < n && levels[i_hi] < 100) ? levels[i_hi] : 100;
+
+    size_t lo = find_DOD_level(D_lo);
+    size_t hi = D_hi != D_lo ? find_DOD_level(D_hi) : n;
+
+    // if we're out of the bounds, just make the upper bound equal to the highest input
+    if (hi == n) {
+        hi = find_DOD_level(cycling_index.D_max);
+        if (hi == n)
+            hi = n - 1;
+    }
 
-        // Compute C(D_lo, n), C(D_hi, n)
-        double C_Dlo = util::linterp_col(C_n_low, 0, cycle_number, 1);
-        double C_Dhi = util::linterp_col(C_n_high, 0, cycle_number, 1);
+    // If we aren't bounded, assume 0% DOD with as many rows as the upper curve
+    const util::matrix_t<double> &C_n_low = lo < n ? cycling_index.curves[lo] : cycling_index.curves_0_DOD[hi];
+    const util::matrix_t<double> &C_n_high = cycling_index.curves[hi];
 
-        if (C_Dlo < 0.)
-            C_Dlo = 0.;
-        if (C_Dhi > 100.)
-            C_Dhi = 100.;
+    // Compute C(D_lo, n), C(D_hi, n)
+    double C_Dlo = util::linterp_col(C_n_low, 0, cycle_number, 1);
+    double C_Dhi = util::linterp_col(C_n_high, 0, cycle_number, 1);
 
-        // Interpolate to get C(D, n)
-        C = util::interpolate(D_lo, C_Dlo, D_hi, C_Dhi, DOD);
-    }
-        // just have one row, single level interpolation
-    else {
-        C = util::linterp_col(params->cal_cyc->cycling_matrix, 1, cycle_number, 2);
-    }
+    if (C_Dlo < 0.)
+        C_Dlo = 0.;
+    if (C_Dhi > 100.)
+        C_Dhi = 100.;
 
-    return C;
+    // Interpolate to get C(D, n)
+    return util::interpolate(D_lo, C_Dlo, D_hi, C_Dhi, DOD);
 }
 
 /*
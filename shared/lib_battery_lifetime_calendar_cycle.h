@@ -80,6 +80,7 @@ struct cycle_state {
     double rainflow_Ylt;
     int rainflow_jlt;                       // last index in Peaks, i.e, if Peaks = [0,1], then jlt = 1
     std::vector<double> rainflow_peaks;
+    std::vector<double> rainflow_peaks_max; // running max of rainflow_peaks, rebuilt by lifetime_cycle_t if lengths differ
 
     // Cycles' DOD and Count
     // CALCYC model: tracks all cycles in simulation, frequency is binned by DODs provided in cycling_matrix
@@ -168,6 +169,22 @@ protected:
     /// Bilinear interpolation, given the depth-of-discharge and cycle number, return the capacity percent
     double bilinear(double DOD, int cycle_number);
 
+    /// Cycling matrix split into one capacity vs cycles curve per depth-of-discharge level, built once from params
+    struct cycling_curves {
+        size_t n_rows = 0;
+        size_t n_cols = 0;
+        std::vector<double> DOD_levels;                     // unique DODs, ascending
+        std::vector<util::matrix_t<double>> curves;         // [cycles, capacity] rows of each DOD level, in matrix order
+        std::vector<util::matrix_t<double>> curves_0_DOD;   // assumed 0% DOD curve with as many rows as each DOD level
+        double D_max = 0;                                   // DOD used for the upper curve beyond the table
+    } cycling_index;
+
+    /// Build cycling_index from the cycling matrix
+    void index_cycling_matrix();
+
+    /// Index into cycling_index.DOD_levels of the level equal to DOD, or the number of levels if there is none
+    size_t find_DOD_level(double DOD);
+
     std::shared_ptr<lifetime_params> params;
 
     std::shared_ptr<lifetime_state> state;
@@ -175,6 +192,9 @@ protected:
 private:
     void initialize();
 
+    /// Rebuild the running max of the rainflow peaks if the state was replaced
+    void sync_peaks_max();
+
     void init_cycle_counts();
 
     friend class lifetime_calendar_cycle_t;
@@ -350,6 +350,9 @@ voltage_dynamic_t &voltage_dynamic_t::operator=(const voltage_t &rhs) {
         solver_Q = rhs_p->solver_Q;
         solver_Q_mod = rhs_p->solver_Q_mod;
         solver_q = rhs_p->solver_q;
+
+        memo_target = rhs_p->memo_target;
+        memo_max_discharge = rhs_p->memo_max_discharge;
     }
     return *this;
 }
@@ -454,6 +457,13 @@ double voltage_dynamic_t::calculate_max_discharge_w(double q, double qmax, doubl
     //q - Actual battery charge (Ah)
     //qmax - Battery capacity (Ah)
 
+    if (memo_max_discharge.matches(0, q, qmax, 0, params->dt_hr)) {
+        if (max_current)
+            *max_current = memo_max_discharge.current;
+        return memo_max_discharge.power;
+    }
+    double q_battery = q, qmax_battery = qmax;
+
     q /= params->num_strings;
     qmax /= params->num_strings;
     double current = q * 0.5;
@@ -473,10 +483,13 @@ double voltage_dynamic_t::calculate_max_discharge_w(double q, double qmax, doubl
     current = max_I;
     vol = max_V;
 
+    double power = max_p * params->num_strings * params->num_cells_series;
+    memo_max_discharge.set(0, q_battery, qmax_battery, 0, params->dt_hr, power, current * params->num_strings);
+
     if (max_current)
         *max_current = current * params->num_strings;
 
-    return max_p * params->num_strings * params->num_cells_series;
+    return power;
 }
 
 double voltage_dynamic_t::calculate_current_for_target_w(double P_watts, double q, double qmax, double) {
@@ -485,6 +498,9 @@ double voltage_dynamic_t::calculate_current_for_target_w(double P_watts, double
 
     if (P_watts == 0) return 0.;
 
+    if (memo_target.matches(P_watts, q, qmax, 0, params->dt_hr))
+        return memo_target.current;
+
     solver_power = std::abs(P_watts) / (params->num_cells_series * params->num_strings);
     solver_q = q / params->num_strings;
     solver_Q = qmax  / params->num_strings;
@@ -494,26 +510,65 @@ double voltage_dynamic_t::calculate_current_for_target_w(double P_watts, double
     else {
         solver_Q_mod = solver_Q;
     }
-    std::function<void(const double *, double *)> f;
-    double direction = 1.;
-    if (P_watts > 0)
-        f = std::bind(&voltage_dynamic_t::solve_current_for_discharge_power, this, _1, _2);
-    else {
-        f = std::bind(&voltage_dynamic_t::solve_current_for_charge_power, this, _1, _2);
-        direction = -1.;
+    double direction = P_watts > 0 ? 1. : -1.;
+    double current = solve_current_quadratic(direction);
+
+    // fall back to the line search Newton solve away from the well-behaved branch
+    if (current < 0) {
+        std::function<void(const double *, double *)> f;
+        if (P_watts > 0)
+            f = std::bind(&voltage_dynamic_t::solve_current_for_discharge_power, this, _1, _2);
+        else
+            f = std::bind(&voltage_dynamic_t::solve_current_for_charge_power, this, _1, _2);
+
+        double x[1], resid[1];
+        if (state->cell_voltage != 0)
+            x[0] = solver_power / state->cell_voltage * params->dt_hr;
+        else
+            x[0] = solver_power / params->dynamic.Vnom * params->dt_hr;
+        bool check = false;
+
+        newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f,
+                                                                         100, 1e-6, 1e-6, 0.7);
+        current = x[0];
     }
 
-    double x[1], resid[1];
-    if (state->cell_voltage != 0)
-        x[0] = solver_power / state->cell_voltage * params->dt_hr;
-    else
-        x[0] = solver_power / params->dynamic.Vnom * params->dt_hr;
-    bool check = false;
-
-    newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f,
-                                                                     100, 1e-6, 1e-6, 0.7);
-
-    return x[0] * params->num_strings * direction;
+    current *= params->num_strings * direction;
+    memo_target.set(P_watts, q, qmax, 0, params->dt_hr, P_watts, current);
+    return current;
+}
+
+double voltage_dynamic_t::solver_voltage(double I, double direction, double *dV_dI) {
+    double it = solver_Q - solver_q + direction * I * params->dt_hr;
+    double Q_remain = solver_Q_mod - it;
+    double exp_term = _A * exp(-_B0 * it);
+    *dV_dI = -direction * (_K * solver_Q_mod * params->dt_hr / (Q_remain * Q_remain) + _B0 * params->dt_hr * exp_term +
+                           params->resistance);
+    return _E0 - _K * solver_Q_mod / Q_remain + exp_term - direction * params->resistance * I;
+}
+
+double voltage_dynamic_t::solve_current_quadratic(double direction) {
+    // I * (V0 + dV_dI * I) = P has the root nearest P / V0 in closed form
+    double dV_dI;
+    double V = solver_voltage(0, direction, &dV_dI);
+    double discriminant = V * V + 4. * dV_dI * solver_power;
+    if (V <= 0 || discriminant < 0)
+        return -1;
+    double I = 2. * solver_power / (V + std::sqrt(discriminant));
+
+    for (size_t its = 0; its < 10; its++) {
+        V = solver_voltage(I, direction, &dV_dI);
+        double f = I * V - solver_power;
+        if (std::abs(f) < 1e-6)
+            return I;
+        double df = V + I * dV_dI;
+        if (!(df > 0))
+            return -1;
+        I -= f / df;
+        if (!(I >= 0))
+            return -1;
+    }
+    return -1;
 }
 
 void voltage_dynamic_t::solve_current_for_charge_power(const double *x, double *f) {
@@ -563,6 +618,9 @@ voltage_vanadium_redox_t &voltage_vanadium_redox_t::operator=(const voltage_t &r
         solver_T_k = rhs_p->solver_T_k;
         solver_q = rhs_p->solver_q;
         solver_Q = rhs_p->solver_Q;
+
+        memo_target = rhs_p->memo_target;
+        memo_max_discharge = rhs_p->memo_max_discharge;
     }
     return *this;
 }
@@ -603,6 +661,11 @@ double voltage_vanadium_redox_t::calculate_max_charge_w(double q, double qmax, d
 }
 
 double voltage_vanadium_redox_t::calculate_max_discharge_w(double q, double qmax, double kelvin, double *max_current) {
+    if (memo_max_discharge.matches(0, q, qmax, kelvin, params->dt_hr)) {
+        if (max_current)
+            *max_current = memo_max_discharge.current;
+        return memo_max_discharge.power;
+    }
 
     solver_q = q / params->num_strings;
     solver_Q = qmax / params->num_strings;
@@ -626,6 +689,7 @@ double voltage_vanadium_redox_t::calculate_max_discharge_w(double q, double qmax
         current = 0.;
         power = 0.;
     }
+    memo_max_discharge.set(0, q, qmax, kelvin, params->dt_hr, power, current * params->num_strings);
     if (max_current)
         *max_current = current * params->num_strings;
     return power;
@@ -634,24 +698,68 @@ double voltage_vanadium_redox_t::calculate_max_discharge_w(double q, double qmax
 double voltage_vanadium_redox_t::calculate_current_for_target_w(double P_watts, double q, double qmax, double kelvin) {
     if (P_watts == 0) return 0.;
 
+    if (memo_target.matches(P_watts, q, qmax, kelvin, params->dt_hr))
+        return memo_target.current;
+
     solver_power = P_watts / (params->num_cells_series * params->num_strings);
     solver_q = q / params->num_strings;
     solver_Q = qmax / params->num_strings;
     solver_T_k = kelvin;
 
-    std::function<void(const double *, double *)> f = std::bind(&voltage_vanadium_redox_t::solve_current_for_power,
-                                                                this, _1, _2);
+    double current;
+    // fall back to the line search Newton solve away from the well-behaved branch
+    if (!solve_current_quadratic(current)) {
+        std::function<void(const double *, double *)> f = std::bind(&voltage_vanadium_redox_t::solve_current_for_power,
+                                                                    this, _1, _2);
+
+        double x[1], resid[1];
+        if (state->cell_voltage != 0.)
+            x[0] = solver_power / state->cell_voltage * params->dt_hr;
+        else
+            x[0] = solver_power / params->Vnom_default * params->dt_hr;
+        bool check = false;
+
+        newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f,
+                                                                         100, 1e-6, 1e-6, 0.7);
+        current = x[0];
+    }
 
-    double x[1], resid[1];
-    if (state->cell_voltage != 0.)
-        x[0] = solver_power / state->cell_voltage * params->dt_hr;
-    else
-        x[0] = solver_power / params->Vnom_default * params->dt_hr;
-    bool check = false;
+    current *= params->num_strings;
+    memo_target.set(P_watts, q, qmax, kelvin, params->dt_hr, P_watts, current);
+    return current;
+}
 
-    newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f,
-                                                                     100, 1e-6, 1e-6, 0.7);
-    return x[0] * params->num_strings;
+double voltage_vanadium_redox_t::solver_voltage(double I, double *dV_dI) {
+    double SOC = (solver_q - I * params->dt_hr) / solver_Q;
+    double RT = m_RCF * solver_T_k;
+    // at zero current, take the slope of the resistance term on the side of the requested power
+    double sign = I != 0 ? (I > 0 ? 1. : -1.) : (solver_power > 0 ? 1. : -1.);
+    *dV_dI = -2. * RT * (1. / SOC + 1. / (1. - SOC)) * params->dt_hr / solver_Q + sign * params->resistance;
+    return params->Vnom_default + RT * std::log(SOC * SOC / std::pow(1. - SOC, 2)) + std::abs(I) * params->resistance;
+}
+
+bool voltage_vanadium_redox_t::solve_current_quadratic(double &I) {
+    // I * (V0 + dV_dI * I) = P has the root nearest P / V0 in closed form
+    double dV_dI;
+    double V = solver_voltage(0, &dV_dI);
+    double discriminant = V * V + 4. * dV_dI * solver_power;
+    if (!(V > 0) || discriminant < 0)
+        return false;
+    I = 2. * solver_power / (V + std::sqrt(discriminant));
+
+    for (size_t its = 0; its < 10; its++) {
+        V = solver_voltage(I, &dV_dI);
+        double f = I * V - solver_power;
+        if (std::abs(f) < 1e-6)
+            return true;
+        double df = V + I * dV_dI;
+        if (!(df > 0))
+            return false;
+        I -= f / df;
+        if (!(I * solver_power >= 0))
+            return false;
+    }
+    return false;
 }
 
 // I, Q, q0 are on a per-string basis since adding cells in series does not change current or charge
@@ -78,6 +78,37 @@ struct voltage_state {
     bool operator==(const voltage_state &p);
 };
 
+/*
+Inputs and results of the last solve of a voltage model, so that repeated calls at the same operating point,
+such as from the dispatch constraint loops, return without solving again
+*/
+struct voltage_solve_memo {
+    bool valid = false;
+    double P_watts = 0;
+    double q = 0;
+    double qmax = 0;
+    double kelvin = 0;
+    double dt_hr = 0;
+
+    double power = 0;
+    double current = 0;
+
+    bool matches(double P, double q_in, double qmax_in, double T_k, double dt) const {
+        return valid && P == P_watts && q_in == q && qmax_in == qmax && T_k == kelvin && dt == dt_hr;
+    }
+
+    void set(double P, double q_in, double qmax_in, double T_k, double dt, double power_out, double current_out) {
+        valid = true;
+        P_watts = P;
+        q = q_in;
+        qmax = qmax_in;
+        kelvin = T_k;
+        dt_hr = dt;
+        power = power_out;
+        current = current_out;
+    }
+};
+
 /*
 Voltage Base class.
 All voltage models are based on one-cell, but return the voltage for one battery
@@ -228,6 +259,16 @@ protected:
 
     void solve_current_for_discharge_power(const double *x, double *f);
 
+    // cell voltage and its derivative with current at the solver quantities, direction is 1 for discharge, -1 for charge
+    double solver_voltage(double I, double direction, double *dV_dI);
+
+    // cell current for solver_power from the voltage linearized about zero current, polished with Newton steps
+    // returns a negative value if the polish does not converge
+    double solve_current_quadratic(double direction);
+
+    voltage_solve_memo memo_target;
+    voltage_solve_memo memo_max_discharge;
+
 private:
     void initialize();
 
@@ -280,6 +321,16 @@ protected:
 
     void solve_max_discharge_power(const double *x, double *f);
 
+    // cell voltage and its derivative with current at the solver quantities
+    double solver_voltage(double I, double *dV_dI);
+
+    // cell current for solver_power from the voltage linearized about zero current, polished with Newton steps
+    // returns false if the polish does not converge
+    bool solve_current_quadratic(double &I);
+
+    voltage_solve_memo memo_target;
+    voltage_solve_memo memo_max_discharge;
+
 private:
     void initialize();
 
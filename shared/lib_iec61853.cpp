@@ -51,6 +51,7 @@ const char *iec61853_module_t::par_names[PARMAX] = { "IL", "IO", "RS", "RSH", "A
 iec61853_module_t::iec61853_module_t()
 {
 	_imsg = 0;
+	UseAnalyticJacobian = true;
 	alphaIsc = n = Il = Io = C1 = C2 = C3
 			= D1 = D2 = D3 = Egref = std::numeric_limits<double>::quiet_NaN();
 		
@@ -400,7 +401,9 @@ bool iec61853_module_t::solve( double Voc, double Isc, double Vmp, double Imp, d
 	return true;
 }
 
-double Io_fit_eqn( double _x, double *par, void * )
+// fit equations with analytic partial derivatives w.r.t. the fit parameters,
+// filled in dfdpar when requested by lsqfit
+double Io_fit_deriv( double _x, double *par, double *dfdpar, void * )
 {
 	double T = _x; 
 	
@@ -409,24 +412,66 @@ double Io_fit_eqn( double _x, double *par, void * )
     double Egref = par[0];    
     
     double Eg = (1-0.0002677*T)*Egref;
-	return pow((Tref+dT)/Tref,3)*exp( 11600 * (Egref/Tref - Eg/(Tref+dT)));
+	double f = pow((Tref+dT)/Tref,3)*exp( 11600 * (Egref/Tref - Eg/(Tref+dT)));
+	if ( dfdpar )
+		dfdpar[0] = f * 11600 * ( 1/Tref - (1-0.0002677*T)/(Tref+dT) );
+	return f;
 }
 
-double Rsh_fit_eqn( double _x, double *par, void * )
+double Rsh_fit_deriv( double _x, double *par, double *dfdpar, void * )
 {
-	return par[0] + par[1]*( pow(1000/_x, par[2]) - 1 );
+	double u = pow(1000/_x, par[2]);
+	if ( dfdpar )
+	{
+		dfdpar[0] = 1;
+		dfdpar[1] = u - 1;
+		dfdpar[2] = par[1]*u*log(1000/_x);
+	}
+	return par[0] + par[1]*( u - 1 );
 }
 
-double Rsh_fit_eqn_2par( double _x, double *par, void *arg )
+double Rsh_fit_2par_deriv( double _x, double *par, double *dfdpar, void *arg )
 {
 	double *Rsh_stc = (double*)arg;
-	return *Rsh_stc + par[0]*( pow(1000/_x, par[1]) - 1 );
+	double u = pow(1000/_x, par[1]);
+	if ( dfdpar )
+	{
+		dfdpar[0] = u - 1;
+		dfdpar[1] = par[0]*u*log(1000/_x);
+	}
+	return *Rsh_stc + par[0]*( u - 1 );
+}
+
+double Rs_fit_deriv( double _x, double *par, double *dfdpar, void * )
+{
+	double g = ( 1-_x/1000)*pow(1000/_x, 2.0);
+	if ( dfdpar )
+	{
+		dfdpar[0] = 1;
+		dfdpar[1] = g;
+	}
+	return par[0] + par[1]*g;
+}
+
+double Io_fit_eqn( double _x, double *par, void *arg )
+{
+	return Io_fit_deriv( _x, par, 0, arg );
+}
+
+double Rsh_fit_eqn( double _x, double *par, void *arg )
+{
+	return Rsh_fit_deriv( _x, par, 0, arg );
+}
+
+double Rsh_fit_eqn_2par( double _x, double *par, void *arg )
+{
+	return Rsh_fit_2par_deriv( _x, par, 0, arg );
 }
 
 
-double Rs_fit_eqn( double _x, double *par, void * )
+double Rs_fit_eqn( double _x, double *par, void *arg )
 {
-	return par[0] + ( 1-_x/1000) *par[1]*pow(1000/_x, 2.0);
+	return Rs_fit_deriv( _x, par, 0, arg );
 }
 
 
@@ -687,9 +732,10 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 	// do a nonlinear least squares to fit the Io equation as a function of temperature
 	// free parameter is Egref. initial guess is 1.0
 	double Egref_fit[1] = { 1.0 };
-	if ( !lsqfit( Io_fit_eqn, 0, Egref_fit, 1, 
-		&Io_temps[0], &Io_avgs[0], Io_temps.size(), 
-		1e-9, 200, 20000 ) )
+	int info = UseAnalyticJacobian
+		? lsqfit( Io_fit_deriv, 0, Egref_fit, 1, &Io_temps[0], &Io_avgs[0], Io_temps.size(), 1e-9, 200, 20000 )
+		: lsqfit( Io_fit_eqn, 0, Egref_fit, 1, &Io_temps[0], &Io_avgs[0], Io_temps.size(), 1e-9, 200, 20000 );
+	if ( !info )
 	{
 		OUTLN("error in nonlinear least squares fit for Io equation");
 		return false;
@@ -750,9 +796,10 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 
 #ifdef CPAR_3
 	double C[3] = { 1000, 100, 0.25 }; // initial guesses for lsqfit
-	if ( !lsqfit( Rsh_fit_eqn, 0, C, 3, 
-			&Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 
-			1.0e-9, 500, 50000 ) )
+	info = UseAnalyticJacobian
+		? lsqfit( Rsh_fit_deriv, 0, C, 3, &Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 1.0e-9, 500, 50000 )
+		: lsqfit( Rsh_fit_eqn, 0, C, 3, &Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 1.0e-9, 500, 50000 );
+	if ( !info )
 	{
 		OUTLN("error in nonlinear least squares fit for Rsh equation");
 		return false;
@@ -760,9 +807,10 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 #else
 	double C[3] = { 100, 0.25, 0 };
 	
-	if ( !lsqfit( Rsh_fit_eqn_2par, &Rsh_stc, C, 2, 
-			&Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 
-			1.0e-9, 500, 50000 ) )
+	info = UseAnalyticJacobian
+		? lsqfit( Rsh_fit_2par_deriv, &Rsh_stc, C, 2, &Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 1.0e-9, 500, 50000 )
+		: lsqfit( Rsh_fit_eqn_2par, &Rsh_stc, C, 2, &Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 1.0e-9, 500, 50000 );
+	if ( !info )
 	{
 		OUTLN("error in nonlinear least squares fit for Rsh equation");
 		return false;
@@ -802,9 +850,10 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 		if ( Ivec.size() >= 3 )
 		{
 			double Dpr[2] = { 5.0, 1.0 };
-			if ( !lsqfit( Rs_fit_eqn, 0, Dpr, 2, 
-				&Ivec[0], &Rsvec[0], Ivec.size(), 
-				1.0e-9, 400, 40000 ) )
+			info = UseAnalyticJacobian
+				? lsqfit( Rs_fit_deriv, 0, Dpr, 2, &Ivec[0], &Rsvec[0], Ivec.size(), 1.0e-9, 400, 40000 )
+				: lsqfit( Rs_fit_eqn, 0, Dpr, 2, &Ivec[0], &Rsvec[0], Ivec.size(), 1.0e-9, 400, 40000 );
+			if ( !info )
 			{ 
 				PRINTF("error in nonlinear least squares fit for Rs equation at %lg C", temps[i] );
 				return false;
@@ -864,6 +913,31 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 	return true;
 }
 
+void iec61853_batch_t::resize( size_t count )
+{
+	modules.resize( count );
+	input.resize( count );
+	nseries.resize( count, 0 );
+	type.resize( count, 0 );
+	par.resize( count );
+	ok.resize( count, 0 );
+}
+
+size_t iec61853_batch_t::calculate( int nthreads )
+{
+	size_t count = modules.size();
+	if ( count == 0 ) return 0;
+
+	util::parallel_for( count, nthreads, [&]( size_t i, int ) {
+		ok[i] = modules[i].calculate( input[i], nseries[i], type[i], par[i], false ) ? 1 : 0;
+	} );
+
+	size_t nok = 0;
+	for ( size_t i = 0; i < count; i++ )
+		if ( ok[i] ) nok++;
+	return nok;
+}
+
 bool iec61853_module_t::operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &out )
 {
 	/* initialize output first */
@@ -33,6 +33,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _iec61853_h
 #define _iec61853_h
 
+#include <vector>
+
 #include "lib_util.h"
 #include "lib_pvmodel.h"
 
@@ -79,6 +81,10 @@ public:
 
 	Imessage_api *_imsg;
 
+	// supply analytic Jacobians to the Io, Rsh and Rs equation fits
+	// instead of letting mpfit finite-difference them
+	bool UseAnalyticJacobian;
+
 
 	#define ROW_MAX 30
 	enum { COL_IRR, COL_TC, COL_PMP, COL_VMP, COL_VOC, COL_ISC, COL_MAX };
@@ -102,6 +108,26 @@ public:
 	virtual bool operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output );
 };
 
+// fits many modules' test matrices concurrently.  each module is independent,
+// so modules are handed out to worker threads one at a time.  solver messages
+// are not thread safe, so _imsg should be left null on the batch modules.
+class iec61853_batch_t
+{
+public:
+	std::vector<iec61853_module_t> modules;
+	std::vector< util::matrix_t<double> > input; // [IRR,TC,PMP,VMP,VOC,ISC] per module
+	std::vector<int> nseries;
+	std::vector<int> type;
+
+	// results
+	std::vector< util::matrix_t<double> > par; // [IL,IO,RS,RSH,A] per module and condition
+	std::vector<int> ok;
+
+	void resize( size_t count );
+	// nthreads <= 0 uses all hardware threads; returns the number of modules solved
+	size_t calculate( int nthreads = 0 );
+};
+
 
 
 
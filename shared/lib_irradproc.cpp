@@ -40,6 +40,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <vector>
 #include <numeric>
+#include <algorithm>
 #include <assert.h>
 
 #include "lib_irradproc.h"
@@ -1424,81 +1425,116 @@ double GTI_DIRINT(const double poa[3], const double inc[3], double zen, double t
     return Ktp;
 }
 
-int poaDecomp(double, double angle[], double sun[], double alb, poaDecompReq *pA, double &dn, double &df, double &gh,
-              double poa[3], double diffc[3]) {
+size_t poaDecompReq::stepsInDay() const {
+    size_t steps = 24;
+    if (stepScale == 'm') {
+        steps *= 60 / (unsigned int) stepSize;
+    }
+    return steps;
+}
+
+/* DIRINT precipitable water bin of dew point td (C), 4 when the dew point is missing. The dew point only enters the
+   DIRINT and GTI_DIRINT models through this bin */
+static int dirint_water_bin(double td) {
+    if (td < -998.0)
+        return 4;
+    double wbin[3] = {1.0, 2.0, 3.0};
+    double w = exp(-0.075 + 0.07 * td);
+    int l = 0;
+    while (l < 3 && w >= wbin[l])
+        l++;
+    return l;
+}
+
+/* Decomposes POA at time index idx of pA; the cursor (day start, day of year, dew point) is passed separately so that
+   several days can be decomposed concurrently from the same arrays */
+static int poa_decomp_at(const poaDecompReq &pA, size_t idx, size_t dayStart, int doy, double tDew, poaKtpMemo &memo,
+                         double angle[], double sun[], double alb, double &dn, double &df, double &gh,
+                         double poa[3], double diffc[3]) {
 
     int errorcode = 0; //code to return whether the decomposition method succeeded or failed
 
     /* Decomposes POA into direct normal and diffuse irradiances */
 
     double r90(M_PI / 2), r80(80.0 / 180 * M_PI), r65(65.0 / 180 * M_PI);
+    size_t last = pA.POA.size() - 1;
 
     if (angle[0] < r90) {  // Check if incident angle if greater than 90 degrees
 
-        double gti[] = {pA->POA[pA->i - 1], pA->POA[pA->i], pA->POA[pA->i + 1]};
-        double inc[] = {pA->inc[pA->i - 1], pA->inc[pA->i], pA->inc[pA->i + 1]};
+        size_t prev = idx > 0 ? idx - 1 : idx, next = idx < last ? idx + 1 : idx;
+        double gti[] = {pA.POA[prev], pA.POA[idx], pA.POA[next]};
+        double inc[] = {pA.inc[prev], pA.inc[idx], pA.inc[next]};
 
-        GTI_DIRINT(gti, inc, sun[1], angle[1], sun[8], alb, pA->doy, pA->tDew, pA->elev, dn, df, gh, poa);
+        GTI_DIRINT(gti, inc, sun[1], angle[1], sun[8], alb, doy, tDew, pA.elev, dn, df, gh, poa);
 
     }
     else {
 
-        size_t stepsInDay = 24;
-        if (pA->stepScale == 'm') {
-            stepsInDay *= 60 / (unsigned int) pA->stepSize;
-        }
+        size_t stepsInDay = pA.stepsInDay();
 
-        size_t noon = pA->dayStart + stepsInDay / 2;
+        size_t noon = dayStart + stepsInDay / 2;
         size_t start, stop;
         // Check for a morning value or evening, set looping bounds accordingly
-        if (pA->i < noon) { // Calculate morning value
-            start = pA->dayStart;
+        if (idx < noon) { // Calculate morning value
+            start = dayStart;
             stop = noon;
         }
         else {
             start = noon;
-            stop = pA->dayStart + stepsInDay;
+            stop = dayStart + stepsInDay;
         }
 
-
-        // Determine an average Kt prime value
-        int count = 0;
+        // Determine an average Kt prime value, unless this half day was already averaged under the same conditions
         double avgKtp = 0;
-
-        for (size_t j = start; j < stop; j++) {
-
-
-            if ((pA->inc[j] < r80) && (pA->inc[j] > r65)) {
-                count++;
-                double gti[] = {pA->POA[j - 1], pA->POA[j], pA->POA[j + 1]};
-                double inc[] = {pA->inc[j - 1], pA->inc[j], pA->inc[j + 1]};
-
-                double dnTmp, dfTmp, ghTmp, poaTmp[3];
-                avgKtp += GTI_DIRINT(gti, inc, pA->zen[j], pA->tilt[j], pA->exTer[j], alb, pA->doy, pA->tDew, pA->elev,
-                                     dnTmp, dfTmp, ghTmp, poaTmp);
+        int waterBin = dirint_water_bin(tDew);
+        if (memo.stop > memo.start && memo.start == start && memo.stop == stop && memo.doy == doy
+            && memo.waterBin == waterBin && memo.alb == alb) {
+            avgKtp = memo.avgKtp;
+        }
+        else {
+            int count = 0;
+            for (size_t j = start; j < stop && j <= last; j++) {
+
+                if ((pA.inc[j] < r80) && (pA.inc[j] > r65)) {
+                    count++;
+                    size_t prev = j > 0 ? j - 1 : j, next = j < last ? j + 1 : j;
+                    double gti[] = {pA.POA[prev], pA.POA[j], pA.POA[next]};
+                    double inc[] = {pA.inc[prev], pA.inc[j], pA.inc[next]};
+
+                    double dnTmp, dfTmp, ghTmp, poaTmp[3];
+                    avgKtp += GTI_DIRINT(gti, inc, pA.zen[j], pA.tilt[j], pA.exTer[j], alb, doy, tDew, pA.elev,
+                                         dnTmp, dfTmp, ghTmp, poaTmp);
+                }
             }
+            // fails when count = 0;
+            //avgKtp /= count;
+            if (count > 0)
+                avgKtp /= count;
+
+            memo.start = start;
+            memo.stop = stop;
+            memo.doy = doy;
+            memo.waterBin = waterBin;
+            memo.alb = alb;
+            memo.avgKtp = avgKtp;
         }
-        // fails when count = 0;
-        //avgKtp /= count;
-        if (count > 0)
-            avgKtp /= count;
 
         //Calculate Kt
         double am = Min(15.25, 1.0 / (cos(sun[1]) + 0.15 * (pow(93.9 - sun[1] * 180 / M_PI, -1.253)))); // air mass
-        double ktpam = am * exp(-0.0001184 * pA->elev);
+        double ktpam = am * exp(-0.0001184 * pA.elev);
         double Kt = avgKtp * (1.031 * exp(-1.4 / (0.9 + 9.4 / ktpam)) + 0.1);
 
         //Calculate DNI using DIRINT
         double Kt_[3] = {-999, Kt, -999};
         double Ktp_[3] = {-999, avgKtp, -999};
-        double gti[3] = {-999, pA->POA[pA->i], -999};
+        double gti[3] = {-999, pA.POA[idx], -999};
         double zen[3] = {-999, sun[1], -999}; // Might need to be Zenith angle instead of inciden
 
-        ModifiedDISC(Kt_, Ktp_, gti, zen, pA->tDew, pA->elev, pA->doy, dn);
+        ModifiedDISC(Kt_, Ktp_, gti, zen, tDew, pA.elev, doy, dn);
 
         // Calculate DHI and GHI
         double ct = cos(angle[1]);
-        df = (2 * pA->POA[pA->i] - dn * cos(sun[1]) * alb * (1 - ct)) / (1 + ct + alb * (1 - ct));
+        df = (2 * pA.POA[idx] - dn * cos(sun[1]) * alb * (1 - ct)) / (1 + ct + alb * (1 - ct));
         gh = dn * cos(angle[0]) + df;
 
         // Get component poa from Perez
@@ -1525,6 +1561,57 @@ int poaDecomp(double, double angle[], double sun[], double alb, poaDecompReq *pA
     return errorcode;
 }
 
+int poaDecomp(double, double angle[], double sun[], double alb, poaDecompReq *pA, double &dn, double &df, double &gh,
+              double poa[3], double diffc[3]) {
+    return poa_decomp_at(*pA, pA->i, pA->dayStart, pA->doy, pA->tDew, pA->ktpMemo, angle, sun, alb, dn, df, gh, poa,
+                         diffc);
+}
+
+size_t poa_decomp_batch_t::calculate(int nthreads) {
+    size_t count = data.POA.size();
+    dn.assign(count, 0);
+    df.assign(count, 0);
+    gh.assign(count, 0);
+    poaBeam.assign(count, 0);
+    poaSky.assign(count, 0);
+    poaGround.assign(count, 0);
+    errorcode.assign(count, 0);
+
+    if (count == 0 || data.inc.size() != count || data.tilt.size() != count || data.zen.size() != count
+        || data.exTer.size() != count || tDew.size() != count || (albedo.size() != count && albedo.size() != 1))
+        return 0;
+
+    size_t stepsInDay = data.stepsInDay();
+    size_t ndays = (count + stepsInDay - 1) / stepsInDay;
+
+    nthreads = util::thread_count(nthreads, ndays);
+    std::vector<poaKtpMemo> memos(nthreads);
+    util::parallel_for(ndays, nthreads, [&](size_t d, int t) {
+        size_t dayStart = d * stepsInDay;
+        size_t dayEnd = std::min(dayStart + stepsInDay, count);
+        for (size_t i = dayStart; i < dayEnd; i++) {
+            // sun below the horizon, or no incidence angle computed for this step
+            if (data.zen[i] >= M_PI / 2 || data.inc[i] == -999)
+                continue;
+
+            double angle[5] = {data.inc[i], data.tilt[i], 0, 0, 0};
+            double sun[9] = {0, data.zen[i], 0, 0, 0, 0, 0, 0, data.exTer[i]};
+            double alb = albedo.size() == 1 ? albedo[0] : albedo[i];
+            double poa[3] = {0, 0, 0}, diffc[3] = {0, 0, 0};
+            errorcode[i] = poa_decomp_at(data, i, dayStart, (int) d, tDew[i], memos[t], angle, sun, alb,
+                                         dn[i], df[i], gh[i], poa, diffc);
+            poaBeam[i] = poa[0];
+            poaSky[i] = poa[1];
+            poaGround[i] = poa[2];
+        }
+    });
+
+    size_t nok = 0;
+    for (size_t i = 0; i < count; i++)
+        if (errorcode[i] == 0) nok++;
+    return nok;
+}
+
 void isotropic(double, double dn, double df, double alb, double inc, double tilt, double zen, double poa[3],
                double diffc[3]) {
     /* added aug2011 by aron dobos. Defines isotropic sky model for diffuse irradiance on a tilted surface
@@ -1752,6 +1839,12 @@ void irrad::setup() {
     poaRearRowReflections = 0.;
     poaRearSelfShaded = 0.;
 
+    for (int i = 0; i < 5; i++) {
+        skyConfigGeometry[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    for (int i = 0; i < 4; i++) {
+        albedoAlignedGeometry[i] = std::numeric_limits<double>::quiet_NaN();
+    }
 }
 
 irrad::irrad() {
@@ -2053,6 +2146,13 @@ void irrad::set_sun_component(size_t index, double value) {
 }
 
 int irrad::calc() {
+    int code = calc_sun();
+    if (code != 0)
+        return code;
+    return calc_surface();
+}
+
+int irrad::calc_sun() {
     int code = check();
     if (code < 0)
         return -100 + code;
@@ -2163,7 +2263,10 @@ int irrad::calc() {
         ineichen(clearskyIrradiance, RTOD * sunAnglesRadians[1], 1.5, 1.0, elevation);
     }
 
+    return 0;
+}
 
+int irrad::calc_surface() {
     planeOfArrayIrradianceFront[0] = planeOfArrayIrradianceFront[1] = planeOfArrayIrradianceFront[2] = 0;
     planeOfArrayIrradianceFrontCS[0] = planeOfArrayIrradianceFrontCS[1] = planeOfArrayIrradianceFrontCS[2] = 0;
     diffuseIrradianceFront[0] = diffuseIrradianceFront[1] = diffuseIrradianceFront[2] = 0;
@@ -2259,9 +2362,14 @@ int irrad::calc() {
                                       directNormal, diffuseHorizontal, globalHorizontal, planeOfArrayIrradianceFront,
                                       diffuseIrradianceFront);
             if (enableSubhourlyClipping) {
-                int errorcode_cs = poaDecomp(weatherFilePOA, surfaceAnglesRadians, sunAnglesRadians, albedo, poaAll,
-                    clearskyIrradiance[1], clearskyIrradiance[2], clearskyIrradiance[0], planeOfArrayIrradianceFrontCS,
-                    diffuseIrradianceFrontCS);
+                // the clear sky decomposition has identical inputs, so reuse the one just made
+                clearskyIrradiance[0] = globalHorizontal;
+                clearskyIrradiance[1] = directNormal;
+                clearskyIrradiance[2] = diffuseHorizontal;
+                for (int k = 0; k < 3; k++) {
+                    planeOfArrayIrradianceFrontCS[k] = planeOfArrayIrradianceFront[k];
+                    diffuseIrradianceFrontCS[k] = diffuseIrradianceFront[k];
+                }
             }
             calculatedDirectNormal = directNormal;
             calculatedDiffuseHorizontal = diffuseHorizontal;
@@ -2300,36 +2408,36 @@ int irrad::calc_rear_side(double transmissionFactor, double groundClearanceHeigh
         double distanceBetweenRows = rowToRow - horizontalLength;                   // distance between back of row to front of next row
 
         // Determine the view factors for points on the ground to the sky in the rowToRow interval
-        std::vector<double> rearSkyConfigFactors, frontSkyConfigFactors;
-        this->getSkyConfigurationFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows,
-                                         horizontalLength, rearSkyConfigFactors, frontSkyConfigFactors);
+        // These depend only on the row geometry, so they are reused until the geometry changes (e.g., every step for fixed tilt)
+        double geometry[5] = { rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength };
+        if (!std::equal(geometry, geometry + 5, skyConfigGeometry)) {
+            this->getSkyConfigurationFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows,
+                                             horizontalLength, rearSkyConfigFactors, frontSkyConfigFactors);
+            std::copy(geometry, geometry + 5, skyConfigGeometry);
+        }
 
         // Determine whether points on the ground in the rowToRow interval are shaded or not from DNI (also shaded fraction of PV back and front)
         double pvBackShadeFraction, pvFrontShadeFraction, maxShadow;
         pvBackShadeFraction = pvFrontShadeFraction = maxShadow = 0;
-        std::vector<int> rearGroundShade, frontGroundShade;
         this->getGroundShadeFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength,
                                     sunAnglesRadians[0], sunAnglesRadians[2], rearGroundShade, frontGroundShade,
                                     maxShadow, pvBackShadeFraction, pvFrontShadeFraction);
 
         // Calculate GHI for the points on the ground in the rowToRow interval, considering shading and view factors to the sky
-        std::vector<double> rearGroundGHI, frontGroundGHI;
         this->getGroundGHI(transmissionFactor, rearSkyConfigFactors, frontSkyConfigFactors, rearGroundShade,
                            frontGroundShade, rearGroundGHI, frontGroundGHI);
         groundIrradianceSpatial = condenseAndAlignGroundIrrad(rearGroundGHI, groundIrradOutputRes, trackingMode == 1, horizontalLength, rowToRow, surfaceAnglesRadians[3]);
 
         // Calculate the irradiance on the front of the PV module (to get front reflected)
-        std::vector<double> frontIrradiancePerCellrow, frontReflected;
         double frontAverageIrradiance = 0;
         getFrontSurfaceIrradiances(pvFrontShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows,
                                    horizontalLength, frontGroundGHI, frontIrradiancePerCellrow, frontAverageIrradiance,
-                                   frontReflected);
+                                   frontReflectedPerCellrow);
 
         // Calculate the irradiance on the back of the PV module
-        std::vector<double> rearIrradiancePerCellrow;
         double rearAverageIrradiance = 0;
         getBackSurfaceIrradiances(pvBackShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows,
-                                  horizontalLength, rearGroundGHI, frontGroundGHI, frontReflected,
+                                  horizontalLength, rearGroundGHI, frontGroundGHI, frontReflectedPerCellrow,
                                   rearIrradiancePerCellrow, rearAverageIrradiance);
         planeOfArrayIrradianceRearAverage = rearAverageIrradiance;
         planeOfArrayIrradianceRearSpatial = rearIrradiancePerCellrow;
@@ -2350,6 +2458,8 @@ void irrad::getSkyConfigurationFactors(double rowToRow, double verticalHeight, d
     size_t intervals = 100;
     double deltaInterval = static_cast<double>(rowToRow / intervals);
     double x = -deltaInterval / 2.0;
+    rearSkyConfigFactors.clear();
+    frontSkyConfigFactors.clear();
 
     for (size_t i = 0; i != intervals; i++) {
         x += deltaInterval;
@@ -2503,6 +2613,8 @@ irrad::getGroundShadeFactors(double rowToRow, double verticalHeight, double clea
 
     }
     double x = -deltaInterval / 2.0;
+    rearGroundShade.clear();
+    frontGroundShade.clear();
     for (size_t i = 0; i != intervals; i++) {
         x += deltaInterval;
         if ((x >= shadingStart1 && x < shadingEnd1) || (x >= shadingStart2 && x < shadingEnd2)) {
@@ -2517,9 +2629,9 @@ irrad::getGroundShadeFactors(double rowToRow, double verticalHeight, double clea
     maxShadow = fmax(shadingStart1, shadingEnd1);
 }
 
-void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyConfigFactors,
-                         std::vector<double> frontSkyConfigFactors, std::vector<int> rearGroundShade,
-                         std::vector<int> frontGroundShade, std::vector<double> &rearGroundGHI,
+void irrad::getGroundGHI(double transmissionFactor, const std::vector<double> &rearSkyConfigFactors,
+                         const std::vector<double> &frontSkyConfigFactors, const std::vector<int> &rearGroundShade,
+                         const std::vector<int> &frontGroundShade, std::vector<double> &rearGroundGHI,
                          std::vector<double> &frontGroundGHI) {
     // Calculate the irradiance components on horizontal unobstructed ground
     perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal, albedo, sunAnglesRadians[1], 0.0, sunAnglesRadians[1],
@@ -2527,6 +2639,8 @@ void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyC
     double incidentBeam = planeOfArrayIrradianceRear[0];
     double isotropicDiffuse = diffuseIrradianceRear[0];
     double circumsolarDiffuse = diffuseIrradianceRear[1];
+    rearGroundGHI.clear();
+    frontGroundGHI.clear();
 
     // Sum the irradiance components for each of the ground segments to the front and rear of the front of the PV row
     for (size_t i = 0; i != 100; i++) {
@@ -2555,7 +2669,7 @@ void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyC
 
 void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowToRow, double verticalHeight,
                                        double clearanceGround, double distanceBetweenRows, double horizontalLength,
-                                       std::vector<double> frontGroundGHI, std::vector<double> &frontIrradiance,
+                                       const std::vector<double> &frontGroundGHI, std::vector<double> &frontIrradiance,
                                        double &frontAverageIrradiance, std::vector<double> &frontReflected) {
     // front surface assumed to be glass
     double n2 = 1.526;
@@ -2590,8 +2704,13 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
     double PtopY = verticalHeight +
                    clearanceGround; // y value for point on top edge of PV module/panel of row in front of (in PV panel slope lengths)
 
+    // Average ground irradiance, used where a 1-degree projection spans the whole row-to-row interval
+    double averageFrontGroundGHI = std::accumulate(frontGroundGHI.begin(), frontGroundGHI.end(), 0.) / frontGroundGHI.size();
+
     // Calculate diffuse and direct component irradiances for each cell row (assuming 6 rows)
     size_t cellRows = poaFrontIrradRes;
+    frontIrradiance.clear();
+    frontReflected.clear();
     for (size_t i = 0; i != cellRows; i++) {
         // Calculate diffuse irradiances and reflected amounts for each cell row over its field of view of 180 degrees,
         // beginning with the angle providing the upper most view of the sky (j=0)
@@ -2631,15 +2750,8 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 
 
         // Add ground reflected component
-        std::vector<double> albedoAligned;
-        if (trackingMode == 0 || trackingMode == 1 || trackingMode == 4) {          // 0=fixed, 1=one-axis, 4=seasonal tilt
-            // subdivide spatial albedos to match ground GHI length and align reference point at front of row
-            albedoAligned = divideAndAlignAlbedos(albedoSpatial, intervals, trackingMode == 1, horizontalLength, rowToRow, surfaceAnglesRadians[3]);
-        }
-        else {
-            double average_albedo = std::accumulate(albedoSpatial.begin(), albedoSpatial.end(), 0.) / albedoSpatial.size();
-            albedoAligned.assign(intervals, average_albedo);
-        }
+        const std::vector<double>& albedoAligned = getAlignedAlbedos(intervals, horizontalLength, rowToRow);
+        double averageAlbedoAligned = std::accumulate(albedoAligned.begin(), albedoAligned.end(), 0.) / albedoAligned.size();
 
         for (size_t j = iStartGrd; j < 180; j++) {
             double startElevationDown = (j - iStartGrd) * DTOR + elevationAngleDown;
@@ -2651,8 +2763,8 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 
             if (std::abs(projectedX1 - projectedX2) > 0.99 * rowToRow) {
                 // Use average value if projection approximates the rtr
-                actualGroundGHI = std::accumulate(frontGroundGHI.begin(), frontGroundGHI.end(), 0.) / frontGroundGHI.size();
-                reflectedGroundGHI = actualGroundGHI * std::accumulate(albedoAligned.begin(), albedoAligned.end(), 0.) / albedoAligned.size();
+                actualGroundGHI = averageFrontGroundGHI;
+                reflectedGroundGHI = actualGroundGHI * averageAlbedoAligned;
             }
             else {
                 projectedX1 = intervals * projectedX1 / rowToRow;
@@ -2737,8 +2849,8 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 
 void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight,
                                       double clearanceGround, double, double horizontalLength,
-                                      std::vector<double> rearGroundGHI, std::vector<double> frontGroundGHI,
-                                      std::vector<double> frontReflected, std::vector<double> &rearIrradiance,
+                                      const std::vector<double> &rearGroundGHI, const std::vector<double> &frontGroundGHI,
+                                      const std::vector<double> &frontReflected, std::vector<double> &rearIrradiance,
                                       double &rearAverageIrradiance) {
     // front surface assumed to be glass
     double n2 = 1.526;
@@ -2781,7 +2893,9 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
     poaRearGroundReflected = 0.;                        // the average ground reflected irradiance onto the rear, considering view factor
     std::vector<double> rearSelfShaded;                 // the direct and circumsolar shaded from being incident on the rear, for each cell
     poaRearSelfShaded = 0.;                             // the average direct and circumsolar shaded from being incident on the rear
+    double averageRearGroundGHI = std::accumulate(rearGroundGHI.begin(), rearGroundGHI.end(), 0.) / rearGroundGHI.size();
     size_t cellRows = poaRearIrradRes;
+    rearIrradiance.clear();
     for (size_t i = 0; i != cellRows; i++) {
         // Calculate diffuse irradiances and reflected amounts for each cell row over its field of view of 180 degrees,
         // beginning with the angle providing the upper most view of the sky (j=0)
@@ -2861,15 +2975,8 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 
 
         // Add ground reflected component
-        std::vector<double> albedoAligned;
-        if (trackingMode == 0 || trackingMode == 1 || trackingMode == 4) {          // 0=fixed, 1=one-axis, 4=seasonal tilt
-            // subdivide spatial albedos to match ground GHI length and align reference point at front of row
-            albedoAligned = divideAndAlignAlbedos(albedoSpatial, intervals, trackingMode == 1, horizontalLength, rowToRow, surfaceAnglesRadians[3]);
-        }
-        else {
-            double average_albedo = std::accumulate(albedoSpatial.begin(), albedoSpatial.end(), 0.) / albedoSpatial.size();
-            albedoAligned.assign(intervals, average_albedo);
-        }
+        const std::vector<double>& albedoAligned = getAlignedAlbedos(intervals, horizontalLength, rowToRow);
+        double averageAlbedoAligned = std::accumulate(albedoAligned.begin(), albedoAligned.end(), 0.) / albedoAligned.size();
 
         rearGroundReflected.push_back(0);
         for (size_t j = iStartGrd; j < 180; j++) {
@@ -2882,8 +2989,8 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 
             if (std::abs(projectedX1 - projectedX2) > 0.99 * rowToRow) {
                 // Use average value if projection approximates the rtr
-                actualGroundGHI = std::accumulate(rearGroundGHI.begin(), rearGroundGHI.end(), 0.) / rearGroundGHI.size();
-                reflectedGroundGHI = actualGroundGHI * std::accumulate(albedoAligned.begin(), albedoAligned.end(), 0.) / albedoAligned.size();
+                actualGroundGHI = averageRearGroundGHI;
+                reflectedGroundGHI = actualGroundGHI * averageAlbedoAligned;
             }
             else {
                 projectedX1 = intervals * projectedX1 / rowToRow;
@@ -2996,6 +3103,28 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
     }
 }
 
+const std::vector<double>& irrad::getAlignedAlbedos(size_t intervals, double horizontalLength, double rowToRow) {
+    // the alignment only depends on the sign of the rotation for one-axis trackers
+    double geometry[4] = { (double)trackingMode, (trackingMode == 1 && surfaceAnglesRadians[3] > 0.) ? 1. : 0.,
+                           horizontalLength, rowToRow };
+    if (albedoAligned.size() == intervals && albedoSpatial == albedoAlignedSource
+        && std::equal(geometry, geometry + 4, albedoAlignedGeometry)) {
+        return albedoAligned;
+    }
+
+    if (trackingMode == 0 || trackingMode == 1 || trackingMode == 4) {          // 0=fixed, 1=one-axis, 4=seasonal tilt
+        // subdivide spatial albedos to match ground GHI length and align reference point at front of row
+        albedoAligned = divideAndAlignAlbedos(albedoSpatial, intervals, trackingMode == 1, horizontalLength, rowToRow, surfaceAnglesRadians[3]);
+    }
+    else {
+        double average_albedo = std::accumulate(albedoSpatial.begin(), albedoSpatial.end(), 0.) / albedoSpatial.size();
+        albedoAligned.assign(intervals, average_albedo);
+    }
+    albedoAlignedSource = albedoSpatial;
+    std::copy(geometry, geometry + 4, albedoAlignedGeometry);
+    return albedoAligned;
+}
+
 double shadeFraction1x(double solar_azimuth, double solar_zenith,
                        double axis_tilt, double axis_azimuth,
                        double gcr, double rotation, double slope_tilt, double slope_azimuth) {
@@ -3471,9 +3600,8 @@ ModifiedDISC(const double g[3], const double z[3], double td, double alt, int do
     double ktbin[5] = {0.24, 0.4, 0.56, 0.7, 0.8};
     double zbin[5] = {25.0, 40.0, 55.0, 70.0, 80.0};
     double dktbin[5] = {0.015, 0.035, 0.07, 0.15, 0.3};
-    double wbin[3] = {1.0, 2.0, 3.0};
     double rtod = 57.295779513082316;
-    double a, b, c, w, knc, bmax, dkt1, io;
+    double a, b, c, knc, bmax, dkt1, io;
 
     //double dn = 0.0;
     if (g[1] >= 1.0 && cos(z[1]) > 0.0) {   // Model only if present global >= 1 and present zenith < 90 deg
@@ -3535,14 +3663,7 @@ ModifiedDISC(const double g[3], const double z[3], double td, double alt, int do
         //while (j < 4 && zenith[1] >= zbin[j])
         while (j < 5 && zenith[1] >= zbin[j])       // Error fix 4/14/2015
             j++;
-        if (td < -998.0)
-            l = 4;  // l = letter "l'
-        else {
-            w = exp(-0.075 + 0.07 * td);
-            l = 0;
-            while (l < 3 && w >= wbin[l])
-                l++;
-        }
+        l = dirint_water_bin(td);  // l = letter "l'
         dn = bmax * cm[i][j][k][l];
         // dn = Max(0.0, dn); //jmf removed 11/30/18 to allow error to be reported by poaDecomp if calculated dn is negative
     }   // End of if present global >= 1
@@ -3561,9 +3682,8 @@ ModifiedDISC(const double kt[3], const double kt1[3], const double g[3], const d
     double ktbin[5] = {0.24, 0.4, 0.56, 0.7, 0.8};
     double zbin[5] = {25.0, 40.0, 55.0, 70.0, 80.0};
     double dktbin[5] = {0.015, 0.035, 0.07, 0.15, 0.3};
-    double wbin[3] = {1.0, 2.0, 3.0};
     double rtod = 57.295779513082316;
-    double a, b, c, w, knc, bmax, dkt1, io;
+    double a, b, c, knc, bmax, dkt1, io;
 
     //double dn = 0.0;
     if (g[1] >= 1.0 && cos(z[1]) > 0.0) {   // Model only if present global >= 1 and present zenith < 90 deg
@@ -3618,14 +3738,7 @@ ModifiedDISC(const double kt[3], const double kt1[3], const double g[3], const d
         //while (j < 4 && zenith[1] >= zbin[j])
         while (j < 5 && zenith[1] >= zbin[j])       // Error fix 4/14/2015
             j++;
-        if (td < -998.0)
-            l = 4;  // l = letter "l'
-        else {
-            w = exp(-0.075 + 0.07 * td);
-            l = 0;
-            while (l < 3 && w >= wbin[l])
-                l++;
-        }
+        l = dirint_water_bin(td);  // l = letter "l'
 
         dn = bmax * cm[i][j][k][l];
         // dn = Max(0.0, bmax * cm[i][j][k][l]); //jmf removed 11/30/18 to allow error to be reported by poaDecomp if calculated dn is negative
@@ -1034,6 +1034,26 @@ protected:
     std::vector<double> planeOfArrayIrradianceRearSpatial;  ///< Spatial rear side plane-of-array irradiance (W/m2), where index 0 is at row bottom
     std::vector<double> groundIrradianceSpatial;            ///< Spatial irradiance incident on the ground in between rows, where index 0 is towards front of array
 
+    // Rear-side scratch buffers, reused across time steps so calc_rear_side() does not allocate once warmed up
+    std::vector<double> rearSkyConfigFactors;       ///< Sky configuration factors of the ground segments behind the row
+    std::vector<double> frontSkyConfigFactors;      ///< Sky configuration factors of the ground segments in front of the row
+    std::vector<int> rearGroundShade;               ///< Beam shade flags of the ground segments behind the row
+    std::vector<int> frontGroundShade;              ///< Beam shade flags of the ground segments in front of the row
+    std::vector<double> rearGroundGHI;              ///< Irradiance on the ground segments behind the row (W/m2)
+    std::vector<double> frontGroundGHI;             ///< Irradiance on the ground segments in front of the row (W/m2)
+    std::vector<double> frontIrradiancePerCellrow;  ///< Front-side irradiance per cell row (W/m2)
+    std::vector<double> frontReflectedPerCellrow;   ///< Irradiance reflected off the front side per cell row (W/m2)
+    std::vector<double> rearIrradiancePerCellrow;   ///< Rear-side irradiance per cell row (W/m2)
+
+    // Geometry caches for the rear-side calculation
+    double skyConfigGeometry[5];                    ///< Row geometry the cached sky configuration factors were computed for
+    std::vector<double> albedoAligned;              ///< Spatial albedos subdivided and aligned to the ground segments
+    std::vector<double> albedoAlignedSource;        ///< Spatial albedos the cached aligned albedos were computed from
+    double albedoAlignedGeometry[4];                ///< Tracking mode, rotation sign, horizontal length and row-to-row of the cached aligned albedos
+
+    /// Return the spatial albedos aligned to the ground segments, recomputed only when the albedos or row geometry change
+    const std::vector<double>& getAlignedAlbedos(size_t intervals, double horizontalLength, double rowToRow);
+
 public:
 
     /// Directive to indicate that if delt_hr is less than zero, do not interpolate sunrise and sunset hours
@@ -1105,6 +1125,12 @@ public:
     /// Run the irradiance processor and calculate the plane-of-array irradiance and diffuse components of irradiance
     int calc();
 
+    /// Calculate only the sun position for the current time step, which does not depend on the surface
+    int calc_sun();
+
+    /// Calculate surface angles and plane-of-array irradiance from the sun position of the last calc_sun(), so one sun position can serve several surfaces
+    int calc_surface();
+
     /// Run the irradiance processor for the rear-side of the surface to calculate rear-side plane-of-array irradiance
     int calc_rear_side(double transmissionFactor, double groundClearanceHeight, double slopeLength);
 
@@ -1184,13 +1210,13 @@ public:
     void getGroundShadeFactors(double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, double solarAzimuthRadians, double solarElevationRadians, std::vector<int>& rearGroundFactors, std::vector<int>& frontGroundFactors, double& maxShadow, double& pvBackShadeFraction, double& pvFrontShadeFraction);
 
     /// Return the ground global-horizonal irradiance, used by \link calc_rear_side()
-    void getGroundGHI(double transmissionFactor, std::vector<double> rearSkyConfigFactors, std::vector<double> frontSkyConfigFactors, std::vector<int> rearGroundShadeFactors, std::vector<int> frontGroundShadeFactors, std::vector<double>& rearGroundGHI, std::vector<double>& frontGroundGHI);
+    void getGroundGHI(double transmissionFactor, const std::vector<double>& rearSkyConfigFactors, const std::vector<double>& frontSkyConfigFactors, const std::vector<int>& rearGroundShadeFactors, const std::vector<int>& frontGroundShadeFactors, std::vector<double>& rearGroundGHI, std::vector<double>& frontGroundGHI);
 
     /// Return the back surface irradiances, used by \link calc_rear_side()
-    void getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> rearGroundGHI, std::vector<double> frontGroundGHI, std::vector<double> frontReflected, std::vector<double>& rearIrradiance, double& rearAverageIrradiance);
+    void getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double>& rearGroundGHI, const std::vector<double>& frontGroundGHI, const std::vector<double>& frontReflected, std::vector<double>& rearIrradiance, double& rearAverageIrradiance);
 
     /// Return the front surface irradiances, used by \link calc_rear_side()
-    void getFrontSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> frontGroundGHI, std::vector<double>& frontIrradiance, double& frontAverageIrradiance, std::vector<double>& frontReflected);
+    void getFrontSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double>& frontGroundGHI, std::vector<double>& frontIrradiance, double& frontAverageIrradiance, std::vector<double>& frontReflected);
 
     enum RADMODE { DN_DF, DN_GH, GH_DF, POA_R, POA_P };
     enum SKYMODEL { ISOTROPIC, HDKR, PEREZ };
@@ -1199,8 +1225,18 @@ public:
 };
 
 // allow for the poa decomp model to take all daily POA measurements into consideration
+// half-day average Kt' used when the sun is behind the array, reused by every such step of that half day
+struct poaKtpMemo {
+    poaKtpMemo() : start(0), stop(0), doy(-1), waterBin(-1), alb(0), avgKtp(0) {}
+    size_t start, stop; // half-day bounds the average was taken over, invalid when stop <= start
+    int doy;
+    int waterBin; // DIRINT precipitable water bin, the only way the dew point enters the average
+    double alb;
+    double avgKtp;
+};
+
 struct poaDecompReq {
-    poaDecompReq() : i(0), dayStart(0), stepSize(1), stepScale('h'), doy(-1) {}
+    poaDecompReq() : i(0), dayStart(0), stepSize(1), stepScale('h'), tDew(0), doy(-1), elev(0) {}
     size_t i; // Current time index
     size_t dayStart; // time index corresponding to the start of the current day
     double stepSize;
@@ -1213,6 +1249,29 @@ struct poaDecompReq {
     double tDew;
     int doy;
     double elev;
+    poaKtpMemo ktpMemo;
+
+    size_t stepsInDay() const;
+};
+
+/**
+* poa_decomp_batch_t decomposes a whole series of plane-of-array irradiance into direct normal, diffuse horizontal and
+* global horizontal irradiance with the same model as poaDecomp. Days are independent and are spread across threads,
+* each reusing its half-day Kt' averages; day d of the series uses day of year d, as pvsamv1 does.
+*/
+class poa_decomp_batch_t {
+public:
+    poaDecompReq data;              ///< POA, incidence, tilt, zenith and extraterrestrial arrays (radians), elevation and time step
+    std::vector<double> tDew;       ///< dew point temperature per step (C)
+    std::vector<double> albedo;     ///< albedo per step, or one value for every step
+
+    // results, sized by calculate()
+    std::vector<double> dn, df, gh;                 ///< decomposed irradiance (W/m2)
+    std::vector<double> poaBeam, poaSky, poaGround; ///< modeled plane-of-array components (W/m2)
+    std::vector<int> errorcode;                     ///< poaDecomp error code per step, 0 when the sun is down
+
+    // nthreads <= 0 uses all hardware threads; returns the number of steps without an error code, 0 if inputs are inconsistent
+    size_t calculate(int nthreads = 0);
 };
 
 #endif
@@ -44,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <math.h>
 #include <cmath>
+#include <set>
 
 #include "lib_mlmodel.h"
 // #include "mlm_spline.h"
@@ -72,6 +73,8 @@ static const int AM_MODE_SANDIA = 2;
 static const int AM_MODE_DESOTO = 3;
 static const int AM_MODE_LEE_PANCHULA = 4;
 
+static const int IAM_TABLE_LENGTH = 1025;
+
 mlmodel_module_t::mlmodel_module_t()
           {
 	m_bspline3 = BSpline(1);
@@ -81,6 +84,8 @@ mlmodel_module_t::mlmodel_module_t()
 		= T_c_fa_alpha = T_c_fa_U0 = T_c_fa_U1
 		= groundRelfectionFraction = std::numeric_limits<double>::quiet_NaN();
 
+	IAM_c_cs_useTable = true;
+
 	nVT = I_0ref = I_Lref = Vbi = 0;
 	N_series = N_parallel = N_diodes = 0;
 
@@ -135,11 +140,38 @@ void mlmodel_module_t::initializeManual()
 			}
 			m_bspline3 = BSpline::Builder(samples).degree(3).build();
 
+			// sample the spline once so that the IAM does not need to evaluate it every time step
+			m_iamTable.clear();
+			std::set<double> angles = samples.getGrid()[0];
+			double theta_lo = *angles.begin();
+			double theta_hi = *angles.rbegin();
+			if (IAM_c_cs_useTable && theta_hi > theta_lo)
+			{
+				std::vector<double> iamSamples(IAM_TABLE_LENGTH), iamSlopes(IAM_TABLE_LENGTH);
+				DenseVector x(1);
+				for (int i = 0; i < IAM_TABLE_LENGTH; i++)
+				{
+					x(0) = (i == IAM_TABLE_LENGTH - 1) ? theta_hi : theta_lo + i * (theta_hi - theta_lo) / (IAM_TABLE_LENGTH - 1);
+					iamSamples[i] = m_bspline3.eval(x);
+					iamSlopes[i] = m_bspline3.evalJacobian(x)(0, 0);
+				}
+				m_iamTable.init(theta_lo, theta_hi, iamSamples, iamSlopes);
+			}
+
 			isInitialized = true;
 		}
 	}
 }
 
+double mlmodel_module_t::IAMvalue_spline(double theta)
+{
+	if (m_iamTable.in_range(theta))
+		return m_iamTable.eval(theta);
+	DenseVector x(1);
+	x(0) = theta;
+	return m_bspline3.eval(x);
+}
+
 // Main module model
 bool mlmodel_module_t::operator() (pvinput_t &input, double T_C, double opvoltage, pvoutput_t &out)
 {
@@ -168,13 +200,9 @@ bool mlmodel_module_t::operator() (pvinput_t &input, double T_C, double opvoltag
 //			f_IAM_beam = std::min(iamSpline(theta_beam), 1.0);
 //			f_IAM_diff = std::min(iamSpline(theta_diff), 1.0);
 //			f_IAM_gnd = std::min(iamSpline(theta_gnd), 1.0);
-			DenseVector x(1);
-			x(0) = theta_beam;
-			f_IAM_beam = std::min(m_bspline3.eval(x), 1.0);
-			x(0) = theta_diff;
-			f_IAM_diff = std::min(m_bspline3.eval(x), 1.0);
-			x(0) = theta_gnd;
-			f_IAM_gnd = std::min(m_bspline3.eval(x), 1.0);
+			f_IAM_beam = std::min(IAMvalue_spline(theta_beam), 1.0);
+			f_IAM_diff = std::min(IAMvalue_spline(theta_diff), 1.0);
+			f_IAM_gnd = std::min(IAMvalue_spline(theta_gnd), 1.0);
 			break;
 	}
 
@@ -38,6 +38,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "lib_pvmodel.h"
 //#include "mlm_spline.h"
 #include "bspline.h"
+#include "lib_util.h"
 
 using namespace SPLINTER;
 
@@ -89,6 +90,7 @@ public:
 	int IAM_c_cs_elements;
 	double IAM_c_cs_incAngle[100];
 	double IAM_c_cs_iamValue[100];
+	bool IAM_c_cs_useTable; // evaluate the IAM spline from a precomputed uniform table instead of the B-spline
 
 	double groundRelfectionFraction;
 
@@ -102,6 +104,8 @@ public:
 	virtual bool operator() (pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output);
 	virtual void initializeManual();
 
+	double IAMvalue_spline(double theta);
+
 private:
 	bool isInitialized;
 	double nVT;
@@ -110,7 +114,7 @@ private:
 	double Vbi;
 //	tk::spline iamSpline;
 	BSpline m_bspline3;
-
+	util::uniform_cubic_table m_iamTable;
 };
 
 class mock_celltemp_t : public pvcelltemp_t
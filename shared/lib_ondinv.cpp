@@ -48,6 +48,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 const int TEMP_DERATE_ARRAY_LENGTH = 6;
+const int EFF_TABLE_LENGTH = 1025;
 // test commit
 
 ond_inverter::ond_inverter()
@@ -58,7 +59,7 @@ ond_inverter::ond_inverter()
 	ModeOper = CompPMax = CompVMax = ModeAffEnum = "";
 	NbInputs = NbMPPT = 0;
 	ondIsInitialized = false;
-	doAllowOverpower = doUseTemperatureLimit = true;
+	doAllowOverpower = doUseTemperatureLimit = doUseEfficiencyTable = true;
 }
 
 // Initialize - Calculates values that only need calculation once
@@ -280,6 +281,20 @@ void ond_inverter::initializeManual()
 			}
 			m_bspline3[j] = BSpline::Builder(samples).degree(3).build();
 
+			// sample the spline once so that calcEfficiency does not need to evaluate it every time step
+			m_effTable[j].clear();
+			if (doUseEfficiencyTable && x_max[j] > ondspl_X.front())
+			{
+				std::vector<double> effSamples(EFF_TABLE_LENGTH), effSlopes(EFF_TABLE_LENGTH);
+				double dx = (x_max[j] - ondspl_X.front()) / (EFF_TABLE_LENGTH - 1);
+				for (int k = 0; k < EFF_TABLE_LENGTH; k++)
+				{
+					xSamples(0) = (k == EFF_TABLE_LENGTH - 1) ? x_max[j] : ondspl_X.front() + k * dx;
+					effSamples[k] = m_bspline3[j].eval(xSamples);
+					effSlopes[k] = m_bspline3[j].evalJacobian(xSamples)(0, 0);
+				}
+				m_effTable[j].init(ondspl_X.front(), x_max[j], effSamples, effSlopes);
+			}
 		}
 		ondIsInitialized = true;
 	}
@@ -288,7 +303,6 @@ void ond_inverter::initializeManual()
 double ond_inverter::calcEfficiency(double Pdc, int index_eta) {
 	double eta;
 //	int splineIndex;
-	DenseVector x(1);
 //	if (Pdc > (Pdc_threshold * PNomDC_eff)) {
 //		splineIndex = 1;
 //	}
@@ -309,8 +323,16 @@ double ond_inverter::calcEfficiency(double Pdc, int index_eta) {
 	else if (Pdc >= x_lim[index_eta]) 
 	{
 //		eta = effSpline[splineIndex][index_eta](Pdc);
-		x(0) = Pdc;
-		eta = (m_bspline3[index_eta]).eval(x);
+		if (m_effTable[index_eta].in_range(Pdc))
+		{
+			eta = m_effTable[index_eta].eval(Pdc);
+		}
+		else
+		{
+			DenseVector x(1);
+			x(0) = Pdc;
+			eta = (m_bspline3[index_eta]).eval(x);
+		}
 	}
 	else 
 	{
@@ -36,6 +36,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 //#include "mlm_spline.h" // spline interpolator for efficiency curves
 #include "bspline.h"
+#include "lib_util.h"
 using namespace std;
 using namespace SPLINTER;
 
@@ -82,6 +83,7 @@ public:
 	double effCurve_eta[3][100]; // [-]
 	int doAllowOverpower; // [-] // ADDED TO CONSIDER MAX POWER USAGE [2018-06-23, TR]
 	int doUseTemperatureLimit; // [-] // ADDED TO CONSIDER TEMPERATURE LIMIT USAGE [2018-06-23, TR]
+	int doUseEfficiencyTable; // [-] // evaluate efficiency splines from a precomputed uniform table instead of the B-spline
 
 	bool acpower(	
 		/* inputs */
@@ -118,6 +120,7 @@ private:
 //	tk::spline effSpline[2][3];
 //	BSpline m_bspline3[2][3];
 	BSpline m_bspline3[3];
+	util::uniform_cubic_table m_effTable[3];
 	double x_max[3];
 	double x_lim[3];
 	double Pdc_threshold;
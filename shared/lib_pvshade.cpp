@@ -288,13 +288,49 @@ void selfshade_xs_horstr(bool landscape,
 	}
 }
 
-// Accessor for sky diffuse derates for the given surface_tilt. If the value doesn't exist in the table, it is computed.
+void sssky_diffuse_table::init(double surface_tilt, double groundCoverageRatio) {
+    gcr = groundCoverageRatio;
+    derates_grid.assign(180 * grid_per_degree + 1, std::numeric_limits<double>::quiet_NaN());
+    init_tilt = surface_tilt;
+    init_derate = compute(surface_tilt);
+}
+
+double sssky_diffuse_table::grid_value(size_t i) {
+    if (std::isnan(derates_grid[i]))
+        derates_grid[i] = compute((double)i / grid_per_degree);
+    return derates_grid[i];
+}
+
+// Accessor for sky diffuse derates for the given surface_tilt. Grid nodes that don't exist in the table yet are computed.
 double sssky_diffuse_table::lookup(double surface_tilt) {
-    char buf[8];
-    sprintf(buf, "%.3f", surface_tilt);
-    if (derates_table.find(buf) != derates_table.end())
-        return derates_table[buf];
-    return compute(surface_tilt);
+    if (surface_tilt == init_tilt)
+        return init_derate;
+    if (derates_grid.empty())
+        derates_grid.assign(180 * grid_per_degree + 1, std::numeric_limits<double>::quiet_NaN());
+
+    double x = surface_tilt * grid_per_degree;
+    if (!(x >= 0 && x <= 180 * grid_per_degree))
+        return compute(surface_tilt);
+    size_t i = (size_t)x;
+    double frac = x - i;
+    if (frac == 0 || i + 1 >= derates_grid.size())
+        return grid_value(i);
+    if (i == 0 || i + 2 >= derates_grid.size())
+        return grid_value(i) * (1 - frac) + grid_value(i + 1) * frac;
+
+    // cubic Lagrange interpolation through the two nodes on either side. The derate has a kink at 90 degrees, where
+    // the shaded sky angle changes branch, so the four nodes are shifted to stay on the side of the tilt
+    size_t kink = 90 * grid_per_degree;
+    size_t start = i - 1;
+    if (i < kink && i + 2 > kink)
+        start = kink - 3;
+    else if (i >= kink && i - 1 < kink)
+        start = kink;
+    double u = x - start;
+    return -(u - 1) * (u - 2) * (u - 3) / 6 * grid_value(start)
+        + u * (u - 2) * (u - 3) / 2 * grid_value(start + 1)
+        - u * (u - 1) * (u - 3) / 2 * grid_value(start + 2)
+        + u * (u - 1) * (u - 2) / 6 * grid_value(start + 3);
 }
 
 double sssky_diffuse_table::compute(double surface_tilt) {
@@ -330,9 +366,6 @@ double sssky_diffuse_table::compute(double surface_tilt) {
         else {}
         skydiff += (Asky_shade[n] / Asky) * step;
     }
-    char buf[8];
-    sprintf(buf, "%.3f", surface_tilt);
-    derates_table[buf] = skydiff;
     return skydiff;
 }
 
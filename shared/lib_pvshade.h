@@ -34,8 +34,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __pvshade_h
 #define __pvshade_h
 
-#include <string>
-#include <unordered_map>
+#include <limits>
+#include <vector>
 #include "lib_util.h"
 
 
@@ -71,21 +71,30 @@ struct ssoutputs	// self-shading outputs
 
 // look up table for calculating the diffuse reduction due to gcr and tilt of the panels for self-shading
 // added to removing duplicate computations for speed up (https://github.com/NREL/ssc/issues/384)
+// derates are stored on a dense tilt grid for the table's gcr, each node computed on first use, and cubic
+// interpolated between nodes; the initial tilt (the only tilt for fixed arrays) is stored exactly
 class sssky_diffuse_table
 {
-    std::unordered_map<std::string, double> derates_table;      // stores pairs of surface tilts and derates
+    std::vector<double> derates_grid;                           // derates at every 1/grid_per_degree degrees of tilt from 0 to 180, NaN until computed
+    double init_tilt;                                           // starting surface tilt
+    double init_derate;                                         // derate at the starting surface tilt
     double gcr;                                                 // 0.01 - 0.99
 
-    double compute(double surface_tilt);
+    double grid_value(size_t i);
 
 public:
-    sssky_diffuse_table(): gcr(0) {}
+    static const int grid_per_degree = 10;                      // 0.1 degree tilt resolution
+
+    sssky_diffuse_table(): init_tilt(std::numeric_limits<double>::quiet_NaN()), init_derate(0), gcr(0) {}
 
     // initialize with the ground coverage ratio (fixed per PV simulation) and the starting tilt
-    void init(double surface_tilt, double groundCoverageRatio) { gcr = groundCoverageRatio; compute(surface_tilt); }
+    void init(double surface_tilt, double groundCoverageRatio);
 
     // return the sky diffuse derate for the panel at given surface_tilt
     double lookup(double surface_tilt);
+
+    // integrate the sky diffuse derate for the panel at given surface_tilt without the table
+    double compute(double surface_tilt);
 };
 
 
@@ -43,6 +43,29 @@ dispatch_resilience::dispatch_resilience(const dispatch_t &orig, size_t start_in
     current_outage_index = start_outage_index;
     met_loads_kw = 0;
 
+    init_outage(orig);
+}
+
+dispatch_resilience::~dispatch_resilience() {
+	delete_clone();
+	_Battery_initial = nullptr;
+}
+
+void dispatch_resilience::restart(const dispatch_t &orig, size_t start_index) {
+    // copy rebuilds the power flow after init, so init again to set up the limits as the copy constructor does
+    dispatch_t::copy(&orig);
+    init(_Battery, _dt_hour, _current_choice, _t_min, _mode);
+    start_outage_index = start_index;
+    current_outage_index = start_outage_index;
+    met_loads_kw = 0;
+
+    init_outage(orig);
+}
+
+void dispatch_resilience::init_outage(const dispatch_t &orig) {
+    if (inverter)
+        m_batteryPower->setSharedInverter(inverter.get());
+
     m_batteryPower->canClipCharge = true;
     m_batteryPower->canSystemCharge = true;
     m_batteryPower->canGridCharge = false;
@@ -54,11 +77,6 @@ dispatch_resilience::dispatch_resilience(const dispatch_t &orig, size_t start_in
     m_batteryPower->stateOfChargeMax = 100;
 }
 
-dispatch_resilience::~dispatch_resilience() {
-	delete_clone();
-	_Battery_initial = nullptr;
-}
-
 bool dispatch_resilience::run_outage_step_ac(double crit_load_kwac, double pv_kwac){
     if (connection != CONNECTION::AC_CONNECTED)
         throw std::runtime_error("Error in resilience::run_outage_step_ac: called for battery with DC connection.");
@@ -115,7 +133,19 @@ double dispatch_resilience::get_met_loads(){
     return met_loads_kw;
 }
 
-resilience_runner::resilience_runner(const std::shared_ptr<battstor>& battery)
+size_t dispatch_resilience::get_start_index() {
+    return start_outage_index;
+}
+
+SharedInverter* dispatch_resilience::get_inverter() {
+    return inverter.get();
+}
+
+resilience_runner::resilience_runner(const std::shared_ptr<battstor>& battery, size_t outage_start_interval,
+                                     size_t n_threads) :
+        shared_inverter(nullptr),
+        outage_start_interval(std::max(outage_start_interval, (size_t)1)),
+        n_threads(n_threads)
 {
     batt = battery;
     size_t steps_lifetime = batt->step_per_hour * batt->nyears * 8760;
@@ -124,10 +154,29 @@ resilience_runner::resilience_runner(const std::shared_ptr<battstor>& battery)
 }
 
 void resilience_runner::add_battery_at_outage_timestep(const dispatch_t& orig, size_t index){
-    if (battery_per_outage_start.find(index) != battery_per_outage_start.end())
+    if (index % outage_start_interval != 0)
+        return;
+
+    // outages are usually started in order, so this is almost always an append
+    auto pos = std::lower_bound(surviving_batteries.begin(), surviving_batteries.end(), index,
+                                [](const std::unique_ptr<dispatch_resilience>& b, size_t i) { return b->get_start_index() < i; });
+    if (pos != surviving_batteries.end() && (*pos)->get_start_index() == index) {
         logs.emplace_back(
                 "Replacing battery which already existed at index " + to_string(index) + ".");
-    battery_per_outage_start.insert({index, std::make_shared<dispatch_resilience>(orig, index)});
+        return;
+    }
+
+    std::unique_ptr<dispatch_resilience> batt_system;
+    if (battery_pool.empty())
+        batt_system = std::unique_ptr<dispatch_resilience>(new dispatch_resilience(orig, index));
+    else {
+        batt_system = std::move(battery_pool.back());
+        battery_pool.pop_back();
+        batt_system->restart(orig, index);
+    }
+    if (batt_system->connection == dispatch_resilience::DC_CONNECTED)
+        shared_inverter = orig.getBatteryPower()->sharedInverter;
+    surviving_batteries.insert(pos, std::move(batt_system));
 }
 
 void resilience_runner::run_surviving_batteries(double crit_loads_kwac, double pv_kwac, double pv_kwdc, double V,
@@ -138,26 +187,40 @@ void resilience_runner::run_surviving_batteries(double crit_loads_kwac, double p
                     "For DC-connected battery, maximum inverter AC Power less than max load will lead to dropped load.");
     }
 
-    std::vector<size_t> depleted_battery_keys;
-    for (auto& i : battery_per_outage_start){
-        size_t start_index = i.first;
-        auto batt_system = i.second;
-        bool survived;
+    size_t n_batteries = surviving_batteries.size();
+    if (n_batteries == 0)
+        return;
+    survived_step.resize(n_batteries);
+
+    // only split the step when each thread has enough batteries to cover the cost of starting it
+    const size_t min_batteries_per_thread = 32;
+    int n_workers = util::thread_count((int)n_threads, n_batteries / min_batteries_per_thread);
+    util::parallel_for(n_batteries, n_workers, [&](size_t i, int) {
+        auto& batt_system = surviving_batteries[i];
         if (batt_system->connection == dispatch_resilience::DC_CONNECTED)
-            survived = batt_system->run_outage_step_dc(crit_loads_kwac, pv_kwdc, V, pv_clipped_kw, tdry_c);
+            survived_step[i] = batt_system->run_outage_step_dc(crit_loads_kwac, pv_kwdc, V, pv_clipped_kw, tdry_c);
         else
-            survived = batt_system->run_outage_step_ac(crit_loads_kwac, pv_kwac);
-        if (!survived){
-            depleted_battery_keys.emplace_back(start_index);
+            survived_step[i] = batt_system->run_outage_step_ac(crit_loads_kwac, pv_kwac);
+    });
+
+    // the original system's inverter is left as if the outages had been stepped through it in order
+    if (shared_inverter && surviving_batteries.back()->get_inverter())
+        *shared_inverter = *surviving_batteries.back()->get_inverter();
+
+    // record depleted batteries and return them to the pool, keeping the survivors in order
+    size_t n_surviving = 0;
+    for (size_t i = 0; i < n_batteries; i++) {
+        auto& batt_system = surviving_batteries[i];
+        if (!survived_step[i]) {
+            size_t start_index = batt_system->get_start_index();
             indices_survived[start_index] = batt_system->get_indices_survived();
+            total_load_met[start_index] = batt_system->get_met_loads();
+            battery_pool.emplace_back(std::move(batt_system));
         }
+        else
+            surviving_batteries[n_surviving++] = std::move(batt_system);
     }
-    for (auto& i : depleted_battery_keys){
-        auto b = battery_per_outage_start[i];
-        indices_survived[i] = b->get_indices_survived();
-        total_load_met[i] = b->get_met_loads();
-        battery_per_outage_start.erase(i);
-    }
+    surviving_batteries.resize(n_surviving);
 }
 
 // crit loads and tdry are single year; pv, V, clipped are lifetime arrays
@@ -174,15 +237,27 @@ void resilience_runner::run_surviving_batteries_by_looping(double* crit_loads_kw
         i++;
     }
 
-    if (battery_per_outage_start.empty())
-        return;
+    if (!surviving_batteries.empty()) {
+        double total_load = std::accumulate(crit_loads_kwac, crit_loads_kwac + nrec, 0.0) * batt->nyears;
+        for (auto& b : surviving_batteries) {
+            indices_survived[b->get_start_index()] = steps_lifetime;
+            total_load_met[b->get_start_index()] = total_load;
+            battery_pool.emplace_back(std::move(b));
+        }
+        surviving_batteries.clear();
+    }
+
+    fill_unsampled_outage_starts();
+}
 
-    double total_load = std::accumulate(crit_loads_kwac, crit_loads_kwac + nrec, 0.0) * batt->nyears;
-    for (auto& b : battery_per_outage_start){
-        indices_survived[b.first] = steps_lifetime;
-        total_load_met[b.first] = total_load;
+void resilience_runner::fill_unsampled_outage_starts() {
+    if (outage_start_interval <= 1)
+        return;
+    for (size_t i = 0; i < indices_survived.size(); i++) {
+        size_t sampled = i - i % outage_start_interval;
+        indices_survived[i] = indices_survived[sampled];
+        total_load_met[i] = total_load_met[sampled];
     }
-    battery_per_outage_start.clear();
 }
 
 // return average hours survived
@@ -191,20 +266,24 @@ double resilience_runner::compute_metrics(){
     probs_of_surviving.clear();
 
     double hrs_total = (double)batt->step_per_hour * 8760. * (double)batt->nyears;
-    outage_durations = std::vector<double>(indices_survived.begin(), indices_survived.end());;
-    std::sort(outage_durations.begin(), outage_durations.end());
-    outage_durations.erase(unique(outage_durations.begin(), outage_durations.end()), outage_durations.end());
-    for (auto& i : outage_durations){
-        double prob = std::count(indices_survived.begin(), indices_survived.end(), i) / hrs_total;
-        i /= batt->step_per_hour;       // convert to hours
-        probs_of_surviving.emplace_back(prob);
+    std::vector<size_t> sorted_indices(indices_survived);
+    std::sort(sorted_indices.begin(), sorted_indices.end());
+    // count each duration from the run of equal entries in the sorted copy
+    size_t i = 0;
+    while (i < sorted_indices.size()){
+        size_t j = i;
+        while (j < sorted_indices.size() && sorted_indices[j] == sorted_indices[i])
+            j++;
+        outage_durations.emplace_back((double)sorted_indices[i] / batt->step_per_hour);       // convert to hours
+        probs_of_surviving.emplace_back((double)(j - i) / hrs_total);
+        i = j;
     }
 
     return std::accumulate(indices_survived.begin(), indices_survived.end(), 0.0)/batt->step_per_hour/(double)indices_survived.size();
 }
 
 size_t resilience_runner::get_n_surviving_batteries() {
-    return battery_per_outage_start.size();
+    return surviving_batteries.size();
 }
 
 std::vector<double> resilience_runner::get_hours_survived() {
@@ -37,8 +37,11 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <numeric>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "lib_shared_inverter.h"
+#include "lib_util.h"
 #include "lib_battery_dispatch.h"
 #include "lib_battery_powerflow.h"
 #include "../ssc/cmod_battery.h"
@@ -59,6 +62,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 * The start_outage_index is the time step at which the outage starts. Each time one of the run_outage_step functions are
 * run, met_loads_kw is updated and if the battery system meets the critical load, the current_outage_index is incremented.
 *
+* A DC-connected battery runs through its own copy of the inverter so that outages can be stepped on separate threads.
+* Once an outage is over, restart re-initializes the same object for another outage without reallocating the batteries.
+*
 */
 class dispatch_resilience : public dispatch_t {
 public:
@@ -69,6 +75,9 @@ public:
 	/// Delete battery and battery initial
 	~dispatch_resilience();
 
+    /// Reset to the state of a fully-initialized dispatch_t for a new outage starting at start_index
+    void restart(const dispatch_t &orig, size_t start_index);
+
     /// AC or DC connection
     const CONNECTION connection;
 
@@ -84,6 +93,12 @@ public:
     /// Returns the total critical loads met at all survived time steps [kW]
     double get_met_loads();
 
+    /// Returns the time step at which the outage started
+    size_t get_start_index();
+
+    /// Returns the inverter used by a DC-connected battery, nullptr if AC-connected
+    SharedInverter* get_inverter();
+
 protected:
     size_t start_outage_index;
     size_t current_outage_index;
@@ -93,6 +108,9 @@ protected:
     std::unique_ptr<SharedInverter> inverter;
 
     void dispatch(size_t, size_t, size_t) override {}
+
+    /// Set the outage dispatch limits which differ from those of the original dispatch_t
+    void init_outage(const dispatch_t &orig);
 };
 
 /**
@@ -128,6 +146,14 @@ protected:
 *    resilience->run_surviving_batteries_by_looping(&p_crit_load[0], &p_ac[0]);
 *
 *  Provides metrics for the total load met and the time steps survived for each outage.
+*
+*  Surviving outages are kept in a flat array ordered by their starting index, and the dispatch_resilience of a depleted
+*  outage is recycled for the next outage start instead of cloning the battery again. Each outage is independent of the
+*  others given its starting state, so a time step of the surviving outages can be split across n_threads.
+*
+*  With an outage_start_interval of n, an outage is only started at every n-th time step. The survival of the skipped
+*  starts is taken from the most recent sampled start when run_surviving_batteries_by_looping finishes, so the metrics
+*  are estimated at about 1/n of the cost.
 */
 
 class resilience_runner {
@@ -135,8 +161,23 @@ private:
     /// Required for time interval, battery connection and inverter parameters
     std::shared_ptr<battstor> batt;
 
-    /// Outage simulations mapped by the index at which the outage started
-    std::map<size_t, std::shared_ptr<dispatch_resilience>> battery_per_outage_start;
+    /// Outage simulations still running, ordered by the index at which the outage started
+    std::vector<std::unique_ptr<dispatch_resilience>> surviving_batteries;
+
+    /// Outage simulations which have been depleted, kept for reuse by later outage starts
+    std::vector<std::unique_ptr<dispatch_resilience>> battery_pool;
+
+    /// i-th entry is whether the i-th surviving battery met the load in the last step
+    std::vector<char> survived_step;
+
+    /// Inverter of the original system, which is left as it would be after stepping every outage through it
+    SharedInverter* shared_inverter;
+
+    /// Outages are started every outage_start_interval time steps
+    size_t outage_start_interval;
+
+    /// Maximum number of threads used to step the surviving batteries
+    size_t n_threads;
 
     /// i-th entry is the number of time steps survived for an outage starting at time step i
     std::vector<size_t> indices_survived;
@@ -152,13 +193,19 @@ private:
 
     std::vector<std::string> logs;
 
+    /// Copy the results of the most recent sampled outage start to the skipped ones
+    void fill_unsampled_outage_starts();
+
 public:
-    /// Construct from fully-initialized battstor with time interval information
-    explicit resilience_runner(const std::shared_ptr<battstor>& battery);
+    /// Construct from fully-initialized battstor with time interval information. An outage is started every
+    /// outage_start_interval time steps, and up to n_threads threads step the surviving batteries (0 uses all cores)
+    explicit resilience_runner(const std::shared_ptr<battstor>& battery, size_t outage_start_interval = 1,
+                               size_t n_threads = 1);
 
     std::vector<std::string> get_logs() {return logs;}
 
-    /// Adds a battery operating during an outage starting at given index for simulating hours of autonomy
+    /// Adds a battery operating during an outage starting at given index for simulating hours of autonomy,
+    /// unless the index is skipped by the outage start interval
     void add_battery_at_outage_timestep(const dispatch_t& orig, size_t index);
 
     /// Given the crit load and PV production (and string voltage, clipped pv power and temperature for DC-connected),
@@ -32,9 +32,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include <algorithm>
-#include <functional>
+#include <cmath>
 
-#include "6par_newton.h"
 #include "lib_shared_inverter.h"
 #include "lib_util.h"
 
@@ -401,36 +400,104 @@ void SharedInverter::calculateACPower(const std::vector<double> powerDC_kW_in, c
     convertOutputsToKWandScale(tempLoss_avg, powerAC_Watts);
 }
 
-void SharedInverter::solve_kwdc_for_kwac(const double* x, double* f) {
-    calculateACPower(x[0], StringV, Tdry_C);
-    f[0] = powerAC_kW - solver_AC;
-}
-
-using namespace std::placeholders;
-double SharedInverter::calculateRequiredDCPower(const double kwAC, const double DCStringV, double tempC) {
-
-    SharedInverter clone = SharedInverter(*this);
+double SharedInverter::calculateACPowerNoState(const double powerDC_kW_in, const double DCStringVoltage, double tempC, bool applyTempDerate)
+{
+    double P_par, P_lr, eff, clipLoss, consumptionLoss, nightLoss, dcWiringLoss, acWiringLoss;
 
-    // set up solver values
-    clone.StringV = DCStringV;
-    clone.Tdry_C = tempC;
-    clone.solver_AC = kwAC;
+    double powerDC_Watts = powerDC_kW_in * util::kilowatt_to_watt;
+    double powerAC_Watts = 0.0;
+    double tempLoss = 0.0;
+    double power_ratio = 1.0;
+    if (applyTempDerate) {
+        calculateTempDerate(DCStringVoltage, tempC, powerDC_Watts, power_ratio, tempLoss);
+    }
 
-    std::function<void(const double*, double*)> f;
-    f = std::bind(&SharedInverter::solve_kwdc_for_kwac, &clone, _1, _2);
+    if (m_inverterType == SANDIA_INVERTER || m_inverterType == DATASHEET_INVERTER || m_inverterType == COEFFICIENT_GENERATOR)
+        m_sandiaInverter->acpower(powerDC_Watts / m_numInverters, DCStringVoltage, &powerAC_Watts, &P_par, &P_lr, &eff, &clipLoss, &consumptionLoss, &nightLoss);
+    else if (m_inverterType == PARTLOAD_INVERTER)
+        m_partloadInverter->acpower(powerDC_Watts / m_numInverters, &powerAC_Watts, &P_lr, &P_par, &eff, &clipLoss, &nightLoss);
+    else if (m_inverterType == OND_INVERTER)
+        m_ondInverter->acpower(powerDC_Watts / m_numInverters, DCStringVoltage, tempC, &powerAC_Watts, &P_par, &P_lr, &eff, &clipLoss, &consumptionLoss, &nightLoss, &dcWiringLoss, &acWiringLoss);
+    else if (m_inverterType == NONE)
+        powerAC_Watts = powerDC_Watts * NONE_INVERTER_EFF;
 
-    double x[1], resid[1];
-    x[0] = kwAC * 1.04;
-    bool check = false;
+    return powerAC_Watts * m_numInverters * util::watt_to_kilowatt;
+}
 
-    newton<double, std::function<void(const double*, double*)>, 1>(x, resid, check, f,
-        100, 1e-6, 1e-6, 0.7);
+double SharedInverter::calculateRequiredDCPower(const double kwAC, const double DCStringV, double tempC) {
+    // calculateACPower mirrors negative (charging) DC power to negative AC power and skips the temperature derate for it,
+    // so solve for the magnitude and restore the sign afterwards
+    double sign = kwAC < 0 ? -1.0 : 1.0;
+    double target = std::abs(kwAC);
+    bool applyTempDerate = m_tempEnabled && kwAC >= 0;
+
+    // efficiency is at most one, so the required DC power is at least the requested AC power
+    double lo = target;
+    double acLo = calculateACPowerNoState(lo, DCStringV, tempC, applyTempDerate);
+    if (!std::isfinite(acLo))
+        return kwAC;
+    if (acLo >= target)
+        return sign * lo;
+    // if the inverter is not operating at the lower bound, efficiency is too low to produce the requested power
+    if (acLo <= 0)
+        return kwAC;
+
+    // AC power increases with DC power until clipping, so grow the upper bound until it brackets the target
+    const double tol = 1e-6;
+    double below = 0.;
+    double hi = lo * 1.04;
+    double acHi = calculateACPowerNoState(hi, DCStringV, tempC, applyTempDerate);
+    size_t its = 0;
+    while (acHi < target) {
+        // AC power stopped increasing, so the target is above what the inverter can produce. lo reaches the maximum
+        // but may lie anywhere on the clipping plateau, so bisect down to the smallest DC power that reaches it
+        if (!(acHi > acLo) || its++ > 100) {
+            double acMax = acLo;
+            hi = lo;
+            lo = below;
+            while (hi - lo > tol) {
+                double mid = 0.5 * (lo + hi);
+                if (calculateACPowerNoState(mid, DCStringV, tempC, applyTempDerate) >= acMax - tol)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            return sign * hi;
+        }
+        below = lo;
+        lo = hi;
+        acLo = acHi;
+        hi *= 2.0;
+        acHi = calculateACPowerNoState(hi, DCStringV, tempC, applyTempDerate);
+    }
 
-    // if efficiency is too low, the required DC power becomes infinite
-    if (!isfinite(x[0]))
-        x[0] = kwAC;
+    // Illinois variant of regula falsi on the bracket [lo, hi]
+    double fLo = acLo - target;
+    double fHi = acHi - target;
+    double x = hi;
+    int side = 0;
+    for (its = 0; its < 100; its++) {
+        if (fHi - fLo <= 0)
+            break;
+        x = hi - fHi * (hi - lo) / (fHi - fLo);
+        double fx = calculateACPowerNoState(x, DCStringV, tempC, applyTempDerate) - target;
+        if (std::abs(fx) < tol || hi - lo < tol * tol)
+            break;
+        if (fx > 0) {
+            hi = x;
+            fHi = fx;
+            if (side == 1) fLo *= 0.5;
+            side = 1;
+        }
+        else {
+            lo = x;
+            fLo = fx;
+            if (side == -1) fHi *= 0.5;
+            side = -1;
+        }
+    }
 
-    return x[0];
+    return sign * x;
 }
 
 double SharedInverter::getInverterDCNominalVoltage()
@@ -78,6 +78,7 @@ public:
     void calculateACPower(const std::vector<double> powerDC_kW, const std::vector<double> DCStringVoltage, double tempC);
 
     /// Given a target AC power production, calculate the required DC power if possible, otherwise if eff is too low return kwAC. Does not modify state
+    /// If the target is above the maximum (clipped) AC power, return the smallest DC power that reaches the maximum
     double calculateRequiredDCPower(const double kwAC, const double DCStringV, double tempC);
 
     /// Return the nominal DC voltage input
@@ -134,10 +135,8 @@ private:
 
     void convertOutputsToKWandScale(double tempLoss, double powerAC_watts);
 
-    // x[0] is dc power input in kW, x[1] is target ac power output in kW
-    void solve_kwdc_for_kwac(const double* x, double* f);
-
-    double solver_AC;
+    /// Given a non-negative DC power (kW), voltage and ambient T, return the AC power (kW) for all inverters without modifying state
+    double calculateACPowerNoState(const double powerDC_kW_in, const double DCStringVoltage, double tempC, bool applyTempDerate);
 };
 
 
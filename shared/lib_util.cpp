@@ -1148,6 +1148,51 @@ double util::interpolate(double x1, double y1, double x2, double y2, double xVal
 	return (slope*xValueToGetYValueFor) + inter;
 }
 
+int util::thread_count(int nthreads, size_t count)
+{
+	if (nthreads <= 0)
+		nthreads = (int)std::thread::hardware_concurrency();
+	return (int)std::max((size_t)1, std::min((size_t)std::max(nthreads, 1), count));
+}
+
+void util::uniform_cubic_table::init(double x_lo, double x_hi, const std::vector<double> &y)
+{
+	m_y = y;
+	m_m.assign(y.size(), 0.0);
+	m_x0 = x_lo;
+	m_x1 = x_hi;
+	if (y.size() < 2 || x_hi <= x_lo) {
+		clear();
+		return;
+	}
+	size_t n = y.size() - 1;
+	m_invDx = (double)n / (x_hi - x_lo);
+	m_m[0] = y[1] - y[0];
+	m_m[n] = y[n] - y[n - 1];
+	for (size_t i = 1; i < n; i++)
+		m_m[i] = 0.5 * (y[i + 1] - y[i - 1]);
+}
+
+void util::uniform_cubic_table::init(double x_lo, double x_hi, const std::vector<double> &y, const std::vector<double> &dydx)
+{
+	if (dydx.size() != y.size()) {
+		init(x_lo, x_hi, y);
+		return;
+	}
+	m_y = y;
+	m_x0 = x_lo;
+	m_x1 = x_hi;
+	if (y.size() < 2 || x_hi <= x_lo) {
+		clear();
+		return;
+	}
+	double dx = (x_hi - x_lo) / (double)(y.size() - 1);
+	m_invDx = 1. / dx;
+	m_m.resize(y.size());
+	for (size_t i = 0; i < y.size(); i++)
+		m_m[i] = dydx[i] * dx;
+}
+
 double util::linterp_col( const util::matrix_t<double> &mat, size_t ixcol, double xval, size_t iycol )
 {
 	// NOTE:  must assume values in ixcol are in increasing sorted order!!
@@ -39,6 +39,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <cassert>
 #include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 #include <unordered_map>
 
@@ -828,6 +832,91 @@ namespace util
 		}
 	};
 
+	/**
+	* Cubic Hermite interpolation on a uniform grid, for replacing an expensive 1-D curve (e.g. a fitted B-spline)
+	* with O(1) lookups. Node slopes are either supplied or estimated by central differences of the tabulated values.
+	*/
+	class uniform_cubic_table
+	{
+	public:
+		uniform_cubic_table() : m_x0(0), m_x1(0), m_invDx(0) {}
+
+		/// Tabulate y, sampled at y.size() points evenly spaced from x_lo to x_hi inclusive
+		void init(double x_lo, double x_hi, const std::vector<double> &y);
+
+		/// Tabulate y and its derivative dydx, both sampled at y.size() points evenly spaced from x_lo to x_hi inclusive
+		void init(double x_lo, double x_hi, const std::vector<double> &y, const std::vector<double> &dydx);
+
+		void clear() { m_y.clear(); m_m.clear(); }
+
+		bool empty() const { return m_y.size() < 2; }
+
+		bool in_range(double x) const { return !empty() && x >= m_x0 && x <= m_x1; }
+
+		/// Evaluate at x, which must satisfy in_range(x)
+		double eval(double x) const
+		{
+			double u = (x - m_x0) * m_invDx;
+			size_t i = (size_t)u;
+			if (i >= m_y.size() - 1) i = m_y.size() - 2;
+			double t = u - (double)i;
+			double t2 = t * t;
+			double t3 = t2 * t;
+			return (2 * t3 - 3 * t2 + 1) * m_y[i] + (t3 - 2 * t2 + t) * m_m[i]
+				+ (-2 * t3 + 3 * t2) * m_y[i + 1] + (t3 - t2) * m_m[i + 1];
+		}
+
+	private:
+		double m_x0;
+		double m_x1;
+		double m_invDx;
+		std::vector<double> m_y;
+		std::vector<double> m_m;	// node slopes scaled by the grid spacing
+	};
+
+	/// Number of threads to run count tasks on: nthreads <= 0 uses the hardware concurrency, and there are never more threads than tasks
+	int thread_count(int nthreads, size_t count);
+
+	/**
+	* Calls body(i, t) for each task i in [0, count) on thread_count(nthreads, count) threads, where t is the index of the
+	* thread running the task and thread 0 is the caller. Tasks are handed out in order from a shared counter, so per-thread
+	* scratch can be indexed by t. An exception thrown by body stops the remaining tasks from being handed out, and once all
+	* threads have joined the exception from the lowest failed task is rethrown on the caller.
+	*/
+	template <typename Body>
+	void parallel_for(size_t count, int nthreads, Body body)
+	{
+		if (count == 0) return;
+		nthreads = thread_count(nthreads, count);
+
+		std::atomic<size_t> next(0);
+		std::vector<std::exception_ptr> errors(nthreads);
+		std::vector<size_t> failed_task(nthreads, count);
+		auto worker = [&](int t) {
+			size_t i = count;
+			try {
+				while ((i = next++) < count)
+					body(i, t);
+			}
+			catch (...) {
+				errors[t] = std::current_exception();
+				failed_task[t] = i;
+				next = count;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (int t = 1; t < nthreads; t++)
+			threads.emplace_back(worker, t);
+		worker(0);
+		for (auto& thread : threads)
+			thread.join();
+
+		size_t first = std::min_element(failed_task.begin(), failed_task.end()) - failed_task.begin();
+		if (errors[first])
+			std::rethrow_exception(errors[first]);
+	}
+
     template <class T>
     std::vector<std::vector<T>> matrix_to_vector(matrix_t<T> mat_in)
     {
@@ -202,6 +202,22 @@ m_peaks_forecast(tmp.m_peaks_forecast)
 
 UtilityRateForecast::~UtilityRateForecast() {}
 
+void UtilityRateForecast::restoreState(const UtilityRateForecast& tmp)
+{
+    current_composite_sell_rates = tmp.current_composite_sell_rates;
+    current_composite_buy_rates = tmp.current_composite_buy_rates;
+    next_composite_sell_rates = tmp.next_composite_sell_rates;
+    next_composite_buy_rates = tmp.next_composite_buy_rates;
+    last_step = tmp.last_step;
+    last_month_init = tmp.last_month_init;
+
+    // Only the monthly usage and demand results change during forecastCost, schedules and time series rates are left as they are
+    rate->m_month = tmp.rate->m_month;
+    rate->billing_demand = tmp.rate->billing_demand;
+    rate->monthly_dc_fixed = tmp.rate->monthly_dc_fixed;
+    rate->monthly_dc_tou = tmp.rate->monthly_dc_tou;
+}
+
 double UtilityRateForecast::forecastCost(std::vector<double>& predicted_loads, size_t year, size_t hour_of_year, size_t step)
 {
 	double cost = 0;
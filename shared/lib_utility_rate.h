@@ -140,6 +140,12 @@ public:
 
 	~UtilityRateForecast();
 
+    /*
+     * Resets the usage, peaks and composite rates to those of tmp, a copy of this forecast taken earlier. Reuses existing memory,
+     * so repeated what-if forecasts over the same period can share one copy instead of constructing a new one each time
+     */
+    void restoreState(const UtilityRateForecast& tmp);
+
 	/*
     * Returns the increase in cost for the utility bill over the forecast period (length of predicted loads * steps per hour)
     * Loads provided to this function are included in the forecast bill going forward, so if you need to run the same period multiple times, make copies of this class
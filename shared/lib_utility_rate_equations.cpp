@@ -128,6 +128,8 @@ void ur_month::reset()
 rate_data::rate_data() :
 	m_ec_tou_sched(),
 	m_dc_tou_sched(),
+	m_ec_tou_row(),
+	m_dc_tou_row(),
 	m_month(),
 	m_ec_periods(),
 	m_ec_ts_sell_rate(),
@@ -162,6 +164,8 @@ rate_data::rate_data() :
 rate_data::rate_data(const rate_data& tmp) :
 	m_ec_tou_sched(tmp.m_ec_tou_sched),
 	m_dc_tou_sched(tmp.m_dc_tou_sched),
+	m_ec_tou_row(tmp.m_ec_tou_row),
+	m_dc_tou_row(tmp.m_dc_tou_row),
 	m_month(tmp.m_month),
 	m_ec_periods(tmp.m_ec_periods),
 	m_ec_ts_sell_rate(tmp.m_ec_ts_sell_rate),
@@ -223,6 +227,8 @@ void rate_data::init(int num_rec_yearly) {
 	// for reporting purposes
     m_ec_tou_sched = std::vector<int>(m_num_rec_yearly, 1);
     m_dc_tou_sched = std::vector<int>(m_num_rec_yearly, 1);
+    m_ec_tou_row = std::vector<int>(m_num_rec_yearly, -1);
+    m_dc_tou_row = std::vector<int>(m_num_rec_yearly, -1);
     dc_hourly_peak = std::vector<ssc_number_t>(m_num_rec_yearly, 0);
 }
 
@@ -669,6 +675,7 @@ void rate_data::setup_energy_rates(ssc_number_t* ec_weekday, ssc_number_t* ec_we
 			m_month[m].ec_tou_sr_init = m_month[m].ec_tou_sr;
 		}
 	}
+	index_tou_rows(true);
 }
 
 void rate_data::setup_demand_charges(ssc_number_t* dc_weekday, ssc_number_t* dc_weekend, 
@@ -867,6 +874,7 @@ void rate_data::setup_demand_charges(ssc_number_t* dc_weekday, ssc_number_t* dc_
 
 		}
 	}
+	index_tou_rows(false);
 }
 
 void rate_data::setup_ratcheting_demand(ssc_number_t* ratchet_percent_matrix, ssc_number_t* bd_tou_period_matrix)
@@ -890,19 +898,45 @@ void rate_data::setup_ratcheting_demand(ssc_number_t* ratchet_percent_matrix, ss
     }
 }
 
+// Row of period in a month's period list. The row indexed at setup is used when it still matches,
+// which fails only if the month differs from the step's month or ur_month was replaced after setup
+static int find_period_row(const std::vector<int>& periods, int period, int indexed_row) {
+	if (indexed_row >= 0 && indexed_row < (int)periods.size() && periods[indexed_row] == period)
+		return indexed_row;
+	std::vector<int>::const_iterator per_num = std::find(periods.begin(), periods.end(), period);
+	if (per_num == periods.end())
+		return -1;
+	return (int)(per_num - periods.begin());
+}
+
+void rate_data::index_tou_rows(bool energy) {
+	const std::vector<int>& sched = energy ? m_ec_tou_sched : m_dc_tou_sched;
+	std::vector<int>& rows = energy ? m_ec_tou_row : m_dc_tou_row;
+	rows.assign(sched.size(), -1);
+
+	size_t steps_per_hour = m_num_rec_yearly / 8760;
+	size_t c = 0;
+	for (size_t m = 0; m < m_month.size() && m < 12; m++)
+	{
+		const std::vector<int>& periods = energy ? m_month[m].ec_periods : m_month[m].dc_periods;
+		size_t month_end = c + util::nday[m] * 24 * steps_per_hour;
+		for (; c < month_end && c < sched.size(); c++)
+			rows[c] = find_period_row(periods, sched[c], -1);
+	}
+}
+
 void rate_data::sort_energy_to_periods(int month, double energy, size_t step) {
 	// accumulate energy per period - place all in tier 0 initially and then
 	// break up according to tier boundaries and number of periods
 	ur_month& curr_month = m_month[month];
 	int toup = m_ec_tou_sched[step];
-	std::vector<int>::iterator per_num = std::find(curr_month.ec_periods.begin(), curr_month.ec_periods.end(), toup);
-	if (per_num == curr_month.ec_periods.end())
+	int row = find_period_row(curr_month.ec_periods, toup, m_ec_tou_row[step]);
+	if (row < 0)
 	{
 		std::ostringstream ss;
 		ss << "Energy rate TOU Period " << toup << " not found for Month " << util::schedule_int_to_month(month) << ".";
 		throw exec_error("utilityrate5", ss.str());
 	}
-	int row = (int)(per_num - curr_month.ec_periods.begin());
 	// place all in tier 0 initially and then update appropriately
 	// net energy per period per month
 	curr_month.ec_energy_use(row, 0) += energy;
@@ -924,14 +958,13 @@ void rate_data::find_dc_tou_peak(int month, double power, size_t step) {
     if (curr_month.dc_periods.size() > 0)
     {
         int todp = m_dc_tou_sched[step];
-        std::vector<int>::iterator per_num = std::find(curr_month.dc_periods.begin(), curr_month.dc_periods.end(), todp);
-        if (per_num == curr_month.dc_periods.end())
+        int row = find_period_row(curr_month.dc_periods, todp, m_dc_tou_row[step]);
+        if (row < 0)
         {
             std::ostringstream ss;
             ss << "Demand charge Period " << todp << " not found for Month " << month << ".";
             throw exec_error("lib_utility_rate_equations", ss.str());
         }
-        int row = (int)(per_num - curr_month.dc_periods.begin());
         if (power < 0 && power < -curr_month.dc_tou_peak[row])
         {
             curr_month.dc_tou_peak[row] = -power;
@@ -1041,14 +1074,14 @@ int rate_data::get_tou_row(size_t year_one_index, int month)
 	ur_month& curr_month = m_month[month];
 	// find corresponding monthly period
 	// check for valid period
-	std::vector<int>::iterator per_num = std::find(curr_month.ec_periods.begin(), curr_month.ec_periods.end(), period);
-	if (per_num == curr_month.ec_periods.end())
+	int row = find_period_row(curr_month.ec_periods, period, m_ec_tou_row[year_one_index]);
+	if (row < 0)
 	{
 		std::ostringstream ss;
 		ss << "Energy rate Period " << period << " not found for Month " << month << ".";
 		throw exec_error("lib_utility_rate_equations", ss.str());
 	}
-	return (int)(per_num - curr_month.ec_periods.begin());
+	return row;
 }
 
 int rate_data::get_dc_tou_row(size_t year_one_index, int month)
@@ -1057,14 +1090,14 @@ int rate_data::get_dc_tou_row(size_t year_one_index, int month)
     ur_month& curr_month = m_month[month];
     // find corresponding monthly period
     // check for valid period
-    std::vector<int>::iterator per_num = std::find(curr_month.dc_periods.begin(), curr_month.dc_periods.end(), period);
-    if (per_num == curr_month.dc_periods.end())
+    int row = find_period_row(curr_month.dc_periods, period, m_dc_tou_row[year_one_index]);
+    if (row < 0)
     {
         std::ostringstream ss;
         ss << "Demand rate Period " << period << " not found for Month " << month << ".";
         throw exec_error("lib_utility_rate_equations", ss.str());
     }
-    return (int)(per_num - curr_month.dc_periods.begin());
+    return row;
 }
 
 int rate_data::transfer_surplus(ur_month& curr_month, ur_month& prev_month)
@@ -106,6 +106,9 @@ public:
 	// schedule outputs
 	std::vector<int> m_ec_tou_sched;
 	std::vector<int> m_dc_tou_sched;
+	// row of each step's period in its month's ec_periods and dc_periods, -1 if the period is not in that month
+	std::vector<int> m_ec_tou_row;
+	std::vector<int> m_dc_tou_row;
 	std::vector<ur_month> m_month;
 	std::vector<int> m_ec_periods; // period number
 
@@ -176,6 +179,8 @@ public:
 
     // Used by setup
     int get_dc_tou_row(size_t year_one_index, int month);
+    // Resolve the schedule period rows for every step of the year. Called at the end of setup_energy_rates and setup_demand_charges
+    void index_tou_rows(bool energy);
 
 	// Runs each month
 	void init_dc_peak_vectors(int month); // Reinitialize vectors for re-use of memory year to year
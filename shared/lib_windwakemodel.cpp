@@ -30,7 +30,9 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include "lib_physics.h"
 #include "lib_util.h"
 #include "lib_windwatts.h"
@@ -46,9 +48,45 @@ bool windTurbine::setPowerCurve(std::vector<double> windSpeeds, std::vector<doub
 	powerCurveKW = powerOutput;
 	densityCorrectedWS = powerCurveWS;
 	powerCurveRPM.resize(powerCurveArrayLength, -1);
+
+	// bins are centred on the power curve speeds, 0.25 m/s wide; the first bin runs from 0 to 0.125 m/s
+	weibullEdgeLogs.resize(powerCurveArrayLength);
+	for (size_t i = 0; i < powerCurveArrayLength; i++)
+		weibullEdgeLogs[i] = log(i == 0 ? 0.125 : powerCurveWS[i] + 0.125);
 	return 1;
 }
 
+double windTurbine::weibullEnergy(double k, double lambda, double energy[]) const
+{
+	// a bin's probability is the difference of the cumulative distribution at its edges, which is only evaluated
+	// for edges of bins with power: zero and cut-out regions of the power curve cost nothing
+	double logLambda = log(lambda);
+	auto cumulative = [&](size_t i) { return 1.0 - exp(-exp(k * (weibullEdgeLogs[i] - logLambda))); };
+
+	double total = 0.0;
+	bool havePrevious = false;
+	double previous = 0.0;
+	if (powerCurveArrayLength > 0)
+		energy[0] = 0.0;
+	for (size_t i = 1; i < powerCurveArrayLength; i++)
+	{
+		if (powerCurveKW[i] == 0.0)
+		{
+			energy[i] = 0.0;
+			havePrevious = false;
+			continue;
+		}
+		if (!havePrevious)
+			previous = cumulative(i - 1);
+		double current = cumulative(i);
+		energy[i] = (8760.0 * (current - previous)) * powerCurveKW[i];
+		total += energy[i];
+		previous = current;
+		havePrevious = true;
+	}
+	return total;
+}
+
 double windTurbine::tipSpeedRatio(double windSpeed)
 {
 	if (powerCurveRPM[0] == -1) return 7.0;
@@ -186,6 +224,23 @@ void simpleWakeModel::wakeCalculations(const double airDensity, const double dis
 }
 
 
+void crosswindIndex::build(const double distanceCrosswind[], size_t n)
+{
+	order.resize(n);
+	for (size_t i = 0; i < n; i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [distanceCrosswind](size_t a, size_t b) { return distanceCrosswind[a] < distanceCrosswind[b]; });
+	sorted.resize(n);
+	for (size_t i = 0; i < n; i++)
+		sorted[i] = distanceCrosswind[order[i]];
+}
+
+void crosswindIndex::range(double crosswind, double halfWidth, size_t *first, size_t *last) const
+{
+	*first = std::lower_bound(sorted.begin(), sorted.end(), crosswind - halfWidth) - sorted.begin();
+	*last = std::upper_bound(sorted.begin(), sorted.end(), crosswind + halfWidth) - sorted.begin();
+}
+
 /// Returns the area of overlap, NOT a fraction
 double parkWakeModel::circle_overlap(double dist_center_to_center, double rad1, double rad2)
 {	// Source: http://mathworld.wolfram.com/Circle-CircleIntersection.html, equation 14
@@ -233,11 +288,21 @@ void parkWakeModel::wakeCalculations(const double airDensity, const double dista
 {
 	double turbineRadius = wTurbine->rotorDiameter / 2;
 
+	// a wake only overlaps a rotor closer than 2 radii plus the wake growth crosswind, so only those upwind turbines
+	// can lower the minimum speed; distances here are in rotor radii and turbines are sorted downwind
+	crossIndex.build(distanceCrosswind, nTurbines);
+	double growth = max_of(wakeDecayCoefficient, 0.0);
+
 	for (size_t i = 1; i < nTurbines; i++) // downwind turbines, i=0 has already been done
 	{
 		double newSpeed = windSpeed[0];
-		for (size_t j = 0; j < i; j++) // upwind turbines
+		double reach = (2.0 + growth * (distanceDownwind[i] - distanceDownwind[0])) * (1.0 + 1e-9) + 1e-9;
+		size_t first, last;
+		crossIndex.range(distanceCrosswind[i], reach, &first, &last);
+		for (size_t p = first; p < last; p++) // upwind turbines
 		{
+			size_t j = crossIndex.turbine(p);
+			if (j >= i) continue;
 			double distanceDownwindMeters = turbineRadius* std::abs(distanceDownwind[i] - distanceDownwind[j]);
 			double distanceCrosswindMeters = turbineRadius* std::abs(distanceCrosswind[i] - distanceCrosswind[j]);
 
@@ -409,27 +474,10 @@ bool eddyViscosityWakeModel::fillWakeArrays(int turbineIndex, double ambientVelo
 
 	turbulenceIntensity = min_of(turbulenceIntensity, 50.0); // to avoid turbines with high TIs having no wake
 
-	double Dm, Dmi;
-
-	// Von Karman constant
-	const double K = 0.4; 										// Ainslee 1988 (notation)
-
-																// dimensionless constant K1
-	const double K1 = 0.015;									// Ainslee 1988 (page 217: input parameters)
-
-	double F, x = MIN_DIAM_EV; // actual distance in rotor diameters
-
-							   // Filter function F
-	if (x >= 5.5 || !useFilterFx)
-		F = 1.0;
-	else
-		x < 4.5 ? F = 0.65 - pow(-(x - 4.5) / 23.32, 1.0 / 3.0) : F = 0.65 + pow((x - 4.5) / 23.32, 1.0 / 3.0);
-
-	// calculate the ambient eddy viscocity term
-	double Km = F*K*K*turbulenceIntensity / 100.0;  // also known as the ambient eddy viscosity???
+	double Dmi;
 
 													 // calculate the initial centreline velocity deficit at 2 rotor diameters downstream
-	Dm = Dmi = max_of(0.0, thrustCoeff - 0.05 - ((16.0*thrustCoeff - 0.5)*turbulenceIntensity / 1000.0));		// Ainslee 1988 (5)
+	Dmi = max_of(0.0, thrustCoeff - 0.05 - ((16.0*thrustCoeff - 0.5)*turbulenceIntensity / 1000.0));		// Ainslee 1988 (5)
 
 	if (Dmi <= 0.0)
 		return true;
@@ -437,26 +485,45 @@ bool eddyViscosityWakeModel::fillWakeArrays(int turbineIndex, double ambientVelo
 	double Uc = velocityAtTurbine - Dmi*velocityAtTurbine; // assuming Uc is the initial centreline velocity at 2 diameters downstream
 
 															 // now make Dmi relative to the freestream
-	Dm = Dmi = (ambientVelocity - Uc) / ambientVelocity;
+	Dmi = (ambientVelocity - Uc) / ambientVelocity;
+
+	if (useProfileLibrary)
+		interpolateWakeProfile(turbineIndex, thrustCoeff, turbulenceIntensity, Dmi, metersToFurthestDownwindTurbine);
+	else
+		solveWakeProfile(thrustCoeff, turbulenceIntensity, Dmi, metersToFurthestDownwindTurbine,
+			&matEVWakeDeficits.at(turbineIndex, 0), &matEVWakeWidths.at(turbineIndex, 0));
+	return true;
+}
+
+size_t eddyViscosityWakeModel::solveWakeProfile(double thrustCoeff, double turbulenceIntensity, double Dmi, double maxX, double deficits[], double widths[])
+{
+	double Dm = Dmi;
+
+	// Von Karman constant
+	const double K = 0.4; 										// Ainslee 1988 (notation)
+
+																// dimensionless constant K1
+	const double K1 = 0.015;									// Ainslee 1988 (page 217: input parameters)
+
+	double F, x, Km, E; // x is actual distance in rotor diameters
 
 	// calculate the initial (2D) wake width (1.89 x the half-width of the guassian profile
 	double Bw = sqrt(3.56*thrustCoeff / (8.0*Dmi*(1.0 - 0.5*Dmi)));			// Ainslee 1988 (6)
 																				// Dmi must be as a fraction of dAmbientVelocity or the above line would cause an error sqrt(-ve)
 																				// Bw must be in rotor diameters.
 
-																				// the eddy viscosity is then
-	double E = F*K1*Bw*Dm*EV_SCALE + Km;
-
 	// Start major departure from Eddy-Viscosity solution using Crank-Nicolson
-	std::vector<double> m_d2U(matEVWakeDeficits.ncols());
+	size_t nCols = matEVWakeDeficits.ncols();
+	std::vector<double> m_d2U(nCols);
 	m_d2U[0] = EV_SCALE*(1.0 - Dmi);
 
-	matEVWakeDeficits.at(turbineIndex, 0) = Dmi;
-	matEVWakeWidths.at(turbineIndex, 0) = Bw;
+	deficits[0] = Dmi;
+	widths[0] = Bw;
 
 	// j = 0 is initial conditions, j = 1 is the first step into the unknown
 	//	int iterations = 5;
-	for (size_t j = 0; j<matEVWakeDeficits.ncols() - 1; j++)
+	size_t j;
+	for (j = 0; j<nCols - 1; j++)
 	{
 		x = MIN_DIAM_EV + (double)(j)* axialResolution;
 
@@ -467,6 +534,7 @@ bool eddyViscosityWakeModel::fillWakeArrays(int turbineIndex, double ambientVelo
 		else
 			x < 4.5 ? F = 0.65 - pow(-(x - 4.5) / 23.32, 1.0 / 3.0) : F = 0.65 + pow((x - 4.5) / 23.32, 1.0 / 3.0); // for some reason pow() does not deal with -ve numbers even though excel does
 
+		// calculate the ambient eddy viscocity term
 		Km = F*K*K*turbulenceIntensity / 100.0;
 
 		// first calculate the eddy viscosity
@@ -483,16 +551,120 @@ bool eddyViscosityWakeModel::fillWakeArrays(int turbineIndex, double ambientVelo
 		Bw = sqrt(3.56*thrustCoeff / (8.0*Dm*(1.0 - 0.5*Dm)));
 
 		// ok now store the answers for later use	
-		matEVWakeDeficits.at(turbineIndex, j + 1) = Dm; // fractional deficit
-		matEVWakeWidths.at(turbineIndex, j + 1) = Bw; // diameters
+		deficits[j + 1] = Dm; // fractional deficit
+		widths[j + 1] = Bw; // diameters
 
 														// if the deficit is below min (a setting), or distance x is past the furthest downstream turbine, or we're out of room to store answers, we're done
-		if (Dm <= minDeficit || x > metersToFurthestDownwindTurbine + axialResolution || j >= matEVWakeDeficits.ncols() - 2)
+		if (Dm <= minDeficit || x > maxX + axialResolution || j >= nCols - 2)
 			break;
 	}
+	return min_of(j + 2, nCols);
+}
+
+void eddyViscosityWakeModel::profileAxis::set(double lower, double upper, double approxStep)
+{
+	n = max_of(1, (int)ceil((upper - lower) / approxStep - 1e-9));
+	lo = lower;
+	step = (upper - lower) / n;
+}
+
+void eddyViscosityWakeModel::profileAxis::locate(double value, int *i, double *w) const
+{
+	double u = (value - lo) / step;
+	if (u <= 0.0) { *i = 0; *w = 0.0; return; }
+	if (u >= n) { *i = n - 1; *w = 1.0; return; }
+	*i = min_of((int)u, n - 1);
+	*w = u - *i;
+}
+
+bool eddyViscosityWakeModel::SetProfileLibrary(double thrustCoeffStep, double turbulenceIntensityStep, double deficitStep)
+{
+	profileNodes.clear();
+	useProfileLibrary = false;
+	if (thrustCoeffStep <= 0 || turbulenceIntensityStep <= 0 || deficitStep <= 0)
+		return true;
+	if (thrustCoeffStep > 0.5 || deficitStep > 0.5 || turbulenceIntensityStep > 25)
+	{
+		errDetails = "Eddy-viscosity wake profile library steps must be at most 0.5 in thrust coefficient and deficit, and 25% in turbulence intensity.";
+		return false;
+	}
+
+	// axes span the range fillWakeArrays clamps its inputs to
+	profileCt.set(minThrustCoeff, 0.999, thrustCoeffStep);
+	profileTI.set(0.0, 50.0, turbulenceIntensityStep);
+	profileDeficit.set(minDeficit, 0.999, deficitStep);
+	useProfileLibrary = true;
 	return true;
 }
 
+const eddyViscosityWakeModel::wakeProfile& eddyViscosityWakeModel::profileNode(int iCt, int iTI, int iDeficit)
+{
+	unsigned long long key = ((unsigned long long)iCt << 42) | ((unsigned long long)iTI << 21) | (unsigned long long)iDeficit;
+	auto it = profileNodes.find(key);
+	if (it != profileNodes.end())
+		return it->second;
+
+	// solve out to the full array length, the distance to the furthest turbine is applied when interpolating
+	size_t nCols = matEVWakeDeficits.ncols();
+	wakeProfile &profile = profileNodes[key];
+	profile.deficits.resize(nCols);
+	profile.widths.resize(nCols);
+	size_t n = solveWakeProfile(profileCt.node(iCt), profileTI.node(iTI), profileDeficit.node(iDeficit),
+		std::numeric_limits<double>::max(), &profile.deficits[0], &profile.widths[0]);
+
+	// past the column that fell below the minimum deficit, whose width may not be finite, the deficit is zero and the width is held
+	if (n > 1 && profile.deficits[n - 1] <= minDeficit)
+		n--;
+	for (size_t j = n; j < nCols; j++)
+	{
+		profile.deficits[j] = 0.0;
+		profile.widths[j] = profile.widths[n - 1];
+	}
+	return profile;
+}
+
+void eddyViscosityWakeModel::interpolateWakeProfile(int turbineIndex, double thrustCoeff, double turbulenceIntensity, double Dmi, double maxX)
+{
+	int iCt, iTI, iDeficit;
+	double wCt, wTI, wDeficit;
+	profileCt.locate(thrustCoeff, &iCt, &wCt);
+	profileTI.locate(turbulenceIntensity, &iTI, &wTI);
+	profileDeficit.locate(Dmi, &iDeficit, &wDeficit);
+
+	size_t nCols = matEVWakeDeficits.ncols();
+	double *deficits = &matEVWakeDeficits.at(turbineIndex, 0);
+	double *widths = &matEVWakeWidths.at(turbineIndex, 0); // zeroed at the start of wakeCalculations
+	for (int k = 0; k < 8; k++)
+	{
+		int a = k & 1, b = (k >> 1) & 1, c = (k >> 2) & 1;
+		double weight = (a ? wCt : 1.0 - wCt) * (b ? wTI : 1.0 - wTI) * (c ? wDeficit : 1.0 - wDeficit);
+		if (weight == 0.0)
+			continue;
+		const wakeProfile &node = profileNode(iCt + a, iTI + b, iDeficit + c);
+		for (size_t j = 1; j < nCols; j++)
+		{
+			deficits[j] += weight * node.deficits[j];
+			widths[j] += weight * node.widths[j];
+		}
+	}
+
+	// the initial deficit and width are known exactly
+	deficits[0] = Dmi;
+	widths[0] = sqrt(3.56*thrustCoeff / (8.0*Dmi*(1.0 - 0.5*Dmi)));
+
+	// stop where solveWakeProfile would, leaving the rest of the row zero
+	for (size_t j = 0; j < nCols - 1; j++)
+	{
+		double x = MIN_DIAM_EV + (double)(j)* axialResolution;
+		if (deficits[j + 1] <= minDeficit || x > maxX + axialResolution)
+		{
+			for (size_t k = j + 2; k < nCols; k++)
+				deficits[k] = widths[k] = 0.0;
+			break;
+		}
+	}
+}
+
 
 /// Simplified Eddy-Viscosity model as per "Simplified Solution To The Eddy Viscosity Wake Model" - 2009 by Dr Mike Anderson of RES
 void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_density, const double aDistanceDownwind[], const double aDistanceCrosswind[],
@@ -504,13 +676,25 @@ void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_densi
 	std::vector<VMLN> vmln(nTurbines);
 	std::vector<double> Iamb(nTurbines, turbulenceCoeff);
 
+	// Upwind turbines further crosswind than the rotor radius plus the widest wake so far add no turbulence, and
+	// beyond 4.11 wake widths the Gaussian deficit is below exp(-60), too small to change the waked wind speed,
+	// so only turbines within that reach are visited. Crosswind distances here are in rotor radii.
+	crossIndex.build(aDistanceCrosswind, nTurbines);
+	double maxWakeWidthMeters = rotorDiameter; // getWakeWidth is at least one diameter past the near wake
+
 	// Note that this 'i' loop starts with i=0, which is necessary to initialize stuff for turbine[0]
 	for (size_t i = 0; i<nTurbines; i++) // downwind turbines, but starting with most upwind and working downwind
 	{
 		double dDeficit = 0, Iadd = 0, dTotalTI = aTurbulence_intensity[i];
+		double reach = ((dTurbineRadius + 4.11 * maxWakeWidthMeters) / dTurbineRadius) * (1.0 + 1e-9) + 1e-9;
+		size_t first, last;
+		crossIndex.range(aDistanceCrosswind[i], reach, &first, &last);
 		//		double dTOut=0, dThrustCoeff=0;
-		for (size_t j = 0; j<i; j++) // upwind turbines - turbines upwind of turbine[i]
+		for (size_t p = first; p < last; p++) // upwind turbines - turbines upwind of turbine[i]
 		{
+			size_t j = crossIndex.turbine(p);
+			if (j >= i) continue;
+
 			// distance downwind = distance from turbine i to turbine j along axis of wind direction
 			double dDistAxialInDiameters = std::abs(aDistanceDownwind[i] - aDistanceDownwind[j]) / 2.0;
 			if (std::abs(dDistAxialInDiameters) <= 0.0001)
@@ -550,6 +734,8 @@ void eddyViscosityWakeModel::wakeCalculations(/*INPUTS */ const double air_densi
 		{
 			if (errDetails.length() == 0) errDetails = "Could not calculate the turbine wake arrays in the Eddy-Viscosity model.";
 		}
+		for (size_t k = 0; k < matEVWakeWidths.ncols(); k++)
+			maxWakeWidthMeters = max_of(maxWakeWidthMeters, rotorDiameter * matEVWakeWidths.at(i, k));
 		nearWakeRegionLength(adWindSpeed[i], Iamb[i], Thrust[i], air_density, vmln[i]);
 	}
 }
@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __lib_windwake
 #define __lib_windwake
 
+#include <unordered_map>
 #include <vector>
 #include "lib_util.h"
 #include "lib_physics.h"
@@ -50,7 +51,8 @@ private:
 	std::vector<double> powerCurveWS,			// windspeed: x-axis on turbine power curve
 						powerCurveKW,			// power output: y-axis
 						densityCorrectedWS,
-						powerCurveRPM;
+						powerCurveRPM,
+						weibullEdgeLogs;		// log of the upper edge of each power curve bin, see weibullEnergy
 	double cutInSpeed;
 	double previousAirDensity;
 public:
@@ -81,6 +83,10 @@ public:
 	}
 	void turbinePower(double windVelocity, double airDensity, double *turbineOutput, double *turbineGross,
                       double *thrustCoefficient);
+
+	/// Annual energy (kWh) of each power curve bin and in total for a Weibull distribution of shape k and scale lambda
+	double weibullEnergy(double k, double lambda, double energy[]) const;
+
 	double calculateEff(double reducedPower, double originalPower) {
 		double Eff = 0.0;
 		if (originalPower < 0.0)
@@ -91,6 +97,22 @@ public:
 	}
 };
 
+/**
+ * crosswindIndex sorts the turbines by crosswind coordinate so that a wake model only visits the upwind turbines
+ * whose wakes can reach a downwind turbine, instead of every upwind turbine.
+ */
+
+class crosswindIndex
+{
+	std::vector<size_t> order;
+	std::vector<double> sorted;
+public:
+	void build(const double distanceCrosswind[], size_t n);
+	/// positions [first, last) in crosswind order of the turbines no further than halfWidth from crosswind
+	void range(double crosswind, double halfWidth, size_t *first, size_t *last) const;
+	size_t turbine(size_t pos) const { return order[pos]; }
+};
+
 /**
  * Wake models are used to calculate the wind velocity deficit at a turbine and the following changes to power, efficient, thrust and
  * turbulence intensity. The class requires an turbine with initialized values to run. Error messages can be propagated via errDetails.
@@ -155,6 +177,7 @@ private:
 		   minThrustCoeff = 0.02;
 	double delta_V_Park(double dVelFreeStream, double dVelUpwind, double dDistCrossWind, double dDistDownWind, double dRadiusUpstream, double dRadiusDownstream, double dThrustCoeff);
 	double circle_overlap(double dist_center_to_center, double rad1, double rad2);
+	crosswindIndex crossIndex;
 
 public:
 	parkWakeModel(){ nTurbines = 0; }
@@ -192,6 +215,7 @@ private:
 	// EV wake matrices: each turbine is row, each col is wake data for that turbine at dist
 	util::matrix_t<double> matEVWakeDeficits;	// wind velocity deficit behind each turbine, indexed by axial distance downwind
 	util::matrix_t<double> matEVWakeWidths;		// width of wake (in diameters) for each turbine, indexed by axial distance downwind
+	crosswindIndex crossIndex;
 
 	struct VMLN
 	{
@@ -210,6 +234,37 @@ private:
 		double diam;
 	};
 
+	/// evenly spaced nodes spanning [lo, lo + step * n] of one axis of the wake profile library
+	struct profileAxis
+	{
+		double lo, step;
+		int n;
+
+		void set(double lower, double upper, double approxStep);
+		double node(int i) const { return lo + step * i; }
+		/// lower node and the weight of the upper node bracketing value, clamped to the axis
+		void locate(double value, int *i, double *w) const;
+	};
+
+	/// centreline deficit and wake width of one library node, with zero deficit and held width past where it falls below minDeficit
+	struct wakeProfile
+	{
+		std::vector<double> deficits, widths;
+	};
+
+	// wake profile library over thrust coefficient, turbulence intensity (percent) and initial centreline deficit
+	profileAxis profileCt, profileTI, profileDeficit;
+	bool useProfileLibrary;
+	std::unordered_map<unsigned long long, wakeProfile> profileNodes;
+
+	/// Marches the eddy viscosity solution from initial deficit Dmi into the arrays, returns the number of columns written
+	size_t solveWakeProfile(double thrustCoeff, double turbulenceIntensity, double Dmi, double maxX, double deficits[], double widths[]);
+
+	const wakeProfile& profileNode(int iCt, int iTI, int iDeficit);
+
+	/// Fills a turbine's wake arrays by trilinear interpolation of the library profiles around the given conditions
+	void interpolateWakeProfile(int turbineIndex, double thrustCoeff, double turbulenceIntensity, double Dmi, double maxX);
+
 	/// get the velocity deficit at an axial distance behind a given upwind turbine using the wake deficit matrix
 	double getVelocityDeficit(int upwindTurbine, double axialDistanceInDiameters);
 
@@ -233,7 +288,7 @@ private:
 	double simpleIntersect(double distToCenter, double radiusTurbine, double radiusWake);
 
 public:
-	eddyViscosityWakeModel(){ nTurbines = 0; }
+	eddyViscosityWakeModel(){ nTurbines = 0; useProfileLibrary = false; }
 	eddyViscosityWakeModel(size_t numberOfTurbinesInFarm, windTurbine* wt, double turbCoeff){ 
 		wTurbine = wt;
 		rotorDiameter = wt->rotorDiameter;
@@ -252,12 +307,18 @@ public:
 		//double radialResolution = 0.2; // in rotor diameters, default in openWind=0.2
 		double maxRotorDiameters = 50; // in rotor diameters, default in openWind=50
 		useFilterFx = true;
+		useProfileLibrary = false;
 		matEVWakeDeficits.resize_fill(nTurbines, (int)(maxRotorDiameters / axialResolution) + 1, 0.0); // each turbine is row, each col is wake deficit for that turbine at dist
 		matEVWakeWidths.resize_fill(nTurbines, (int)(maxRotorDiameters / axialResolution) + 1, 0.0); // each turbine is row, each col is wake deficit for that turbine at dist
 	}
 	virtual ~eddyViscosityWakeModel() {};
 	std::string getModelName() override { return "FastEV"; }
 
+	/// Interpolate wake profiles from a library solved on first use at nodes spaced by the given steps, steps <= 0 disable it
+	bool SetProfileLibrary(double thrustCoeffStep = 0.01, double turbulenceIntensityStep = 0.25, double deficitStep = 0.01);
+	bool UsingProfileLibrary() const { return useProfileLibrary; }
+	size_t GetProfileLibraryCount() const { return profileNodes.size(); }
+
 	void wakeCalculations(
 		/*INPUTS*/
 		const double airDensity,					// not used in this model
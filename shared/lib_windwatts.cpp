@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
+#include <algorithm>
 #include <cstring>
 
 #include "lib_windwatts.h"
@@ -126,6 +127,24 @@ void windPowerCalculator::coordtrans(double metersNorth, double metersEast, doub
 	*metersCrosswind = metersEast*sin(fWind_dir_radians) + (metersNorth * cos(fWind_dir_radians));
 }
 
+/// Stable sort of the turbines by downwind distance, carrying crosswind distance and turbine id along
+static void sortByDownwind(double distanceDownwind[], double distanceCrosswind[], std::vector<size_t> &wt_id, size_t n)
+{
+	std::vector<size_t> order(n);
+	for (size_t i = 0; i < n; i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [distanceDownwind](size_t a, size_t b) { return distanceDownwind[a] < distanceDownwind[b]; });
+
+	std::vector<double> d(distanceDownwind, distanceDownwind + n), c(distanceCrosswind, distanceCrosswind + n);
+	std::vector<size_t> id(wt_id);
+	for (size_t i = 0; i < n; i++)
+	{
+		distanceDownwind[i] = d[order[i]];
+		distanceCrosswind[i] = c[order[i]];
+		wt_id[i] = id[order[i]];
+	}
+}
+
 int
 windPowerCalculator::windPowerUsingResource(double windSpeed, double windDirDeg, double airPressureAtm, double TdryC,
                                             double *farmPower,
@@ -145,18 +164,22 @@ windPowerCalculator::windPowerUsingResource(double windSpeed, double windDirDeg,
 		return 0;
 	}
 
-	size_t i, j;
-	//unsigned char wt_id[MAX_WIND_TURBINES], wid; // unsigned char has 256 limit
-    size_t wid;
-	std::vector<size_t> wt_id;
-
-	for (i = 0; i<nTurbines; i++)
-		wt_id.push_back(i);
-
 	// convert barometric pressure in ATM to air density
     if (airPressureAtm > 0.5 && airPressureAtm < 1.1) airPressureAtm = airPressureAtm * physics::Pa_PER_Atm;
 	double fAirDensity = (airPressureAtm ) / (physics::R_GAS_DRY_AIR * physics::CelciusToKelvin(TdryC));   //!Air Density, kg/m^3
 
+	return farmResponse(windSpeed, windDirDeg, fAirDensity, true, farmPower, farmPowerGross, power, thrust, eff,
+                        adWindSpeed, TI, distanceDownwind, distanceCrosswind);
+}
+
+int windPowerCalculator::farmResponse(double windSpeed, double windDirDeg, double fAirDensity, bool useBins,
+                                      double *farmPower, double *farmPowerGross, double power[], double thrust[],
+                                      double eff[], double adWindSpeed[], double TI[], double distanceDownwind[],
+                                      double distanceCrosswind[])
+{
+	size_t i, j;
+	std::vector<size_t> wt_id;
+
 	// calculate output power of a turbine
 	double fTurbine_output(0.0), fThrust_coeff(0.0), fTurbine_gross(0.0);
     windTurb->turbinePower(windSpeed, fAirDensity, &fTurbine_output, &fTurbine_gross, &fThrust_coeff);
@@ -198,6 +221,30 @@ windPowerCalculator::windPowerUsingResource(double windSpeed, double windDirDeg,
         return (int)nTurbines;
 	}
 
+	if (useBins && binDirStep > 0)
+	{
+		if (binCheckInterval == 0 || (binCalls++ % binCheckInterval) != 0)
+			return binnedFarmResponse(windSpeed, windDirDeg, fAirDensity, fTurbine_output, farmPower, power, thrust,
+                                      eff, adWindSpeed, TI, distanceDownwind, distanceCrosswind);
+
+		// sampled step: run the wake model and record how far the binned response is from it
+		double binnedPower = 0.0;
+		std::vector<double> binned(7 * nTurbines);
+		double *s = &binned[0];
+		if (binnedFarmResponse(windSpeed, windDirDeg, fAirDensity, fTurbine_output, &binnedPower, s, s + nTurbines,
+                               s + 2 * nTurbines, s + 3 * nTurbines, s + 4 * nTurbines, s + 5 * nTurbines,
+                               s + 6 * nTurbines) != (int)nTurbines)
+			return 0;
+		int n = farmResponse(windSpeed, windDirDeg, fAirDensity, false, farmPower, farmPowerGross, power, thrust, eff,
+                             adWindSpeed, TI, distanceDownwind, distanceCrosswind);
+		binErrorSum += std::abs(binnedPower - *farmPower);
+		binExactSum += std::abs(*farmPower);
+		return n;
+	}
+
+	for (i = 0; i<nTurbines; i++)
+		wt_id.push_back(i);
+
 	// ok, let's calculate the farm output
 	//!Convert to d (downwind - axial), c (crosswind - radial) coordinates
 	double d(0.0), c(0.0);
@@ -239,25 +286,7 @@ windPowerCalculator::windPowerUsingResource(double windSpeed, double windDirDeg,
 
 
 	// Sort aDistanceDownwind, aDistanceCrosswind arrays by downwind distance, aDistanceDownwind[0] is smallest downwind distance, presumably zero
-	for (j = 1; j<nTurbines; j++)
-	{
-		d = distanceDownwind[j]; // pick out each element
-		c = distanceCrosswind[j];
-		wid = wt_id[j];
-
-		i = j;
-		while (i > 0 && distanceDownwind[i - 1] > d) // look for place to insert item
-		{
-			distanceDownwind[i] = distanceDownwind[i - 1];
-			distanceCrosswind[i] = distanceCrosswind[i - 1];
-			wt_id[i] = wt_id[i - 1];
-			i--;
-		}
-
-		distanceDownwind[i] = d; // insert it
-		distanceCrosswind[i] = c;
-		wt_id[i] = wid;
-	}
+	sortByDownwind(distanceDownwind, distanceCrosswind, wt_id, nTurbines);
 
 	// calculate the power output of downwind turbines using wake model
 	wakeModel->wakeCalculations(fAirDensity, &distanceDownwind[0], &distanceCrosswind[0], power, eff, thrust, adWindSpeed, TI);
@@ -275,44 +304,141 @@ windPowerCalculator::windPowerUsingResource(double windSpeed, double windDirDeg,
 	distanceDownwind[0] *= windTurb->rotorDiameter / 2.;
 	distanceCrosswind[0] *= windTurb->rotorDiameter / 2.;
 
+	for (j = 1; j<nTurbines; j++)
+	{
+		distanceDownwind[j] *= windTurb->rotorDiameter / 2.; // convert back to meters from radii
+		distanceCrosswind[j] *= windTurb->rotorDiameter / 2.;
+	}
+
 	// Re-sort output arrays by wind turbine ID (0..nwt-1)
 	// for consistent reporting
-	double p(0.0), t(0.0), e(0.0), w(0.0), b(0.0), dd(0.0), dc(0.0);
-	for (j = 1; j<nTurbines; j++)
+	std::vector<double> sorted(nTurbines);
+	double *outputs[] = { power, thrust, eff, adWindSpeed, TI, distanceDownwind, distanceCrosswind };
+	for (double *out : outputs)
 	{
-		p = power[j];// pick out each element
-		t = thrust[j];
-		e = eff[j];
-		w = adWindSpeed[j];
-		b = TI[j];
-		dd = distanceDownwind[j] * windTurb->rotorDiameter / 2.; // convert back to meters from radii
-		dc = distanceCrosswind[j] * windTurb->rotorDiameter / 2.;
-		wid = wt_id[j];
-
-		i = j;
-		while (i > 0 && wt_id[i - 1] > wid) // look for place to insert item
-		{
-			power[i] = power[i - 1];
-			thrust[i] = thrust[i - 1];
-			eff[i] = eff[i - 1];
-			adWindSpeed[i] = adWindSpeed[i - 1];
-			TI[i] = TI[i - 1];
-			distanceDownwind[i] = distanceDownwind[i - 1];
-			distanceCrosswind[i] = distanceCrosswind[i - 1];
-			wt_id[i] = wt_id[i - 1];
-			i--;
-		}
+		sorted.assign(out, out + nTurbines);
+		for (j = 0; j < nTurbines; j++)
+			out[wt_id[j]] = sorted[j];
+	}
+
+	return (int)nTurbines;
+}
+
+bool windPowerCalculator::SetResponseBins(double dirStepDeg, double speedStepMs, double densityStepKgM3, size_t checkInterval)
+{
+	binNodes.clear();
+	binCalls = 0;
+	binErrorSum = binExactSum = 0.0;
+	binCheckInterval = checkInterval;
+
+	if (dirStepDeg <= 0 || speedStepMs <= 0 || densityStepKgM3 <= 0)
+	{
+		binDirStep = binSpeedStep = binDensityStep = 0.0;
+		binDirCount = 0;
+		return true;
+	}
+	if (dirStepDeg > 90 || densityStepKgM3 >= 0.5)
+	{
+		errDetails = "Farm response bins must be at most 90 degrees wide and narrower than 0.5 kg/m3 in air density.";
+		return false;
+	}
+
+	// round the direction step so that the bins wrap evenly around the compass
+	binDirCount = (size_t)(360.0 / dirStepDeg + 0.5);
+	binDirStep = 360.0 / binDirCount;
+	binSpeedStep = speedStepMs;
+	binDensityStep = densityStepKgM3;
+	return true;
+}
 
-		power[i] = p;
-		thrust[i] = t;
-		eff[i] = e;
-		adWindSpeed[i] = w;
-		TI[i] = b;
-		distanceDownwind[i] = dd;
-		distanceCrosswind[i] = dc;
-		wt_id[i] = wid;
+const std::vector<float> *windPowerCalculator::responseNode(size_t iDir, size_t iSpeed, size_t iDensity)
+{
+	unsigned long long key = ((unsigned long long)iDir << 40) | ((unsigned long long)iSpeed << 20) | iDensity;
+	auto it = binNodes.find(key);
+	if (it != binNodes.end())
+		return &it->second;
+
+	double speed = iSpeed * binSpeedStep;
+	double density = iDensity * binDensityStep;
+	double freeOutput = 0.0, freeGross = 0.0, freeThrust = 0.0;
+	windTurb->turbinePower(speed, density, &freeOutput, &freeGross, &freeThrust);
+
+	binScratch.resize(7 * nTurbines);
+	double *s = &binScratch[0];
+	double farm = 0.0, farmGross = 0.0;
+	if (farmResponse(speed, iDir * binDirStep, density, false, &farm, &farmGross, s, s + nTurbines, s + 2 * nTurbines,
+                     s + 3 * nTurbines, s + 4 * nTurbines, s + 5 * nTurbines, s + 6 * nTurbines) != (int)nTurbines)
+		return nullptr;
+
+	std::vector<float> &node = binNodes[key];
+	node.resize(4 * nTurbines);
+	for (size_t i = 0; i < nTurbines; i++)
+	{
+		node[i] = (float)(freeOutput > 0 ? s[i] / freeOutput : 1.0);
+		node[nTurbines + i] = (float)s[nTurbines + i];
+		node[2 * nTurbines + i] = (float)(speed > 0 ? s[3 * nTurbines + i] / speed : 1.0);
+		node[3 * nTurbines + i] = (float)s[4 * nTurbines + i];
+	}
+	return &node;
+}
+
+int windPowerCalculator::binnedFarmResponse(double windSpeed, double windDirDeg, double airDensity,
+                                            double turbineOutput, double *farmPower, double power[], double thrust[],
+                                            double eff[], double adWindSpeed[], double TI[],
+                                            double distanceDownwind[], double distanceCrosswind[])
+{
+	size_t i;
+
+	// down/crosswind coordinates in meters, as reported by the wake model path
+	double d(0.0), c(0.0);
+	for (i = 0; i < nTurbines; i++)
+	{
+		coordtrans(YCoords[i], XCoords[i], windDirDeg, &d, &c);
+		distanceDownwind[i] = d;
+		distanceCrosswind[i] = c;
+	}
+	double Dmin = distanceDownwind[0], Cmin = distanceCrosswind[0];
+	for (i = 1; i < nTurbines; i++)
+	{
+		Dmin = min_of(distanceDownwind[i], Dmin);
+		Cmin = min_of(distanceCrosswind[i], Cmin);
+	}
+	for (i = 0; i < nTurbines; i++)
+	{
+		distanceDownwind[i] -= Dmin;
+		distanceCrosswind[i] -= Cmin;
+	}
+
+	// bracketing grid corners and interpolation fractions
+	double dir = fmod(windDirDeg, 360.0);
+	if (dir < 0) dir += 360.0;
+	double xd = dir / binDirStep, xs = max_of(windSpeed, 0.0) / binSpeedStep, xr = airDensity / binDensityStep;
+	size_t d0 = (size_t)xd, s0 = (size_t)xs, r0 = (size_t)xr;
+	double fd = xd - d0, fs = xs - s0, fr = xr - r0;
+	d0 %= binDirCount;
+
+	std::vector<double> sum(4 * nTurbines, 0.0);
+	for (int corner = 0; corner < 8; corner++)
+	{
+		int cd = corner & 1, cs = (corner >> 1) & 1, cr = (corner >> 2) & 1;
+		double w = (cd ? fd : 1 - fd) * (cs ? fs : 1 - fs) * (cr ? fr : 1 - fr);
+		if (w <= 0) continue;
+		const std::vector<float> *node = responseNode((d0 + cd) % binDirCount, s0 + cs, r0 + cr);
+		if (!node) return 0;
+		for (i = 0; i < 4 * nTurbines; i++)
+			sum[i] += w * (*node)[i];
 	}
 
+	*farmPower = 0.0;
+	for (i = 0; i < nTurbines; i++)
+	{
+		power[i] = sum[i] * turbineOutput;
+		thrust[i] = sum[nTurbines + i];
+		adWindSpeed[i] = sum[2 * nTurbines + i] * windSpeed;
+		TI[i] = sum[3 * nTurbines + i];
+		eff[i] = windTurb->calculateEff(power[i], turbineOutput);
+		*farmPower += power[i];
+	}
 	return (int)nTurbines;
 }
 
@@ -326,39 +452,14 @@ double windPowerCalculator::windPowerUsingWeibull(double weibull_k, double avg_s
 	double lambda = hub_ht_windspeed / denom;
 	//double air_density = physics::Pa_PER_Atm * pow( (1-((0.0065*elevation)/288.0)), (physics::GRAVITY_MS2/(0.0065*287.15)) ) / (287.15*(288.0-0.0065*elevation));
 
-	// 'RUN' MODEL ****************************************************************************************
-	double total_energy_turbine = 0;//, total_energy_generic=0;
-	std::vector<double> weibull_cummulative(windTurb->powerCurveArrayLength, 0);
-	std::vector<double> weibull_bin(windTurb->powerCurveArrayLength, 0);
-	//std::vector<double> weibull_probability(m_iLengthOfTurbinePowerCurveArray, 0);
-	//std::vector<double> energy_turbine(m_iLengthOfTurbinePowerCurveArray, 0);	// energy from turbine chosen from library
-
-	// weibull_k = 2.10; // used for testing: this is off in the 5th significant digit when passed into SSC from samwx
-
 	// CHANGE IN METHODOLOGY JMF 3/17/15
 	/* The cost and scaling model calculates the POINT weibull probability and multiplies it by the width of the bin (0.25 m/s)- implemented by dividing by 4 in "Energy Capture" result.
 	This is effectively a midpoint integration. We were effectively calculating a right-hand integration by assuming that the cumulative weibull_bin (more accurate)
 	should be paired with the power curve at the upper end of the bin. To fix this, we will calculate the weibull probabilities shifted up by half of the bin width
 	(0.5 * 0.25 m/s = 0.125 m/s), so that the WS lies at the midpoint of the probability bin.
 	*/
-	weibull_cummulative[0] = 1.0 - exp(-pow((0.125) / lambda, weibull_k)); //first bin is probability from 0 to 0.125 m/s
-	weibull_bin[0] = weibull_cummulative[0]; //first bin is equal to first cumulative calculation
-	energy_turbine[0] = 0.0;
-	for (size_t i = 1; i<windTurb->powerCurveArrayLength; i++)
-	{
-		// calculate Weibull likelihood of the wind blowing in the range from windspeed[i - 0.5*bin_width] to windspeed[i + 0.5*bin_width]
-		weibull_cummulative[i] = 1.0 - exp(-pow((windTurb->getPowerCurveWS()[i] + 0.125) / lambda, weibull_k)); //the 0.125 shifts the probability bin so that the WS lies at the midpoint of the bin
-		weibull_bin[i] = weibull_cummulative[i] - weibull_cummulative[i - 1];
-
-		// calculate annual energy from turbine at this wind speed = (hours per year at this wind speed) X (turbine output at wind speed)
-		energy_turbine[i] = (8760.0 * weibull_bin[i]) * windTurb->getPowerCurveKW()[i];
-
-		// keep track of cummulative output
-		total_energy_turbine += energy_turbine[i];
-	}
-
-	// calculate output accounting for losses
-	return total_energy_turbine;
+	// the shifted bin edges are cached by the turbine, so each call only evaluates the distribution at them
+	return windTurb->weibullEnergy(weibull_k, lambda, energy_turbine);
 }
 
 bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<double>> &&wind_dist, double *farmPower,
@@ -377,8 +478,6 @@ bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<dou
     }
 
     size_t i, j;
-    //unsigned char wt_id[MAX_WIND_TURBINES], wid; // unsigned char has 256 limit
-    size_t wid;
     std::vector<size_t> wt_id;
 
     for (i = 0; i<nTurbines; i++)
@@ -386,11 +485,17 @@ bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<dou
 
 
     double freq_total = 0.0, farmpower = 0.0, farmgross = 0.0;
+    std::vector<double> distanceDownwind(nTurbines), distanceCrosswind(nTurbines);	// downwind, crosswind coordinate of each WT
+    std::vector<double> power(nTurbines), eff(nTurbines), thrust(nTurbines), adWindSpeed(nTurbines), TI(nTurbines);
     for (auto& row : wind_dist){
         double& windSpeed = row[0];
         double& windDirDeg = row[1];
         freq_total += row[2];
 
+        // cells of the distribution that never occur add no energy
+        if (row[2] == 0.0)
+            continue;
+
         // calculate output power of a turbine
         double fTurbine_output(0.0), fThrust_coeff(0.0), fTurbine_gross(0.0);
         windTurb->turbinePower(windSpeed, physics::AIR_DENSITY_SEA_LEVEL, &fTurbine_output, &fTurbine_gross, &fThrust_coeff);
@@ -417,8 +522,6 @@ bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<dou
         // calculate the farm output
         //!Convert to d (downwind - axial), c (crosswind - radial) coordinates
         double d(0.0), c(0.0);
-        std::vector<double> distanceDownwind(nTurbines);	// downwind coordinate of each WT
-        std::vector<double> distanceCrosswind(nTurbines);	// crosswind coordinate of each WT
         for (i = 0; i<nTurbines; i++)
         {
             coordtrans(YCoords[i], XCoords[i], windDirDeg, &d, &c);
@@ -449,29 +552,14 @@ bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<dou
         }
 
         // Sort aDistanceDownwind, aDistanceCrosswind arrays by downwind distance, aDistanceDownwind[0] is smallest downwind distance, presumably zero
-        for (j = 1; j<nTurbines; j++)
-        {
-            d = distanceDownwind[j]; // pick out each element
-            c = distanceCrosswind[j];
-            wid = wt_id[j];
-
-            i = j;
-            while (i > 0 && distanceDownwind[i - 1] > d) // look for place to insert item
-            {
-                distanceDownwind[i] = distanceDownwind[i - 1];
-                distanceCrosswind[i] = distanceCrosswind[i - 1];
-                wt_id[i] = wt_id[i - 1];
-                i--;
-            }
-
-            distanceDownwind[i] = d; // insert it
-            distanceCrosswind[i] = c;
-            wt_id[i] = wid;
-        }
+        sortByDownwind(&distanceDownwind[0], &distanceCrosswind[0], wt_id, nTurbines);
 
         // calculate the power output of downwind turbines using wake model
-        std::vector<double> power(nTurbines, fTurbine_output), eff(nTurbines, 0.), thrust(nTurbines, 0.),
-                adWindSpeed(nTurbines, windSpeed), TI(nTurbines, turbulenceIntensity);
+        std::fill(power.begin(), power.end(), fTurbine_output);
+        std::fill(eff.begin(), eff.end(), 0.);
+        std::fill(thrust.begin(), thrust.end(), 0.);
+        std::fill(adWindSpeed.begin(), adWindSpeed.end(), windSpeed);
+        std::fill(TI.begin(), TI.end(), turbulenceIntensity);
         wakeModel->wakeCalculations(physics::AIR_DENSITY_SEA_LEVEL, &distanceDownwind[0], &distanceCrosswind[0], &power[0],
                                     &eff[0], &thrust[0], &adWindSpeed[0], &TI[0]);
         if (wakeModel->errDetails.length() > 0){
@@ -497,3 +585,81 @@ bool windPowerCalculator::windPowerUsingDistribution(std::vector<std::vector<dou
 
     return true;
 }
+
+size_t wind_layout_batch_t::calculate(int nthreads)
+{
+	size_t count = xCoords.size();
+	size_t nMax = 0;
+	for (size_t c = 0; c < count; c++)
+		nMax = std::max(nMax, xCoords[c].size());
+	annualEnergy.assign(count, 0.0);
+	wakeLoss.assign(count, 0.0);
+	turbineEff.resize_fill(count, std::max(nMax, (size_t)1), 0.0);
+	errors.assign(count, "");
+	if (count == 0) return 0;
+
+	nthreads = util::thread_count(nthreads, count);
+
+	// each thread gets its own turbine for the wake models and its own per-turbine outputs
+	struct layoutScratch
+	{
+		windTurbine turbine;
+		std::vector<double> power, thrust, eff, speed, TI, distDown, distCross, turbineEnergy;
+		layoutScratch(const windTurbine &wt, size_t n) : turbine(wt), power(n), thrust(n), eff(n), speed(n), TI(n),
+			distDown(n), distCross(n), turbineEnergy(n) {}
+	};
+	std::vector<layoutScratch> scratch(nthreads, layoutScratch(*farm.windTurb, nMax));
+
+	size_t nstep = windSpeed.size();
+	util::parallel_for(count, nthreads, [&](size_t c, int t) {
+		layoutScratch &ls = scratch[t];
+		size_t n = xCoords[c].size();
+		if (n == 0 || n != yCoords[c].size())
+		{
+			errors[c] = "Candidate layouts must have the same, non-zero number of x and y coordinates.";
+			return;
+		}
+
+		windPowerCalculator calc(farm);
+		calc.windTurb = &ls.turbine;
+		calc.nTurbines = n;
+		calc.XCoords = xCoords[c];
+		calc.YCoords = yCoords[c];
+		if (!calc.InitializeModel(createWakeModel(&ls.turbine)) || !calc.SetResponseBins(binDirStep, binSpeedStep, binDensityStep))
+		{
+			errors[c] = calc.GetErrorDetails().empty() ? "Error initializing wake model." : calc.GetErrorDetails();
+			return;
+		}
+
+		double energy = 0.0, net = 0.0, gross = 0.0;
+		std::fill(ls.turbineEnergy.begin(), ls.turbineEnergy.end(), 0.0);
+		for (size_t s = 0; s < nstep; s++)
+		{
+			double farmPower = 0.0, farmGross = 0.0;
+			if ((int)n != calc.windPowerUsingResource(windSpeed[s], windDirection[s], pressure[s], temperature[s], &farmPower, &farmGross,
+				&ls.power[0], &ls.thrust[0], &ls.eff[0], &ls.speed[0], &ls.TI[0], &ls.distDown[0], &ls.distCross[0]))
+			{
+				errors[c] = util::format("error in wind calculation at time %d, details: %s", (int)s, calc.GetErrorDetails().c_str());
+				return;
+			}
+			net += farmPower;
+			gross += farmGross;
+			energy += farmPower * stepWeight[s];
+			for (size_t i = 0; i < n; i++)
+				ls.turbineEnergy[i] += ls.power[i];
+		}
+
+		annualEnergy[c] = energy;
+		if (gross > 0)
+		{
+			wakeLoss[c] = (1. - net / gross) * 100.;
+			for (size_t i = 0; i < n; i++)
+				turbineEff(c, i) = 100. * ls.turbineEnergy[i] / (gross / n);
+		}
+	});
+
+	size_t nok = 0;
+	for (size_t c = 0; c < count; c++)
+		if (errors[c].empty()) nok++;
+	return nok;
+}
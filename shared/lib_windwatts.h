@@ -33,7 +33,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __lib_windwatts_h
 #define __lib_windwatts_h
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include "lib_util.h"
 #include "lib_windwakemodel.h"
@@ -59,6 +62,24 @@ private:
 	void coordtrans(double metersNorth, double metersEast, double fWind_dir_degrees, double *fMetersDownWind, double *metersCrosswind);
 	double gammaln(double x);
 
+	/// Farm output at a given air density, running the wake model unless useBins allows the binned response
+	int farmResponse(double windSpeed, double windDirDeg, double airDensity, bool useBins, double *farmPower,
+                     double *farmPowerGross, double power[], double thrust[], double eff[], double adWindSpeed[],
+                     double TI[], double distanceDownwind[], double distanceCrosswind[]);
+
+	// binned farm response, see SetResponseBins
+	double binDirStep, binSpeedStep, binDensityStep;
+	size_t binDirCount;
+	std::unordered_map<unsigned long long, std::vector<float>> binNodes; // per turbine [power ratio, thrust, speed ratio, TI]
+	size_t binCheckInterval, binCalls;
+	double binErrorSum, binExactSum;
+	std::vector<double> binScratch;
+
+	const std::vector<float> *responseNode(size_t iDir, size_t iSpeed, size_t iDensity);
+	int binnedFarmResponse(double windSpeed, double windDirDeg, double airDensity, double turbineOutput, double *farmPower,
+                           double power[], double thrust[], double eff[], double adWindSpeed[], double TI[],
+                           double distanceDownwind[], double distanceCrosswind[]);
+
 public:
 	windTurbine* windTurb;
 	size_t nTurbines;
@@ -70,6 +91,11 @@ public:
 		nTurbines = 0;
 		turbulenceIntensity = 0.0;
 		errDetails="";
+		binDirStep = binSpeedStep = binDensityStep = 0.0;
+		binDirCount = 0;
+		binCheckInterval = 50;
+		binCalls = 0;
+		binErrorSum = binExactSum = 0.0;
 	}
 	
 	static const int MIN_DIAM_EV = 2;			// Minimum number of rotor diameters between turbines for EV wake modeling to work
@@ -88,6 +114,19 @@ public:
 	std::string GetWakeModelName();
 	std::string GetErrorDetails() { return errDetails; }
 
+	/**
+	 * Opt-in binned farm response for windPowerUsingResource. The wake model is run only at the corners of a
+	 * (direction x hub-height speed x air density) grid, lazily as time steps reach them, and the per-turbine power
+	 * ratio, thrust, wind speed ratio and TI are interpolated between corners; free-stream turbine output stays exact.
+	 * Every binCheckInterval-th binned step is also run exactly to estimate the error. Memory grows with the number
+	 * of grid corners visited times the number of turbines. Any step <= 0 turns binning off.
+	 */
+	bool SetResponseBins(double dirStepDeg, double speedStepMs, double densityStepKgM3, size_t checkInterval = 50);
+	bool UsingResponseBins() { return binDirStep > 0; }
+	/// Sampled error of the binned farm power, percent of the exact farm energy over the sampled steps
+	double GetResponseBinError() { return binExactSum > 0 ? 100.0 * binErrorSum / binExactSum : 0.0; }
+	size_t GetResponseBinCount() { return binNodes.size(); }
+
 	int
     windPowerUsingResource(double windSpeed, double windDirDeg, double airPressureAtm, double TdryC, double *farmPower,
                            double *farmPowerGross, double power[], double thrust[], double eff[], double adWindSpeed[],
@@ -110,4 +149,35 @@ public:
 	}
 };
 
+/**
+ * Evaluates candidate layouts of one farm over the same wind resource time series, for layout optimization. The
+ * resource and turbine are loaded once by the caller; candidates are handed out to worker threads one at a time, each
+ * with its own copy of the turbine and a wake model from createWakeModel. Binned responses, if set on farm, are
+ * reused across the time steps of each candidate.
+ */
+class wind_layout_batch_t
+{
+public:
+	windPowerCalculator farm;	// turbine, turbulence intensity and response bins shared by all candidates
+	std::function<std::shared_ptr<wakeModelBase>(windTurbine*)> createWakeModel;
+	double binDirStep, binSpeedStep, binDensityStep;	// > 0 to bin each candidate's farm response
+
+	// time series resource, and the energy per kW of farm power after losses for each step
+	std::vector<double> windSpeed, windDirection, pressure, temperature, stepWeight;
+
+	// candidate layouts, m
+	std::vector< std::vector<double> > xCoords, yCoords;
+
+	// results per candidate
+	std::vector<double> annualEnergy;		// kWh, with stepWeight applied
+	std::vector<double> wakeLoss;			// % of gross
+	util::matrix_t<double> turbineEff;		// % of gross farm energy / number of turbines (a free-stream turbine), candidate per row
+	std::vector<std::string> errors;
+
+	wind_layout_batch_t() { binDirStep = binSpeedStep = binDensityStep = 0.0; }
+
+	// nthreads <= 0 uses all hardware threads; returns the number of candidates evaluated without error
+	size_t calculate(int nthreads = 0);
+};
+
 #endif
@@ -2307,16 +2307,40 @@ static int mpcall(int m, int , double *p, double *dy, double **, void *vars)
   return 0;
 }
 
-int lsqfit( double (*function)( double _x, double *par, void *user_data ), void *user_data,
-	double par[], size_t npar, double *xdata, double *ydata, size_t len,
-	double tol, int maxit, int maxfc )
+struct lsq_deriv_vars_struct {
+  double *x;
+  double *y;
+  double (*function)( double _x, double *par, double *dfdpar, void *user_data );
+  void *user_data;
+  double *dfdpar;
+};
+
+static int mpcall_deriv(int m, int n, double *p, double *dy, double **dvec, void *vars)
 {
-	// use cmpfit library based on MINPACK from
-	// http://cow.physics.wisc.edu/~craigm/idl/cmpfit.html
-	struct lsq_vars_struct v;
-	mp_result result;
+  struct lsq_deriv_vars_struct *v = (struct lsq_deriv_vars_struct *) vars;
+  double *x = v->x;
+  double *y = v->y;
 
-	mp_config cfg;
+  /* mpfit passes dvec only when it wants the Jacobian; columns for
+     parameters it does not need are null */
+  if ( dvec == 0 )
+  {
+    for (int i=0; i<m; i++)
+      dy[i] = y[i] - v->function( x[i], p, 0, v->user_data );
+    return 0;
+  }
+
+  for (int i=0; i<m; i++)
+  {
+    dy[i] = y[i] - v->function( x[i], p, v->dfdpar, v->user_data );
+    for (int j=0; j<n; j++)
+      if ( dvec[j] ) dvec[j][i] = -v->dfdpar[j]; /* d(y - f)/dp */
+  }
+  return 0;
+}
+
+static void lsq_config( mp_config &cfg, double tol, int maxit, int maxfc )
+{
 	cfg.ftol = cfg.xtol = cfg.gtol = tol;
 	cfg.epsfcn = MP_MACHEP0;
 	cfg.stepfactor = 100.0;
@@ -2327,6 +2351,19 @@ int lsqfit( double (*function)( double _x, double *par, void *user_data ), void
 	cfg.douserscale = 0;
 	cfg.nofinitecheck = 0;
 	cfg.iterproc = 0;
+}
+
+int lsqfit( double (*function)( double _x, double *par, void *user_data ), void *user_data,
+	double par[], size_t npar, double *xdata, double *ydata, size_t len,
+	double tol, int maxit, int maxfc )
+{
+	// use cmpfit library based on MINPACK from
+	// http://cow.physics.wisc.edu/~craigm/idl/cmpfit.html
+	struct lsq_vars_struct v;
+	mp_result result;
+
+	mp_config cfg;
+	lsq_config( cfg, tol, maxit, maxfc );
 
 	double *perror = new double[npar];
 
@@ -2347,6 +2384,43 @@ int lsqfit( double (*function)( double _x, double *par, void *user_data ), void
 	return info;
 }
 
+int lsqfit( double (*function)( double _x, double *par, double *dfdpar, void *user_data ), void *user_data,
+	double par[], size_t npar, double *xdata, double *ydata, size_t len,
+	double tol, int maxit, int maxfc )
+{
+	struct lsq_deriv_vars_struct v;
+	mp_result result;
+
+	mp_config cfg;
+	lsq_config( cfg, tol, maxit, maxfc );
+
+	// request user-computed analytical derivatives for every parameter
+	mp_par *pars = new mp_par[npar];
+	memset(pars, 0, npar*sizeof(mp_par));
+	for (size_t i=0; i<npar; i++)
+		pars[i].side = 3;
+
+	double *perror = new double[npar];
+	double *dfdpar = new double[npar];
+
+	memset(&result,0,sizeof(result));
+	result.xerror = perror;
+
+	v.x = xdata;
+	v.y = ydata;
+	v.function = function;
+	v.user_data = user_data;
+	v.dfdpar = dfdpar;
+
+	int info = mpfit( mpcall_deriv, (int)len, (int)npar, par, pars, &cfg, (void *) &v, &result) > 0;
+
+	delete [] dfdpar;
+	delete [] perror;
+	delete [] pars;
+
+	return info;
+}
+
 int linlsqfit(double *slope, double *intercept, double *xdata, double *ydata, size_t len)
 {
 	/* linear least squares */
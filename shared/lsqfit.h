@@ -225,6 +225,28 @@ int lsqfit( double (*function)( double _x, double *par, void *user_data ), void
 	int maxit = 200, // max iterations
 	int maxfc = 0 ); // max function calls
 
+/*
+	same as above, but the model also returns its analytic partial derivatives
+	with respect to each parameter in dfdpar[0..npar-1] whenever dfdpar is not null.
+	mpfit then takes the Jacobian from the model (mp_par.side = 3) instead of
+	finite differencing, so each iteration costs one pass over the data
+	rather than npar+1 passes.
+
+	example:
+
+		double Rs_fit( double _x, double *par, double *dfdpar, void *user_data )
+		{
+			double g = (1-_x/1000)*pow(1000/_x, 2.0);
+			if ( dfdpar ) { dfdpar[0] = 1; dfdpar[1] = g; }
+			return par[0] + par[1]*g;
+		}
+*/
+int lsqfit( double (*function)( double _x, double *par, double *dfdpar, void *user_data ), void *user_data,
+	double par[], size_t npar, double *xdata, double *ydata, size_t len,
+	double tol = 1e-9, // tolerance criterion for convergence
+	int maxit = 200, // max iterations
+	int maxfc = 0 ); // max function calls
+
 
 
 /* linear least squares fit */
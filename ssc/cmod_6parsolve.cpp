@@ -135,3 +135,86 @@ public:
 };
 
 DEFINE_MODULE_ENTRY( 6parsolve, "Solver for CEC/6 parameter PV module coefficients", 1 )
+
+
+static var_info _cm_vtab_6parsolve_batch[] = {
+/*   VARTYPE           DATATYPE         NAME                           LABEL                                UNITS     META                      GROUP                      REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,         SSC_MATRIX,      "modules",                "Module datasheet table",         "",        "one row per module: celltype (0=monoSi,1=multiSi,2=cdte,3=cis,4=cigs,5=amorphous), Vmp (V), Imp (A), Voc (V), Isc (A), alpha_isc (A/'C), beta_voc (V/'C), gamma_pmp (%/'C), Nser, Tref ('C)", "Six Parameter Solver", "*", "", "" },
+	{ SSC_INPUT,         SSC_NUMBER,      "nthreads",               "Number of threads",              "",        "0 uses all available cores", "Six Parameter Solver",  "?=1",                     "INTEGER,MIN=0",         "" },
+	{ SSC_INPUT,         SSC_NUMBER,      "warm_start",             "Start from parameters of similar solved modules", "0/1", "", "Six Parameter Solver",       "?=1",                     "BOOLEAN",               "" },
+
+// outputs
+	{ SSC_OUTPUT,        SSC_ARRAY,       "a",                      "Modified nonideality factor",    "1/V",    "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "Il",                     "Light current",                  "A",      "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "Io",                     "Saturation current",             "A",      "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "Rs",                     "Series resistance",              "ohm",    "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "Rsh",                    "Shunt resistance",               "ohm",    "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "Adj",                    "OC SC temp coeff adjustment",    "%",      "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "status",                 "Sanity check code",              "",       "0 on success, otherwise the error code reported by 6parsolve", "Six Parameter Solver", "*", "",         "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "warm_started",           "Solved from a similar module",   "0/1",    "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "residual",               "Largest absolute equation residual", "",   "",                      "Six Parameter Solver",      "*",                        "",                      "" },
+
+var_info_invalid };
+
+class cm_6parsolve_batch : public compute_module
+{
+public:
+
+	cm_6parsolve_batch()
+	{
+		add_var_info( _cm_vtab_6parsolve_batch );
+	}
+
+	void exec()
+	{
+		util::matrix_t<double> table = as_matrix("modules");
+		if (table.ncols() != 10)
+			throw exec_error("6parsolve_batch", util::format("modules table must have 10 columns, %d given", (int)table.ncols()));
+
+		size_t n = table.nrows();
+		module6par_batch batch;
+		batch.modules.resize(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			int tech_id = (int)table(i, 0);
+			if (tech_id < module6par::monoSi || tech_id > module6par::Amorphous)
+				throw exec_error("6parsolve_batch", util::format("invalid cell type %d in row %d", tech_id, (int)i));
+
+			batch.modules[i] = module6par(tech_id, table(i, 1), table(i, 2), table(i, 3), table(i, 4),
+				table(i, 6), table(i, 5), table(i, 7), (int)table(i, 8), table(i, 9) + 273.15);
+		}
+
+		batch.solve(300, 1e-7, as_integer("nthreads"), as_boolean("warm_start"));
+
+		ssc_number_t *p_a = allocate("a", n);
+		ssc_number_t *p_Il = allocate("Il", n);
+		ssc_number_t *p_Io = allocate("Io", n);
+		ssc_number_t *p_Rs = allocate("Rs", n);
+		ssc_number_t *p_Rsh = allocate("Rsh", n);
+		ssc_number_t *p_Adj = allocate("Adj", n);
+		ssc_number_t *p_status = allocate("status", n);
+		ssc_number_t *p_warm = allocate("warm_started", n);
+		ssc_number_t *p_resid = allocate("residual", n);
+
+		int nfailed = 0;
+		for (size_t i = 0; i < n; i++)
+		{
+			const module6par &m = batch.modules[i];
+			p_a[i] = (ssc_number_t)m.a;
+			p_Il[i] = (ssc_number_t)m.Il;
+			p_Io[i] = (ssc_number_t)m.Io;
+			p_Rs[i] = (ssc_number_t)m.Rs;
+			p_Rsh[i] = (ssc_number_t)m.Rsh;
+			p_Adj[i] = (ssc_number_t)m.Adj;
+			p_status[i] = (ssc_number_t)batch.err[i];
+			p_warm[i] = (ssc_number_t)batch.warm_started[i];
+			p_resid[i] = (ssc_number_t)batch.residual[i];
+			if (batch.err[i] < 0) nfailed++;
+		}
+
+		if (nfailed > 0)
+			log(util::format("%d of %d modules could not be solved, see the status output", nfailed, (int)n), SSC_WARNING);
+	}
+};
+
+DEFINE_MODULE_ENTRY( 6parsolve_batch, "Batch solver for CEC/6 parameter PV module coefficients", 1 )
@@ -162,7 +162,7 @@ var_info vtab_battery_inputs[] = {
     { SSC_INPUT,        SSC_ARRAY,      "batt_target_power_monthly",                   "Grid target power on monthly basis",                     "kW",       "",                     "BatteryDispatch",       "en_batt=1&batt_meter_position=0&batt_dispatch_choice=1",                        "",                             "" },
     { SSC_INPUT,        SSC_NUMBER,     "batt_target_choice",                          "Target power input option",                              "0/1",      "0=InputMonthlyTarget,1=InputFullTimeSeries", "BatteryDispatch", "en_batt=1&en_standalone_batt=0&batt_meter_position=0&batt_dispatch_choice=1",                        "",                             "" },
     { SSC_INPUT,        SSC_ARRAY,      "batt_custom_dispatch",                        "Custom battery power for every time step",               "kW",       "kWAC if AC-connected, else kWDC", "BatteryDispatch",       "en_batt=1&en_standalone_batt=0&batt_dispatch_choice=2","",                         "" },
-    { SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4/5", "If behind the meter: 0=PeakShaving,1=InputGridTarget,2=InputBatteryPower,3=ManualDispatch,4=PriceSignalForecast,5=SelfConsumption if front of meter: 0=AutomatedEconomic,1=PV_Smoothing,2=InputBatteryPower,3=ManualDispatch",                    "BatteryDispatch",       "en_batt=1",                        "",                             "" },
+    { SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_choice",                        "Battery dispatch algorithm",                             "0/1/2/3/4/5", "If behind the meter: 0=PeakShaving,1=InputGridTarget,2=InputBatteryPower,3=ManualDispatch,4=PriceSignalForecast,5=SelfConsumption if front of meter: 0=AutomatedEconomic,1=PV_Smoothing,2=InputBatteryPower,3=ManualDispatch,4=OptimizedEconomic",                    "BatteryDispatch",       "en_batt=1",                        "",                             "" },
     { SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_auto_can_fuelcellcharge",       "Charging from fuel cell allowed for automated dispatch?", "0/1",       "",                   "BatteryDispatch",       "",                           "",                             "" },
     { SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_auto_can_gridcharge",           "Grid charging allowed for automated dispatch?",          "0/1",       "",                    "BatteryDispatch",       "",                           "",                             "" },
     { SSC_INPUT,        SSC_NUMBER,     "batt_dispatch_auto_can_charge",               "System charging allowed for automated dispatch?",            "0/1",       "",                "BatteryDispatch",       "",                           "",                             "" },
@@ -642,7 +642,7 @@ battstor::battstor(var_table& vt, bool setup_model, size_t nrec, double dt_hr, c
                         }
                     }
 
-                    if (batt_vars->batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC)
+                    if (batt_vars->batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC || batt_vars->batt_dispatch == dispatch_t::FOM_OPTIMIZED)
                     {
                         batt_vars->batt_look_ahead_hours = vt.as_unsigned_long("batt_look_ahead_hours");
                         batt_vars->batt_dispatch_update_frequency_hours = vt.as_double("batt_dispatch_update_frequency_hours");
@@ -1414,7 +1414,7 @@ void battstor::parse_configuration()
         }
         else if (batt_meter_position == dispatch_t::FRONT)
         {
-            if (batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC || batt_dispatch == dispatch_t::FOM_PV_SMOOTHING) {
+            if (batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC || batt_dispatch == dispatch_t::FOM_PV_SMOOTHING || batt_dispatch == dispatch_t::FOM_OPTIMIZED) {
                 switch (batt_weather_forecast) {
                 case dispatch_t::WEATHER_FORECAST_CHOICE::WF_LOOK_AHEAD:
                     wf_look_ahead = true;
@@ -1772,7 +1772,7 @@ battstor::battstor(const battstor& orig) {
 
 bool battstor::uses_forecast() {
     if (batt_vars->batt_meter_position == dispatch_t::FRONT) {
-        return batt_vars->batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC || batt_vars->batt_dispatch == dispatch_t::FOM_PV_SMOOTHING;
+        return batt_vars->batt_dispatch == dispatch_t::FOM_AUTOMATED_ECONOMIC || batt_vars->batt_dispatch == dispatch_t::FOM_PV_SMOOTHING || batt_vars->batt_dispatch == dispatch_t::FOM_OPTIMIZED;
     }
     else {
         return batt_vars->batt_dispatch == dispatch_t::FORECAST || dispatch_t::PEAK_SHAVING;
@@ -2061,40 +2061,52 @@ void battstor::calculate_monthly_and_annual_outputs(compute_module& cm)
     cm.assign("batt_system_charge_percent", var_data((ssc_number_t)outSystemChargePercent));
     cm.assign("batt_bank_installed_capacity", (ssc_number_t)batt_vars->batt_kwh);
 
-    // monthly outputs
-    cm.accumulate_monthly_for_year("system_to_batt", "monthly_system_to_batt", _dt_hour, step_per_hour);
-    cm.accumulate_monthly_for_year("grid_to_batt", "monthly_grid_to_batt", _dt_hour, step_per_hour);
-    cm.accumulate_monthly_for_year("system_to_grid", "monthly_system_to_grid", _dt_hour, step_per_hour);
-    cm.accumulate_monthly_for_year("interconnection_loss", "monthly_interconnection_loss", _dt_hour, step_per_hour);
-    cm.accumulate_monthly_for_year("batt_to_grid", "monthly_batt_to_grid", _dt_hour, step_per_hour);
+    // monthly and annual energy outputs, one pass per time series
+    timeseries_aggregator agg(&cm, step_per_hour);
+    agg.monthly_for_year("system_to_batt", "monthly_system_to_batt", _dt_hour);
+    agg.monthly_for_year("grid_to_batt", "monthly_grid_to_batt", _dt_hour);
+    agg.monthly_for_year("system_to_grid", "monthly_system_to_grid", _dt_hour);
+    agg.monthly_for_year("interconnection_loss", "monthly_interconnection_loss", _dt_hour);
+    agg.monthly_for_year("batt_to_grid", "monthly_batt_to_grid", _dt_hour);
 
     // critical load unmet values
-    if (cm.is_assigned("crit_load_unmet")) {
-        auto annual_unmet_load = cm.accumulate_annual_for_year("crit_load_unmet", "annual_crit_load_unmet", _dt_hour, step_per_hour);
-        auto pmonthly_unmet_load = cm.accumulate_monthly_for_year("crit_load_unmet", "monthly_crit_load_unmet", _dt_hour, step_per_hour);
-        if (cm.is_assigned("crit_load")) {
-            auto annual_load = cm.accumulate_annual_for_year("crit_load", "annual_crit_load", _dt_hour, step_per_hour);
-            auto pmonthly_load = cm.accumulate_monthly_for_year("crit_load", "monthly_crit_load", _dt_hour, step_per_hour);
-            ssc_number_t* monthly_unmet_percentage = cm.allocate("monthly_crit_load_unmet_percentage", 12);
-            for (size_t i = 0; i < 12; i++) {
-                monthly_unmet_percentage[i] = 100.0 * (pmonthly_load[i] > 0 ? pmonthly_unmet_load[i] / pmonthly_load[i] : 0.0);
-            }
-            cm.assign("annual_crit_load_unmet_percentage", (var_data)((ssc_number_t)(100.0 * (annual_load > 0 ? annual_unmet_load / annual_load : 0.0))));
+    bool crit_load_unmet = cm.is_assigned("crit_load_unmet");
+    bool crit_load = crit_load_unmet && cm.is_assigned("crit_load");
+    if (crit_load_unmet) {
+        agg.annual_for_year("crit_load_unmet", "annual_crit_load_unmet", _dt_hour);
+        agg.monthly_for_year("crit_load_unmet", "monthly_crit_load_unmet", _dt_hour);
+        if (crit_load) {
+            agg.annual_for_year("crit_load", "annual_crit_load", _dt_hour);
+            agg.monthly_for_year("crit_load", "monthly_crit_load", _dt_hour);
         }
         if (cm.is_assigned("outage_losses_unmet")) {
-            auto annual_unmet_losses = cm.accumulate_annual_for_year("outage_losses_unmet", "annual_outage_losses_unmet", _dt_hour, step_per_hour);
-            auto pmonthly_unmet_losses = cm.accumulate_monthly_for_year("outage_losses_unmet", "monthly_outage_losses_unmet", _dt_hour, step_per_hour);
+            agg.annual_for_year("outage_losses_unmet", "annual_outage_losses_unmet", _dt_hour);
+            agg.monthly_for_year("outage_losses_unmet", "monthly_outage_losses_unmet", _dt_hour);
         }
     }
 
-
     if (batt_vars->batt_meter_position == dispatch_t::BEHIND)
     {
-        cm.accumulate_monthly_for_year("system_to_load", "monthly_system_to_load", _dt_hour, step_per_hour);
-        cm.accumulate_monthly_for_year("batt_to_load", "monthly_batt_to_load", _dt_hour, step_per_hour);
-        cm.accumulate_monthly_for_year("grid_to_load", "monthly_grid_to_load", _dt_hour, step_per_hour);
+        agg.monthly_for_year("system_to_load", "monthly_system_to_load", _dt_hour);
+        agg.monthly_for_year("batt_to_load", "monthly_batt_to_load", _dt_hour);
+        agg.monthly_for_year("grid_to_load", "monthly_grid_to_load", _dt_hour);
+    }
+    agg.compute();
+
+    if (crit_load) {
+        ssc_number_t annual_unmet_load = agg.annual_value("annual_crit_load_unmet");
+        ssc_number_t annual_load = agg.annual_value("annual_crit_load");
+        size_t count = 0;
+        ssc_number_t* pmonthly_unmet_load = cm.as_array("monthly_crit_load_unmet", &count);
+        ssc_number_t* pmonthly_load = cm.as_array("monthly_crit_load", &count);
+        ssc_number_t* monthly_unmet_percentage = cm.allocate("monthly_crit_load_unmet_percentage", 12);
+        for (size_t i = 0; i < 12; i++) {
+            monthly_unmet_percentage[i] = 100.0 * (pmonthly_load[i] > 0 ? pmonthly_unmet_load[i] / pmonthly_load[i] : 0.0);
+        }
+        cm.assign("annual_crit_load_unmet_percentage", (var_data)((ssc_number_t)(100.0 * (annual_load > 0 ? annual_unmet_load / annual_load : 0.0))));
     }
-    else if (batt_vars->batt_meter_position == dispatch_t::FRONT)
+
+    if (batt_vars->batt_meter_position == dispatch_t::FRONT)
     {
         if (batt_vars->batt_dispatch == dispatch_t::FOM_PV_SMOOTHING) {
             // total number of violations
@@ -2197,6 +2209,8 @@ static var_info _cm_vtab_battery[] = {
     { SSC_INPUT,        SSC_ARRAY,       "crit_load_escalation",                       "Annual critical load escalation",                         "%/year",     "",                     "Load",                             "?=0",                    "",                    "" },
     { SSC_INPUT,        SSC_ARRAY,       "grid_outage",                                "Grid outage in this time step",                              "0/1",        "0=GridAvailable,1=GridUnavailable,Length=load", "Load",    "",                       "",                               "" },
     { SSC_INPUT,        SSC_NUMBER,      "run_resiliency_calcs",                       "Enable resilence calculations for every timestep",        "0/1",        "0=DisableCalcs,1=EnableCalcs",                  "Load",    "?=0",                    "",                               "" },
+    { SSC_INPUT,        SSC_NUMBER,      "resiliency_outage_interval",                 "Number of time steps between simulated outage starts",    "",           "1=OutageAtEveryTimestep",                       "Load",    "?=1",                    "INTEGER,MIN=1",                   "" },
+    { SSC_INPUT,        SSC_NUMBER,      "resiliency_nthreads",                        "Number of threads for resilience calculations",           "",           "0 uses all available cores",                    "Load",    "?=1",                    "INTEGER,MIN=0",                   "" },
     { SSC_INOUT,        SSC_NUMBER,      "capacity_factor",                            "Capacity factor",                                         "%",          "",                     "System Output",                             "",                    "",                               "" },
     { SSC_OUTPUT,       SSC_NUMBER,      "capacity_factor_sales",                      "Capacity factor based on AC electricity to grid",                                         "%",          "",                     "System Output",                             "",                    "",                               "" },
 
@@ -2300,7 +2314,8 @@ public:
                 bool crit_load_specified = !p_crit_load.empty() && *std::max_element(p_crit_load.begin(), p_crit_load.end()) > 0;
                 if (run_resilience) {
                     if (crit_load_specified) {
-                        resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt));
+                        resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt, as_unsigned_long("resiliency_outage_interval"),
+                                as_unsigned_long("resiliency_nthreads")));
                         auto logs = resilience->get_logs();
                         if (!logs.empty()) {
                             log(logs[0], SSC_WARNING);
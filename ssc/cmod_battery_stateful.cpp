@@ -42,8 +42,12 @@ var_info vtab_battery_stateful_inputs[] = {
     /*   VARTYPE           DATATYPE         NAME                                            LABEL                                                   UNITS      META                   GROUP           REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
     { SSC_INPUT,        SSC_NUMBER,      "control_mode",                               "Control using current (0) or power (1)",                  "0/1",      "",   "Controls",       "*",                           "",                              "" },
     { SSC_INPUT,        SSC_NUMBER,      "dt_hr",                                      "Time step in hours",                                      "hr",      "",   "Controls",       "*",                           "",                              "" },
-    { SSC_INPUT,        SSC_NUMBER,      "input_current",                              "Current at which to run battery",                         "A",       "",   "Controls",       "control_mode=0",              "",                              "" },
-    { SSC_INPUT,        SSC_NUMBER,      "input_power",                                "Power at which to run battery",                           "kW",      "",   "Controls",       "control_mode=1",              "",                              "" },
+    { SSC_INPUT,        SSC_NUMBER,      "input_current",                              "Current at which to run battery",                         "A",       "",   "Controls",       "?",                           "",                              "" },
+    { SSC_INPUT,        SSC_NUMBER,      "input_power",                                "Power at which to run battery",                           "kW",      "",   "Controls",       "?",                           "",                              "" },
+    { SSC_INPUT,        SSC_ARRAY,       "input_current_batch",                        "Currents at which to run battery for consecutive steps",  "A",       "Runs one step per entry instead of input_current",   "Controls",       "?",              "",                              "" },
+    { SSC_INPUT,        SSC_ARRAY,       "input_power_batch",                          "Powers at which to run battery for consecutive steps",    "kW",      "Runs one step per entry instead of input_power",     "Controls",       "?",              "",                              "" },
+    { SSC_INPUT,        SSC_NUMBER,      "sync_state",                                 "Read state from data before running (1) or keep the model state from the last call (0)", "0/1", "", "Controls", "?=1",     "BOOLEAN",                       "" },
+    { SSC_INPUT,        SSC_NUMBER,      "snapshot_interval",                          "Number of batch steps between state snapshots",           "",        "0=no snapshots",                                    "Controls",       "?=0",            "INTEGER,MIN=0",                 "" },
 
     { SSC_INPUT,        SSC_NUMBER,      "chem",                                       "Lead Acid (0), Li Ion (1), Vanadium Redox (2), Iron Flow (3)","0/1/2/3","",   "ParamsCell",       "*",                           "",                              "" },
     { SSC_INOUT,        SSC_NUMBER,      "nominal_energy",                             "Nominal installed energy",                                "kWh",     "",                     "ParamsPack",       "*",                           "",                              "" },
@@ -193,6 +197,18 @@ var_info vtab_battery_state[] = {
 
     var_info_invalid };
 
+var_info vtab_battery_stateful_batch[] = {
+    { SSC_OUTPUT,       SSC_ARRAY,      "I_batch",                   "Current at each batch step",                               "A",         "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "V_batch",                   "Voltage at each batch step",                               "V",         "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "P_batch",                   "Power at each batch step",                                 "kW",        "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "SOC_batch",                 "State of Charge at each batch step",                       "%",         "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "T_batt_batch",              "Battery temperature at each batch step",                   "C",         "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "P_chargeable_batch",        "Estimated max chargeable power after each batch step",     "kW",        "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "P_dischargeable_batch",     "Estimated max dischargeable power after each batch step",  "kW",        "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_ARRAY,      "snapshot_indices",          "Lifetime indices of the state snapshots",                  "",          "",                     "Batch",         "",                           "",                               ""  },
+    { SSC_OUTPUT,       SSC_TABLE,      "state_snapshots",           "State tables keyed by lifetime index",                     "",          "Each table holds the StatePack and StateCell variables", "Batch", "",              "",                               ""  },
+    var_info_invalid };
+
 void write_battery_state(const battery_state& state, var_table* vt) {
     vt->assign_match_case("last_idx", (int)state.last_idx);
     vt->assign_match_case("V", state.V);
@@ -558,6 +574,7 @@ cm_battery_stateful::cm_battery_stateful() :
     control_mode(0) {
     add_var_info(vtab_battery_stateful_inputs);
     add_var_info(vtab_battery_state);
+    add_var_info(vtab_battery_stateful_batch);
 }
 
 bool cm_battery_stateful::setup(var_table* vt) {
@@ -601,20 +618,79 @@ bool cm_battery_stateful::compute(handler_interface *handler, var_table *data) {
     return true;
 }
 
+void cm_battery_stateful::run_replacement(size_t lifetime_index) {
+    size_t steps_per_hour = (size_t)(1 / dt_hr);
+    size_t steps_per_year = (size_t)(8760 * steps_per_hour);
+    size_t year = (size_t)(lifetime_index / steps_per_year);
+    size_t year_one_index = lifetime_index - (year * steps_per_year);
+    size_t hour = (size_t)(year_one_index / steps_per_hour);
+    size_t step_of_hour = year_one_index - (hour * steps_per_hour);
+
+    battery->runReplacement(year, hour, step_of_hour);
+}
+
+void cm_battery_stateful::run_batch(const std::vector<double>& controls) {
+    size_t n = controls.size();
+    ssc_number_t* I = allocate("I_batch", n);
+    ssc_number_t* V = allocate("V_batch", n);
+    ssc_number_t* P = allocate("P_batch", n);
+    ssc_number_t* SOC = allocate("SOC_batch", n);
+    ssc_number_t* T_batt = allocate("T_batt_batch", n);
+    ssc_number_t* P_chargeable = allocate("P_chargeable_batch", n);
+    ssc_number_t* P_dischargeable = allocate("P_dischargeable_batch", n);
+
+    size_t snapshot_interval = 0;
+    if (is_assigned("snapshot_interval"))
+        snapshot_interval = (size_t)as_integer("snapshot_interval");
+    std::vector<double> snapshot_indices;
+    var_table snapshots;
+
+    for (size_t i = 0; i < n; i++) {
+        run_replacement(battery->last_idx());
+        if (control_mode == MODE::CURRENT)
+            battery->runCurrent(controls[i]);
+        else
+            battery->runPower(controls[i]);
+
+        I[i] = (ssc_number_t)battery->I();
+        V[i] = (ssc_number_t)battery->V();
+        P[i] = (ssc_number_t)battery->P();
+        SOC[i] = (ssc_number_t)battery->SOC();
+        T_batt[i] = (ssc_number_t)battery->T_battery();
+        P_chargeable[i] = (ssc_number_t)battery->P_chargeable();
+        P_dischargeable[i] = (ssc_number_t)battery->P_dischargeable();
+
+        if (snapshot_interval > 0 && (i + 1) % snapshot_interval == 0) {
+            // write_battery_state looks up the chemistry and life model in the table it writes to
+            var_table snapshot;
+            snapshot.assign_match_case("chem", *lookup("chem"));
+            snapshot.assign_match_case("life_model", *lookup("life_model"));
+            write_battery_state(battery->get_state(), &snapshot);
+            snapshot_indices.push_back((double)battery->last_idx());
+            snapshots.assign_match_case(std::to_string(battery->last_idx()), var_data(snapshot));
+        }
+    }
+    assign("snapshot_indices", var_data(snapshot_indices));
+    assign("state_snapshots", var_data(snapshots));
+}
+
 void cm_battery_stateful::exec() {
     if (!battery)
         throw exec_error("battery_stateful", "Battery stateful model must be `setup` first.");
 
-    // Update state
-    try {
-        battery_state state(params->lifetime->model_choice);
-        read_battery_state(state, m_vartab);
-        battery->set_state(state);
-    }
-    catch (std::exception& e) {
-        std::string err = "battery_stateful error: Could not read state. ";
-        err += e.what();
-        throw runtime_error(err);
+    // Update state, unless the caller keeps the model's own state from the last call
+    bool sync_state = !is_assigned("sync_state") || as_boolean("sync_state");
+    if (sync_state) {
+        try {
+            battery_state state(params->lifetime->model_choice);
+            read_battery_state(state, m_vartab);
+            battery->set_state(state);
+        }
+        catch (std::exception& e) {
+            std::string err = "battery_stateful error: Could not read state. ";
+            err += e.what();
+            throw runtime_error(err);
+        }
     }
 
     // Update controls
@@ -625,25 +701,25 @@ void cm_battery_stateful::exec() {
         battery->ChangeTimestep(dt_hr);
     }
 
-    // Replacements
-    size_t lifetime_index = as_integer("last_idx");
-    size_t steps_per_hour = (size_t)(1 / control_dt_hr);
-    size_t steps_per_year = (size_t)(8760 * steps_per_hour);
-    size_t year = (size_t)(lifetime_index / steps_per_year);
-    size_t year_one_index = lifetime_index - (year * steps_per_year);
-    size_t hour = (size_t)(year_one_index / steps_per_hour);
-    size_t step_of_hour = year_one_index - (hour * steps_per_hour);
-
-    battery->runReplacement(year, hour, step_of_hour);
-
     // Simulate
-    if (static_cast<MODE>(as_integer("control_mode")) == MODE::CURRENT) {
-        double I = as_number("input_current");
-        battery->runCurrent(I);
+    const char* input_name = control_mode == MODE::CURRENT ? "input_current" : "input_power";
+    const char* batch_name = control_mode == MODE::CURRENT ? "input_current_batch" : "input_power_batch";
+    if (!is_assigned(input_name) && !is_assigned(batch_name))
+        throw exec_error("battery_stateful", util::format("control_mode=%d requires %s or %s.", (int)control_mode,
+                                                          input_name, batch_name));
+    if (is_assigned(batch_name)) {
+        run_batch(as_vector_double(batch_name));
     }
     else {
-        double P = as_number("input_power");
-        battery->runPower(P);
+        run_replacement(battery->last_idx());
+        if (control_mode == MODE::CURRENT) {
+            double I = as_number(input_name);
+            battery->runCurrent(I);
+        }
+        else {
+            double P = as_number(input_name);
+            battery->runPower(P);
+        }
     }
 
     write_battery_state(battery->get_state(), m_vartab);
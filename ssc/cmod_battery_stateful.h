@@ -63,6 +63,13 @@ public:
     bool compute(handler_interface *handler, var_table *data) override;
 
     void exec() override;
+
+private:
+    // Run battery replacements due at the lifetime index, using the current time step
+    void run_replacement(size_t lifetime_index);
+
+    // Run one step per control value, keeping the state in the battery model until all steps are done
+    void run_batch(const std::vector<double>& controls);
 };
 
 #endif //SAM_SIMULATION_CORE_CMOD_BATTERY_STATEFUL_H
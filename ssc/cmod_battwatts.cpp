@@ -63,6 +63,8 @@ var_info vtab_battwatts[] = {
     { SSC_INPUT,		SSC_ARRAY,	     "crit_load",			             "Critical electricity load (year 1)",     "kW",	   "",		           "Battery",                           "",	                         "",	                          "" },
     { SSC_INPUT,        SSC_ARRAY,       "grid_outage",                      "Grid outage in this time step",             "0/1",     "0=GridAvailable,1=GridUnavailable,Length=load", "Load",    "",                       "",                               "" },
     { SSC_INPUT,        SSC_NUMBER,      "run_resiliency_calcs",             "Enable resilence calculations for every timestep",           "0/1",     "0=DisableCalcs,1=EnableCalcs",                  "Load",    "?=0",                    "",                               "" },
+    { SSC_INPUT,        SSC_NUMBER,      "resiliency_outage_interval",       "Number of time steps between simulated outage starts",       "",        "1=OutageAtEveryTimestep",                       "Load",    "?=1",                    "INTEGER,MIN=1",                   "" },
+    { SSC_INPUT,        SSC_NUMBER,      "resiliency_nthreads",              "Number of threads for resilience calculations",              "",        "0 uses all available cores",                    "Load",    "?=1",                    "INTEGER,MIN=0",                   "" },
     { SSC_INPUT,        SSC_ARRAY,       "load_escalation",                  "Annual load escalation",                 "%/year",   "",                 "Load",                              "?=0",                       "",                              "" },
     { SSC_INPUT,        SSC_NUMBER,      "inverter_efficiency",               "Inverter Efficiency",                     "%",      "",                  "Battery",                          "",                           "MIN=0,MAX=100",                               "" },
 
@@ -406,7 +408,8 @@ void cm_battwatts::exec()
             bool crit_load_specified = !p_crit_load.empty() && *std::max_element(p_crit_load.begin(), p_crit_load.end()) > 0;
             if (run_resilience) {
                 if (crit_load_specified) {
-                    resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt));
+                    resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt, as_unsigned_long("resiliency_outage_interval"),
+                                as_unsigned_long("resiliency_nthreads")));
                     auto logs = resilience->get_logs();
                     if (!logs.empty()) {
                         log(logs[0], SSC_WARNING);
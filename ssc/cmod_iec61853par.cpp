@@ -127,6 +127,122 @@ public:
 DEFINE_MODULE_ENTRY( iec61853par, "Calculate 11-parameter single diode model parameters from IEC-61853 PV module test data.", 1 )
 
 
+static var_info vtab_iec61853par_batch[] = 
+{	
+/*   VARTYPE            DATATYPE         NAME                        LABEL                       UNITS     META                                             GROUP          REQUIRED_IF    CONSTRAINTS UI_HINTS*/
+	{ SSC_INPUT,        SSC_MATRIX,      "input",                  "IEC-61853 matrix test data for all modules", "various", "[MODULE,IRR,TC,PMP,VMP,VOC,ISC], MODULE is the 0-based module index", "IEC61853", "*", "",  "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "nser",                   "Number of cells in series",  "",         "one per module",                                "IEC61853",    "*",           "",         "" },
+	{ SSC_INPUT,        SSC_ARRAY,       "type",                   "Cell technology type",       "0..5",     "one per module: monoSi,multiSi/polySi,cdte,cis,cigs,amorphous", "IEC61853", "*", "",     "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "nthreads",               "Number of threads",          "",         "0 uses all available cores",                    "IEC61853",    "?=1",         "INTEGER,MIN=0", "" },
+																								 											                			   
+	{ SSC_OUTPUT,       SSC_ARRAY,       "status",                 "Fit succeeded",              "0/1",      "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "alphaIsc",               "SC temp coefficient @ STC",  "A/C",      "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "betaVoc",                "OC temp coefficient @ STC",  "V/C",      "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "gammaPmp",               "MP temp coefficient @ STC",  "%/C",      "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "n",                      "Diode factor",               "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "Il",                     "Light current",              "A",        "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "Io",                     "Saturation current",         "A",        "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "C1",                     "Rsh fitting C1",             "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "C2",                     "Rsh fitting C2",             "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "C3",                     "Rsh fitting C3",             "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "D1",                     "Rs fitting D1",              "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "D2",                     "Rs fitting D2",              "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "D3",                     "Rs fitting D3",              "",         "",                                              "IEC61853",    "*",           "",         "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "Egref",                  "Bandgap voltage",            "eV",       "",                                              "IEC61853",    "*",           "",         "" },
+
+var_info_invalid };
+
+class cm_iec61853par_batch : public compute_module
+{
+public:
+	cm_iec61853par_batch()
+	{
+		add_var_info( vtab_iec61853par_batch );
+	}
+
+	void exec( )
+	{
+		util::matrix_t<double> input = as_matrix("input");
+		if ( input.ncols() != iec61853_module_t::COL_MAX + 1 )
+			throw exec_error( "iec61853par_batch", "seven data columns required for input matrix: MODULE,IRR,TC,PMP,VMP,VOC,ISC");
+
+		std::vector<int> nser = as_vector_integer("nser");
+		std::vector<int> type = as_vector_integer("type");
+		if ( type.size() != nser.size() )
+			throw exec_error( "iec61853par_batch", util::format("nser and type must have the same length, %d and %d given", (int)nser.size(), (int)type.size()) );
+
+		size_t count = nser.size();
+		std::vector<size_t> nrows( count, 0 );
+		for( size_t r=0;r<input.nrows();r++ )
+		{
+			int m = (int)input(r,0);
+			if ( m < 0 || m >= (int)count )
+				throw exec_error( "iec61853par_batch", util::format("invalid module index %d in row %d", m, (int)r) );
+			nrows[m]++;
+		}
+
+		iec61853_batch_t batch;
+		batch.resize( count );
+		for( size_t i=0;i<count;i++ )
+		{
+			batch.input[i].resize( nrows[i], iec61853_module_t::COL_MAX );
+			batch.nseries[i] = nser[i];
+			batch.type[i] = type[i];
+			nrows[i] = 0;
+		}
+
+		for( size_t r=0;r<input.nrows();r++ )
+		{
+			size_t m = (size_t)input(r,0);
+			for( size_t c=0;c<iec61853_module_t::COL_MAX;c++ )
+				batch.input[m]( nrows[m], c ) = input(r,c+1);
+			nrows[m]++;
+		}
+
+		size_t nok = batch.calculate( as_integer("nthreads") );
+
+		ssc_number_t *p_status = allocate( "status", count );
+		ssc_number_t *p_alphaIsc = allocate( "alphaIsc", count );
+		ssc_number_t *p_betaVoc = allocate( "betaVoc", count );
+		ssc_number_t *p_gammaPmp = allocate( "gammaPmp", count );
+		ssc_number_t *p_n = allocate( "n", count );
+		ssc_number_t *p_Il = allocate( "Il", count );
+		ssc_number_t *p_Io = allocate( "Io", count );
+		ssc_number_t *p_C1 = allocate( "C1", count );
+		ssc_number_t *p_C2 = allocate( "C2", count );
+		ssc_number_t *p_C3 = allocate( "C3", count );
+		ssc_number_t *p_D1 = allocate( "D1", count );
+		ssc_number_t *p_D2 = allocate( "D2", count );
+		ssc_number_t *p_D3 = allocate( "D3", count );
+		ssc_number_t *p_Egref = allocate( "Egref", count );
+
+		for( size_t i=0;i<count;i++ )
+		{
+			const iec61853_module_t &m = batch.modules[i];
+			p_status[i] = (ssc_number_t)batch.ok[i];
+			p_alphaIsc[i] = (ssc_number_t)m.alphaIsc;
+			p_betaVoc[i] = (ssc_number_t)m.betaVoc;
+			p_gammaPmp[i] = (ssc_number_t)m.gammaPmp;
+			p_n[i] = (ssc_number_t)m.n;
+			p_Il[i] = (ssc_number_t)m.Il;
+			p_Io[i] = (ssc_number_t)m.Io;
+			p_C1[i] = (ssc_number_t)m.C1;
+			p_C2[i] = (ssc_number_t)m.C2;
+			p_C3[i] = (ssc_number_t)m.C3;
+			p_D1[i] = (ssc_number_t)m.D1;
+			p_D2[i] = (ssc_number_t)m.D2;
+			p_D3[i] = (ssc_number_t)m.D3;
+			p_Egref[i] = (ssc_number_t)m.Egref;
+		}
+
+		if ( nok < count )
+			log( util::format("%d of %d modules could not be fitted, see the status output", (int)(count-nok), (int)count), SSC_WARNING );
+	}
+};
+
+DEFINE_MODULE_ENTRY( iec61853par_batch, "Calculate 11-parameter single diode model parameters for many modules' IEC-61853 test data in parallel.", 1 )
+
+
 #include "../solarpilot/Toolbox.h"
 #include "../tcs/interpolation_routines.h"
 
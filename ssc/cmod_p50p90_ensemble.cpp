@@ -0,0 +1,159 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "core.h"
+#include "common.h"
+
+static var_info _cm_vtab_p50p90_ensemble[] = {
+/*   VARTYPE           DATATYPE         NAME                           LABEL                                UNITS     META                      GROUP                      REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+    { SSC_INPUT,         SSC_STRING,      "compute_module",          "Performance model to run for each weather year",     "",       "pvsamv1, pvwattsv8 or windpower", "Uncertainty", "*",          "",                      "" },
+    { SSC_INPUT,         SSC_TABLE,       "input",                   "Performance model inputs shared by all weather years", "",     "weather inputs are replaced for each year", "Uncertainty", "*", "",                   "" },
+    { SSC_INPUT,         SSC_DATARR,      "weather_years",           "Weather file path or weather data table for each year", "",    "",                       "Uncertainty",             "*",                        "",                      "" },
+    { SSC_INPUT,         SSC_NUMBER,      "nthreads",                "Number of threads",                  "",       "0 uses all available cores", "Uncertainty",        "?=1",                      "INTEGER,MIN=0",         "" },
+
+    { SSC_OUTPUT,        SSC_ARRAY,       "annual_energy_years",     "Annual energy for each weather year", "kWh",   "",                       "Uncertainty",             "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_MATRIX,      "monthly_energy_years",    "Monthly energy for each weather year", "kWh",  "one row per weather year", "Uncertainty",           "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_NUMBER,      "annual_energy_p50",       "Annual energy with 50% probability of exceedance", "kWh", "",            "Uncertainty",             "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_NUMBER,      "annual_energy_p75",       "Annual energy with 75% probability of exceedance", "kWh", "",            "Uncertainty",             "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_NUMBER,      "annual_energy_p90",       "Annual energy with 90% probability of exceedance", "kWh", "",            "Uncertainty",             "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_NUMBER,      "annual_energy_p95",       "Annual energy with 95% probability of exceedance", "kWh", "",            "Uncertainty",             "*",                        "",                      "" },
+    { SSC_OUTPUT,        SSC_ARRAY,       "monthly_energy_p50",      "Monthly energy with 50% probability of exceedance", "kWh", "",           "Uncertainty",             "*",                        "LENGTH=12",             "" },
+    { SSC_OUTPUT,        SSC_ARRAY,       "monthly_energy_p75",      "Monthly energy with 75% probability of exceedance", "kWh", "",           "Uncertainty",             "*",                        "LENGTH=12",             "" },
+    { SSC_OUTPUT,        SSC_ARRAY,       "monthly_energy_p90",      "Monthly energy with 90% probability of exceedance", "kWh", "",           "Uncertainty",             "*",                        "LENGTH=12",             "" },
+    { SSC_OUTPUT,        SSC_ARRAY,       "monthly_energy_p95",      "Monthly energy with 95% probability of exceedance", "kWh", "",           "Uncertainty",             "*",                        "LENGTH=12",             "" },
+
+    var_info_invalid };
+
+class cm_p50p90_ensemble : public compute_module
+{
+public:
+
+    cm_p50p90_ensemble()
+    {
+        add_var_info(_cm_vtab_p50p90_ensemble);
+    }
+
+    void exec()
+    {
+        std::string cm_name = as_string("compute_module");
+        std::string file_var, data_var;
+        if (cm_name == "pvsamv1" || cm_name == "pvwattsv8") {
+            file_var = "solar_resource_file";
+            data_var = "solar_resource_data";
+        }
+        else if (cm_name == "windpower") {
+            file_var = "wind_resource_filename";
+            data_var = "wind_resource_data";
+        }
+        else
+            throw exec_error("p50p90_ensemble", "compute_module must be pvsamv1, pvwattsv8 or windpower, not " + cm_name);
+
+        var_data* input = lookup("input");
+        if (!input || input->type != SSC_TABLE)
+            throw exec_error("p50p90_ensemble", "No input table found.");
+
+        std::vector<var_data>& years = lookup("weather_years")->vec;
+        size_t nyears = years.size();
+        if (nyears < 2)
+            throw exec_error("p50p90_ensemble", "at least two weather years are required");
+        for (size_t y = 0; y < nyears; y++)
+            if (years[y].type != SSC_STRING && years[y].type != SSC_TABLE)
+                throw exec_error("p50p90_ensemble", util::format("weather year %d must be a file path or a weather data table", (int)y));
+
+        // the system inputs are shared; each year gets its own copy with only the weather replaced
+        var_table shared_inputs = input->table;
+        shared_inputs.unassign(file_var);
+        shared_inputs.unassign(data_var);
+
+        std::vector<double> annual(nyears, std::numeric_limits<double>::quiet_NaN());
+        util::matrix_t<double> monthly(nyears, 12, std::numeric_limits<double>::quiet_NaN());
+
+        // each year is a complete run of the compute module through the public API: the performance models are built
+        // inside the module's exec from its input table, which it may also modify, so only the shared inputs are
+        // prepared once and every year starts from its own copy of them
+        util::parallel_for(nyears, as_integer("nthreads"), [&](size_t y, int) {
+            var_table vt = shared_inputs;
+            if (years[y].type == SSC_STRING)
+                vt.assign(file_var, years[y]);
+            else
+                vt.assign(data_var, years[y]);
+
+            ssc_module_t module = ssc_module_create(cm_name.c_str());
+            if (!module)
+                throw exec_error("p50p90_ensemble", util::format("weather year %d: could not create %s", (int)y, cm_name.c_str()));
+
+            if (ssc_module_exec_with_handler(module, static_cast<ssc_data_t>(&vt), 0, 0)) {
+                annual[y] = vt.as_double("annual_energy");
+                size_t count = 0;
+                ssc_number_t* p_monthly = vt.as_array("monthly_energy", &count);
+                for (size_t m = 0; m < 12 && m < count; m++)
+                    monthly(y, m) = p_monthly[m];
+                ssc_module_free(module);
+                return;
+            }
+
+            std::string error = "simulation failed";
+            int idx = 0, type;
+            float time;
+            while (const char* text = ssc_module_log(module, idx++, &type, &time)) {
+                if (type == SSC_ERROR) {
+                    error = text;
+                    break;
+                }
+            }
+            ssc_module_free(module);
+            throw exec_error("p50p90_ensemble", util::format("weather year %d: %s", (int)y, error.c_str()));
+        });
+
+        ssc_number_t* p_annual = allocate("annual_energy_years", nyears);
+        ssc_number_t* p_monthly = allocate("monthly_energy_years", nyears, 12);
+        for (size_t y = 0; y < nyears; y++) {
+            p_annual[y] = (ssc_number_t)annual[y];
+            for (size_t m = 0; m < 12; m++)
+                p_monthly[y * 12 + m] = (ssc_number_t)monthly(y, m);
+        }
+
+        const int levels[] = { 50, 75, 90, 95 };
+        for (int p : levels) {
+            assign(util::format("annual_energy_p%d", p), var_data((ssc_number_t)empirical_exceedance(annual, p / 100.)));
+            ssc_number_t* p_month_p = allocate(util::format("monthly_energy_p%d", p), 12);
+            for (size_t m = 0; m < 12; m++) {
+                std::vector<double> values(nyears);
+                for (size_t y = 0; y < nyears; y++)
+                    values[y] = monthly(y, m);
+                p_month_p[m] = (ssc_number_t)empirical_exceedance(values, p / 100.);
+            }
+        }
+    }
+};
+
+DEFINE_MODULE_ENTRY(p50p90_ensemble, "Empirical P50/P75/P90/P95 energy from simulations over multiple weather years", 1)
@@ -57,6 +57,8 @@ static var_info _cm_vtab_poacalib[] =
         { SSC_INPUT,        SSC_NUMBER,      "tamb",              "Ambient Temperature (dry bulb temperature)","°C",     "",        "POA Calibrate", "?",           "",                              "" },
         { SSC_INPUT,        SSC_NUMBER,      "pressure",          "Pressure",              "millibars",        "",                  "POA Calibrate", "?",           "",                              "" },
 
+        { SSC_INPUT,        SSC_NUMBER,      "nthreads",          "Number of threads",     "",                 "0 uses all available cores", "POA Calibrate", "?=1",  "INTEGER,MIN=0",                 "" },
+
         { SSC_INPUT,        SSC_ARRAY,       "poa",               "Plane of Array",        "W/m^2",            "",                  "POA Calibrate", "*",           "LENGTH=8760",                   "" },
 
         { SSC_INOUT,        SSC_ARRAY,       "beam",              "Beam Irradiation",      "W/m^2",            "",                  "POA Calibrate", "*",           "LENGTH=8760",                   "" },
@@ -67,6 +69,105 @@ static var_info _cm_vtab_poacalib[] =
 
     var_info_invalid };
 
+static void calibrate_hour(const ssc_number_t* poa, ssc_number_t* beam, ssc_number_t* diffuse, ssc_number_t* pcalc, size_t idx,
+    int year, int m, int d, int h, double lat, double lon, double timezone, double tilt, double az, double alb,
+    double elev, double pres, double tamb)
+{
+    // assign current timestep irradiance values to variables
+    double P = poa[idx];
+    double D = diffuse[idx];
+    double B = beam[idx];
+
+    // check for nighttime
+    if (P <= 0)
+    {
+        beam[idx] = 0;
+        diffuse[idx] = 0;
+        pcalc[idx] = 0;
+        return;
+    }
+
+    // call irradiance class for needed variables and assign variables
+    irrad x;
+    x.set_location(lat, lon, timezone);
+    x.set_optional(elev, pres, tamb);
+    x.set_time(year, m, d, h, 30, 1.0);
+    x.set_surface(0, tilt, az, 0, 0, 0, 0, 0, false, 0.0);
+    x.set_sky_model(2, alb);
+    x.set_beam_diffuse(B, D);
+    double solaz, zen;
+    x.calc();
+    x.get_sun(&solaz, &zen, 0, 0, 0, 0, 0, 0, 0, 0);
+    solaz = solaz * DTOR;
+    zen = zen * DTOR;
+    double inc;
+    x.get_angles(&inc, 0, 0, 0, 0);
+    inc = inc * DTOR;
+
+    // define beam to diffuse ratio (remains unchanged for this timestep)
+    double R = B / D;
+    // Inc angle greater than 90 degrees OR measured P but no measured D OR measured P less than 1 -> assume all diffuse
+    if (inc >= DTOR * 90 || (P > 0 && D <= 0) || P < 1)
+        R = 0;
+
+    // compute calculated POA using Perez method starting with input B & D
+    double poa_c[3] = { 0,0,0 };
+    double diffc[3] = { 0,0,0 };
+    perez(0, B, D, alb, inc, DTOR * tilt, zen, poa_c, diffc);
+    double Pcalc = poa_c[0] + poa_c[1] + poa_c[2];
+
+    // for high zenith angles, save original values to check for unreasonable values after iteration
+    double B_o = B;
+    double D_o = D;
+    bool flag = 0; // flag for unreasonable values at high zenith angles
+
+    // iterate for Perez POA to match input POA
+    int counter = 0; // counter to prevent an infinite loop
+    while (std::abs(Pcalc - P) > 0.5 && counter < 5000)
+    {
+        // incrementally increase or reduce D based on difference between P calculated and P measured
+        double incr = std::abs(Pcalc - P) * 0.01;
+        if (Pcalc > P)
+            D = D - incr;
+        else
+            D = D + incr;
+
+        // increment B according to ratio if not flagged by high zenith angle, otherwise leave B alone
+        if (!flag)
+            B = D * R;
+        else
+            B = B_o;
+
+        // compute new calculated P
+        perez(0, B, D, alb, inc, DTOR * tilt, zen, poa_c, diffc);
+        Pcalc = poa_c[0] + poa_c[1] + poa_c[2];
+
+        // check that high zenith Beam isn't getting ridiculous
+        if (zen > DTOR * 85)
+        {
+            if ((B - B_o) > 100) // if Beam getting too far away from input beam at high zenith
+            {
+                flag = 1; // turn on flag so that beam does not get incremented
+                B = B_o; // reset beam and diffuse
+                D = D_o;
+                perez(0, B, D, alb, inc, DTOR * tilt, zen, poa_c, diffc);
+                Pcalc = poa_c[0] + poa_c[1] + poa_c[2]; // reset Pcalc
+                counter = 0; // reset counter
+            }
+        }
+        counter++;
+    }
+
+    // assign error value if didn't converge in 5000 steps
+    if (counter == 5000 || B < 0 || D < 0)
+        B = D = -999;
+
+    // assign calibrated beam and diffuse to outputs
+    beam[idx] = (ssc_number_t)B;
+    diffuse[idx] = (ssc_number_t)D;
+    pcalc[idx] = (ssc_number_t)Pcalc;
+}
+
 class cm_poacalib : public compute_module
 {
 private:
@@ -128,114 +229,26 @@ public:
             }
         }
 
-        // loop through 8760 timesteps
-        int idx = 0;
+        // hours are calibrated independently, so spread whole days across threads
+        std::vector<int> day_month, day_of_month;
+        std::vector<size_t> day_start;
+        size_t idx = 0;
         for (int m = 1; m <= 12; m++) //index across months
         {
             for (size_t d = 1; d <= util::nday[m - 1]; d++) //index across days of month
             {
-                for (int h = 0; h < 24; h++) //index across hours
-                {
-                    // assign current timestep irradiance values to variables
-                    double P = poa[idx];
-                    double D = diffuse[idx];
-                    double B = beam[idx];
-
-                    // check for nighttime
-                    if (P <= 0)
-                    {
-                        beam[idx] = 0;
-                        diffuse[idx] = 0;
-                        pcalc[idx] = 0;
-                        idx++;
-                        continue;
-                    }
-
-                    // call irradiance class for needed variables and assign variables
-                    irrad x;
-                    x.set_location(lat, lon, timezone);
-                    x.set_optional(elev, pres, tamb);
-                    x.set_time(year, m, (int)d, h, 30, 1.0);
-                    x.set_surface(0, tilt, az, 0, 0, 0, 0, 0, false, 0.0);
-                    x.set_sky_model(2, alb);
-                    x.set_beam_diffuse(B, D);
-                    double solaz, zen;
-                    x.calc();
-                    x.get_sun(&solaz, &zen, 0, 0, 0, 0, 0, 0, 0, 0);
-                    solaz = solaz * DTOR;
-                    zen = zen * DTOR;
-                    double inc;
-                    x.get_angles(&inc, 0, 0, 0, 0);
-                    inc = inc * DTOR;
-
-                    // define beam to diffuse ratio (remains unchanged for this timestep)
-                    double R = B / D;
-                    // Inc angle greater than 90 degrees OR measured P but no measured D OR measured P less than 1 -> assume all diffuse
-                    if (inc >= DTOR * 90 || (P > 0 && D <= 0) || P < 1)
-                        R = 0;
-
-                    // compute calculated POA using Perez method starting with input B & D
-                    double poa[3] = { 0,0,0 };
-                    double diffc[3] = { 0,0,0 };
-                    perez(0, B, D, alb, inc, DTOR * tilt, zen, poa, diffc);
-                    double Pcalc = poa[0] + poa[1] + poa[2];
-
-                    // for high zenith angles, save original values to check for unreasonable values after iteration
-                    double B_o = B;
-                    double D_o = D;
-                    bool flag = 0; // flag for unreasonable values at high zenith angles
-
-                    // iterate for Perez POA to match input POA
-                    int counter = 0; // counter to prevent an infinite loop
-                    while (std::abs(Pcalc - P) > 0.5 && counter < 5000)
-                    {
-                        // incrementally increase or reduce D based on difference between P calculated and P measured
-                        double incr = std::abs(Pcalc - P) * 0.01;
-                        if (Pcalc > P)
-                            D = D - incr;
-                        else
-                            D = D + incr;
-
-                        // increment B according to ratio if not flagged by high zenith angle, otherwise leave B alone
-                        if (!flag)
-                            B = D * R;
-                        else
-                            B = B_o;
-
-                        // compute new calculated P
-                        perez(0, B, D, alb, inc, DTOR * tilt, zen, poa, diffc);
-                        Pcalc = poa[0] + poa[1] + poa[2];
-
-                        // check that high zenith Beam isn't getting ridiculous
-                        if (zen > DTOR * 85)
-                        {
-                            if ((B - B_o) > 100) // if Beam getting too far away from input beam at high zenith
-                            {
-                                flag = 1; // turn on flag so that beam does not get incremented
-                                B = B_o; // reset beam and diffuse
-                                D = D_o;
-                                perez(0, B, D, alb, inc, DTOR * tilt, zen, poa, diffc);
-                                Pcalc = poa[0] + poa[1] + poa[2]; // reset Pcalc
-                                counter = 0; // reset counter
-                            }
-                        }
-                        counter++;
-                    }
-
-                    // assign error value if didn't converge in 5000 steps
-                    if (counter == 5000 || B < 0 || D < 0)
-                        B = D = -999;
-
-                    // assign calibrated beam and diffuse to outputs
-                    beam[idx] = (ssc_number_t)B;
-                    diffuse[idx] = (ssc_number_t)D;
-                    pcalc[idx] = (ssc_number_t)Pcalc;
-
-                    idx++;
-                }
+                day_month.push_back(m);
+                day_of_month.push_back((int)d);
+                day_start.push_back(idx);
+                idx += 24;
             }
         }
 
+        util::parallel_for(day_start.size(), as_integer("nthreads"), [&](size_t i, int) {
+            for (int h = 0; h < 24; h++) //index across hours
+                calibrate_hour(poa, beam, diffuse, pcalc, day_start[i] + h, year, day_month[i], day_of_month[i], h,
+                    lat, lon, timezone, tilt, az, alb, elev, pres, tamb);
+        });
     }
 };
 
@@ -577,6 +577,8 @@ static var_info _cm_vtab_pvsamv1[] = {
         { SSC_INPUT, SSC_ARRAY,    "crit_load",                            "Critical Electricity load (year 1)",                  "kW",     "",                                                                                                                                                                                      "Load",                                               "",                                   "",                    "" },
         { SSC_INPUT, SSC_ARRAY,    "grid_outage",                          "Grid outage in this time step",                          "0/1",    "0=GridAvailable,1=GridUnavailable,Length=load", "Load",    "",                       "",                               "" },
         { SSC_INPUT, SSC_NUMBER,   "run_resiliency_calcs",                 "Enable resilence calculations for every timestep",    "0/1",    "0=DisableCalcs,1=EnableCalcs",                  "Load",    "?=0",                    "INTEGER,MIN=0,MAX=1",                               "" },
+        { SSC_INPUT, SSC_NUMBER,   "resiliency_outage_interval",           "Number of time steps between simulated outage starts", "",       "1=OutageAtEveryTimestep",                       "Load",    "?=1",                    "INTEGER,MIN=1",                   "" },
+        { SSC_INPUT, SSC_NUMBER,   "resiliency_nthreads",                  "Number of threads for resilience calculations",       "",       "0 uses all available cores",                    "Load",    "?=1",                    "INTEGER,MIN=0",                   "" },
         { SSC_INPUT, SSC_ARRAY,    "load_escalation",                      "Annual load escalation",                              "%/year", "",                                                                                                                                                                                      "Load",                                               "?=0",                                "",                    "" },
         { SSC_INPUT, SSC_ARRAY,    "crit_load_escalation",                 "Annual critical load escalation",                     "%/year", "",                                                                                                                                                                                      "Load",                                               "?=0",                                "",                    "" },
         // NOTE:  other battery storage model inputs and outputs are defined in batt_common.h/batt_common.cpp
@@ -1306,7 +1308,8 @@ void cm_pvsamv1::exec()
         bool run_resilience = as_boolean("run_resiliency_calcs");
         if (run_resilience) {
             if (crit_load_specified) {
-                resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt));
+                resilience = std::unique_ptr<resilience_runner>(new resilience_runner(batt, as_unsigned_long("resiliency_outage_interval"),
+                                as_unsigned_long("resiliency_nthreads")));
                 auto logs = resilience->get_logs();
                 if (!logs.empty()) {
                     log(logs[0], SSC_WARNING);
@@ -3010,24 +3013,15 @@ void cm_pvsamv1::exec()
         }
         wdprov->rewind();
     }
-    if (wdprov->annualSimulation())
-        ssc_number_t* p_annual_energy_dist_time = gen_heatmap(this, 1 / ts_hour);
     // Check the snow models and if neccessary report a warning
     //  *This only needs to be done for subarray1 since all of the activated subarrays should
     //   have the same number of bad values
-    //  *Also accumulate monthly and annual loss values
+    //  *Monthly and annual loss values are accumulated with the other annual outputs below
 
     if (PVSystem->enableSnowModel) {
         if (Subarrays[0]->snowModel.badValues > 0) {
             log(util::format("The snow model has detected %d bad snow depth values (less than 0 or greater than 610 cm), set to zero.", Subarrays[0]->snowModel.badValues), SSC_WARNING);
         }
-
-        // scale by ts_hour to convert power -> energy
-        if (Simulation->annualSimulation)
-        {
-            accumulate_monthly_for_year("dc_snow_loss", "monthly_snow_loss", ts_hour, step_per_hour);
-            accumulate_annual_for_year("dc_snow_loss", "annual_snow_loss", ts_hour, step_per_hour);
-        }
     }
 
     //Outputs that are always assigned
@@ -3047,46 +3041,61 @@ void cm_pvsamv1::exec()
     //Outputs that are only assigned for annual simulations
     if (Simulation->annualSimulation)
     {
-        accumulate_monthly_for_year("dc_net", "monthly_dc", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("gen", "monthly_energy", ts_hour, step_per_hour);
-
+        // all annual, monthly and heatmap outputs in one pass per time series
         // scale by ts_hour to convert power -> energy
-        accumulate_annual_for_year("gh", "annual_gh", ts_hour, step_per_hour);
-
-        // scale by ts_hour to convert power -> energy
-        double annual_poa_nom = accumulate_annual_for_year("poa_nom", "annual_poa_nom", ts_hour, step_per_hour);
-        double annual_poa_beam_nom = accumulate_annual_for_year("poa_beam_nom", "annual_poa_beam_nom", ts_hour, step_per_hour);
-        double annual_poa_shaded = accumulate_annual_for_year("poa_shaded", "annual_poa_shaded", ts_hour, step_per_hour);
-        double annual_poa_shaded_soiled = accumulate_annual_for_year("poa_shaded_soiled", "annual_poa_shaded_soiled", ts_hour, step_per_hour);
-        double annual_poa_front = accumulate_annual_for_year("poa_front", "annual_poa_front", ts_hour, step_per_hour);
-        double annual_poa_rear = accumulate_annual_for_year("poa_rear", "annual_poa_rear", ts_hour, step_per_hour);
-        double annual_poa_rear_ground_reflected = accumulate_annual_for_year("poa_rear_ground_reflected", "annual_poa_rear_ground_reflected", ts_hour, step_per_hour);
-        double annual_poa_rear_row_reflections = accumulate_annual_for_year("poa_rear_row_reflections", "annual_poa_rear_row_reflections", ts_hour, step_per_hour);
-        double annual_poa_rear_direct_diffuse = accumulate_annual_for_year("poa_rear_direct_diffuse", "annual_poa_rear_direct_diffuse", ts_hour, step_per_hour);
-        double annual_poa_rear_self_shaded = accumulate_annual_for_year("poa_rear_self_shaded", "annual_poa_rear_self_shaded", ts_hour, step_per_hour);
-        double annual_poa_rear_rack_shaded = accumulate_annual_for_year("poa_rear_rack_shaded", "annual_poa_rear_rack_shaded", ts_hour, step_per_hour);
-        double annual_poa_rear_soiled = accumulate_annual_for_year("poa_rear_soiled", "annual_poa_rear_soiled", ts_hour, step_per_hour);
-        double annual_ground_incident = accumulate_annual_for_year("ground_incident", "annual_ground_incident", ts_hour, step_per_hour);
-        double annual_ground_absorbed = accumulate_annual_for_year("ground_absorbed", "annual_ground_absorbed", ts_hour, step_per_hour);
-        double annual_bifacial_electrical_mismatch = accumulate_annual_for_year("bifacial_electrical_mismatch", "annual_bifacial_electrical_mismatch", ts_hour, step_per_hour);
-        double annual_poa_eff = accumulate_annual_for_year("poa_eff", "annual_poa_eff", ts_hour, step_per_hour);
-        double annual_poa_beam_eff = accumulate_annual_for_year("poa_beam_eff", "annual_poa_beam_eff", ts_hour, step_per_hour);
-
-        accumulate_monthly_for_year("poa_nom", "monthly_poa_nom", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("poa_beam_nom", "monthly_poa_beam_nom", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("poa_front", "monthly_poa_front", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("poa_rear", "monthly_poa_rear", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("poa_eff", "monthly_poa_eff", ts_hour, step_per_hour);
-        accumulate_monthly_for_year("poa_beam_eff", "monthly_poa_beam_eff", ts_hour, step_per_hour);
+        timeseries_aggregator agg(this, step_per_hour);
+        agg.heatmap("gen", "annual_energy_distribution_time");
+        if (PVSystem->enableSnowModel) {
+            agg.monthly_for_year("dc_snow_loss", "monthly_snow_loss", ts_hour);
+            agg.annual_for_year("dc_snow_loss", "annual_snow_loss", ts_hour);
+        }
 
-        // scale by ts_hour to convert power -> energy
-        double annual_dc_net = accumulate_annual_for_year("dc_net", "annual_dc_net", ts_hour, step_per_hour);
-        accumulate_annual_for_year("gen", "annual_ac_net", ts_hour, step_per_hour);
-        double annual_inv_cliploss = accumulate_annual_for_year("inv_cliploss", "annual_inv_cliploss", ts_hour, step_per_hour);
-        accumulate_annual_for_year("dc_invmppt_loss", "annual_dc_invmppt_loss", ts_hour, step_per_hour);
-        double annual_inv_psoloss = accumulate_annual_for_year("inv_psoloss", "annual_inv_psoloss", ts_hour, step_per_hour);
-        double annual_inv_pntloss = accumulate_annual_for_year("inv_pntloss", "annual_inv_pntloss", ts_hour, step_per_hour);
-        double annual_inv_tdcloss = accumulate_annual_for_year("inv_tdcloss", "annual_inv_tdcloss", ts_hour, step_per_hour);
+        agg.monthly_for_year("dc_net", "monthly_dc", ts_hour);
+        agg.monthly_for_year("gen", "monthly_energy", ts_hour);
+        agg.annual_for_year("gh", "annual_gh", ts_hour);
+
+        const char* poa_names[] = { "poa_nom", "poa_beam_nom", "poa_shaded", "poa_shaded_soiled", "poa_front", "poa_rear",
+            "poa_rear_ground_reflected", "poa_rear_row_reflections", "poa_rear_direct_diffuse", "poa_rear_self_shaded",
+            "poa_rear_rack_shaded", "poa_rear_soiled", "ground_incident", "ground_absorbed", "bifacial_electrical_mismatch",
+            "poa_eff", "poa_beam_eff" };
+        for (const char* name : poa_names)
+            agg.annual_for_year(name, std::string("annual_") + name, ts_hour);
+
+        const char* poa_monthly_names[] = { "poa_nom", "poa_beam_nom", "poa_front", "poa_rear", "poa_eff", "poa_beam_eff" };
+        for (const char* name : poa_monthly_names)
+            agg.monthly_for_year(name, std::string("monthly_") + name, ts_hour);
+
+        agg.annual_for_year("dc_net", "annual_dc_net", ts_hour);
+        agg.annual_for_year("gen", "annual_ac_net", ts_hour);
+        const char* inv_loss_names[] = { "inv_cliploss", "dc_invmppt_loss", "inv_psoloss", "inv_pntloss", "inv_tdcloss" };
+        for (const char* name : inv_loss_names)
+            agg.annual_for_year(name, std::string("annual_") + name, ts_hour);
+
+        agg.compute();
+
+        double annual_poa_nom = agg.annual_value("annual_poa_nom");
+        double annual_poa_beam_nom = agg.annual_value("annual_poa_beam_nom");
+        double annual_poa_shaded = agg.annual_value("annual_poa_shaded");
+        double annual_poa_shaded_soiled = agg.annual_value("annual_poa_shaded_soiled");
+        double annual_poa_front = agg.annual_value("annual_poa_front");
+        double annual_poa_rear = agg.annual_value("annual_poa_rear");
+        double annual_poa_rear_ground_reflected = agg.annual_value("annual_poa_rear_ground_reflected");
+        double annual_poa_rear_row_reflections = agg.annual_value("annual_poa_rear_row_reflections");
+        double annual_poa_rear_direct_diffuse = agg.annual_value("annual_poa_rear_direct_diffuse");
+        double annual_poa_rear_self_shaded = agg.annual_value("annual_poa_rear_self_shaded");
+        double annual_poa_rear_rack_shaded = agg.annual_value("annual_poa_rear_rack_shaded");
+        double annual_poa_rear_soiled = agg.annual_value("annual_poa_rear_soiled");
+        double annual_ground_incident = agg.annual_value("annual_ground_incident");
+        double annual_ground_absorbed = agg.annual_value("annual_ground_absorbed");
+        double annual_bifacial_electrical_mismatch = agg.annual_value("annual_bifacial_electrical_mismatch");
+        double annual_poa_eff = agg.annual_value("annual_poa_eff");
+        double annual_poa_beam_eff = agg.annual_value("annual_poa_beam_eff");
+
+        double annual_dc_net = agg.annual_value("annual_dc_net");
+        double annual_inv_cliploss = agg.annual_value("annual_inv_cliploss");
+        double annual_inv_psoloss = agg.annual_value("annual_inv_psoloss");
+        double annual_inv_pntloss = agg.annual_value("annual_inv_pntloss");
+        double annual_inv_tdcloss = agg.annual_value("annual_inv_tdcloss");
 
         double nom_rad = Subarrays[0]->Module->isConcentratingPV ? annual_poa_beam_nom : annual_poa_nom;
         double inp_rad = Subarrays[0]->Module->isConcentratingPV ? annual_poa_beam_eff : annual_poa_eff;
@@ -171,34 +171,38 @@ static var_info _cm_vtab_pvwattsv8[] = {
 
 
         { SSC_INPUT,        SSC_NUMBER,      "batt_simple_enable",             "Enable Battery",                              "0/1",       "",                                             "System Design",     "?=0",                     "BOOLEAN",                        "" },
+
+        { SSC_INPUT,        SSC_ARRAY,       "batch_tilt",                     "Multi-configuration tilt angles",             "degrees",   "runs one configuration per entry instead of the single system, time series outputs are skipped","Multi-configuration","?", "",                              "" },
+        { SSC_INPUT,        SSC_ARRAY,       "batch_azimuth",                  "Multi-configuration azimuth angles",          "degrees",   "E=90,S=180,W=270",                             "Multi-configuration","a:batch_tilt",       "",                              "" },
+        { SSC_INPUT,        SSC_ARRAY,       "batch_dc_ac_ratio",              "Multi-configuration DC to AC ratios",         "ratio",     "defaults to dc_ac_ratio for every configuration","Multi-configuration","?",                 "",                              "" },
        
         /* outputs */
-        { SSC_OUTPUT,       SSC_ARRAY,       "gh",                             "Weather file global horizontal irradiance",                "W/m2",      "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "dn",                             "Weather file beam irradiance",                             "W/m2",      "",											   "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "df",                             "Weather file diffuse irradiance",                          "W/m2",      "",											   "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "tamb",                           "Weather file ambient temperature",                         "C",         "",										       "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "wspd",                           "Weather file wind speed",                                  "m/s",       "",											   "Time Series",      "*",                       "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "gh",                             "Weather file global horizontal irradiance",                "W/m2",      "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "dn",                             "Weather file beam irradiance",                             "W/m2",      "",											   "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "df",                             "Weather file diffuse irradiance",                          "W/m2",      "",											   "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "tamb",                           "Weather file ambient temperature",                         "C",         "",										       "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "wspd",                           "Weather file wind speed",                                  "m/s",       "",											   "Time Series",      "na:batch_tilt",           "",                          "" },
         { SSC_OUTPUT,       SSC_ARRAY,       "snow",                           "Weather file snow depth",                                  "cm",        "",										       "Time Series",      "",                        "",                          "" },
 
         { SSC_OUTPUT,       SSC_ARRAY,       "alb",                            "Albedo",                                  "",        "",										       "Time Series",      "",                        "",                          "" },
         { SSC_OUTPUT,       SSC_ARRAY,       "soiling_f",                 "Soiling factor",                                  "",        "",										       "Time Series",      "",                        "",                          "" },
 
-        { SSC_OUTPUT,       SSC_ARRAY,       "sunup",                          "Sun up over horizon",                         "0/1",       "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "shad_beam_factor",               "External shading factor for beam radiation",           "",          "",                                             "Time Series",      "*",                       "",                                     "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "ss_beam_factor",                 "Calculated self-shading factor for beam radiation",           "",          "1=no shading",                                             "Time Series",      "*",                       "",                                     "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "ss_sky_diffuse_factor",          "Calculated self-shading factor for sky diffuse radiation",           "",          "1=no shading",                                             "Time Series",      "*",                       "",                                     "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "ss_gnd_diffuse_factor",          "Calculated self-shading factor for ground-reflected diffuse radiation",           "",          "1=no shading",                                             "Time Series",      "*",                       "",                                     "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "aoi",                            "Angle of incidence",                          "degrees",       "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "poa",                            "Plane of array irradiance",                   "W/m2",      "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "tpoa",                           "Transmitted plane of array irradiance",       "W/m2",      "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "tcell",                          "Module temperature",                          "C",         "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "dcsnowderate",                   "DC power loss due to snow",            "%",         "",                                             "Time Series",      "*",                       "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "sunup",                          "Sun up over horizon",                         "0/1",       "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "shad_beam_factor",               "External shading factor for beam radiation",           "",          "",                                             "Time Series",      "na:batch_tilt",           "",                                     "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "ss_beam_factor",                 "Calculated self-shading factor for beam radiation",           "",          "1=no shading",                                             "Time Series",      "na:batch_tilt",           "",                                     "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "ss_sky_diffuse_factor",          "Calculated self-shading factor for sky diffuse radiation",           "",          "1=no shading",                                             "Time Series",      "na:batch_tilt",           "",                                     "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "ss_gnd_diffuse_factor",          "Calculated self-shading factor for ground-reflected diffuse radiation",           "",          "1=no shading",                                             "Time Series",      "na:batch_tilt",           "",                                     "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "aoi",                            "Angle of incidence",                          "degrees",       "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "poa",                            "Plane of array irradiance",                   "W/m2",      "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "tpoa",                           "Transmitted plane of array irradiance",       "W/m2",      "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "tcell",                          "Module temperature",                          "C",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "dcsnowderate",                   "DC power loss due to snow",            "%",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
 
-        { SSC_OUTPUT,       SSC_ARRAY,       "dc",                             "DC inverter input power",                              "W",         "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "ac",                             "AC inverter output power",                           "W",         "",                                             "Time Series",      "*",                       "",                          "" },
-        { SSC_OUTPUT,       SSC_ARRAY,       "ac_pre_adjust",                  "AC inverter output power before system availability",                           "W",         "",                                             "Time Series",      "*",                       "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "dc",                             "DC inverter input power",                              "W",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "ac",                             "AC inverter output power",                           "W",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "ac_pre_adjust",                  "AC inverter output power before system availability",                           "W",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
 
-        { SSC_OUTPUT,       SSC_ARRAY,       "inv_eff_output",                        "Inverter efficiency",                           "%",         "",                                             "Time Series",      "*",                       "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "inv_eff_output",                        "Inverter efficiency",                           "%",         "",                                             "Time Series",      "na:batch_tilt",           "",                          "" },
 
         { SSC_OUTPUT,       SSC_ARRAY,       "poa_monthly",                    "Plane of array irradiance",                   "kWh/m2",    "",                                             "Monthly",          "",                       "LENGTH=12",                          "" },
         { SSC_OUTPUT,       SSC_ARRAY,       "solrad_monthly",                 "Daily average solar irradiance",              "kWh/m2/day","",                                             "Monthly",          "",                       "LENGTH=12",                          "" },
@@ -216,6 +220,9 @@ static var_info _cm_vtab_pvwattsv8[] = {
         { SSC_OUTPUT,       SSC_NUMBER,      "capacity_factor_ac",             "Capacity factor based on total AC capacity",    "%",         "",                                           "Annual",        "",                       "",                          "" },
         { SSC_OUTPUT,       SSC_NUMBER,      "kwh_per_kw",                     "Energy yield",                           "kWh/kW",          "",                                             "Annual",        "",                       "",                          "" },
 
+        { SSC_OUTPUT,       SSC_ARRAY,       "batch_annual_energy",            "Multi-configuration annual energy",           "kWh",       "one value per configuration",                  "Multi-configuration","a:batch_tilt",      "",                          "" },
+        { SSC_OUTPUT,       SSC_ARRAY,       "batch_capacity_factor",          "Multi-configuration capacity factor based on nameplate DC capacity","%","one value per configuration",     "Multi-configuration","a:batch_tilt",      "",                          "" },
+
         { SSC_OUTPUT,       SSC_STRING,      "location",                       "Location ID",                                 "",          "",                                             "Location",      "*",                       "",                          "" },
         { SSC_OUTPUT,       SSC_STRING,      "city",                           "City",                                        "",          "",                                             "Location",      "*",                       "",                          "" },
         { SSC_OUTPUT,       SSC_STRING,      "state",                          "State",                                       "",          "",                                             "Location",      "*",                       "",                          "" },
@@ -374,6 +381,27 @@ public:
             return 0.0;
     }
 
+    // location, land area, and inverter outputs common to single and multi-configuration runs
+    void assign_site_outputs(const weather_header& hdr, double module_m2, float percent)
+    {
+        assign("location", var_data(hdr.location));
+        assign("city", var_data(hdr.city));
+        assign("state", var_data(hdr.state));
+        assign("lat", var_data((ssc_number_t)hdr.lat));
+        assign("lon", var_data((ssc_number_t)hdr.lon));
+        assign("tz", var_data((ssc_number_t)hdr.tz));
+        assign("elev", var_data((ssc_number_t)hdr.elev));
+        assign("percent_complete", var_data((ssc_number_t)percent));
+
+        double gcr_for_land = pv.gcr;
+        if (gcr_for_land < 0.01) gcr_for_land = 1.0;
+        double landf = is_assigned("landf") ? as_number("landf") : 1.0f;
+        assign("land_acres", var_data((ssc_number_t)(landf * module_m2 / gcr_for_land * 0.0002471)));
+
+        // for battery model, specify a number of inverters
+        assign("inverter_efficiency", var_data((ssc_number_t)(as_double("inv_eff"))));
+    }
+
     void exec()
     {
         std::unique_ptr<weather_data_provider> wdprov;
@@ -647,24 +675,10 @@ public:
             log(util::format("system size is too small to accurately estimate regular row-row self shading impacts. (estimates: #modules=%d, #rows=%d).  disabling self-shading calculations.",
             (int)pv.nmodules, (int)pv.nrows), SSC_WARNING);*/
 
-        pvsnowmodel snowmodel;
         bool en_snowloss = as_boolean("en_snowloss");
-        if (en_snowloss)
-        {
-            // check for snow model with non-annual simulations: because snow model coefficients need to know the timestep, and we don't know timestep if non-annual
-            if (!wdprov->annualSimulation())
-                log("Using the snow model with weather data that is not continuous over one year may result in over-estimation of snow losses.", SSC_WARNING);
-            // if tracking mode is 1-axis tracking,
-            // don't need to limit tilt angles
-            if (snowmodel.setup(pv.nmody,
-                (float)pv.tilt,
-                pv.type == FIXED_RACK || pv.type == FIXED_ROOF)) {
-
-                if (!snowmodel.good) {
-                    log(snowmodel.msg, SSC_ERROR);
-                }
-            }
-        }
+        // check for snow model with non-annual simulations: because snow model coefficients need to know the timestep, and we don't know timestep if non-annual
+        if (en_snowloss && !wdprov->annualSimulation())
+            log("Using the snow model with weather data that is not continuous over one year may result in over-estimation of snow losses.", SSC_WARNING);
 
         
 
@@ -676,10 +690,6 @@ public:
         shading_factor_calculator shad;
         if (!shad.setup(this, ""))
             throw exec_error("pvwattsv8", shad.get_error());
-        // self-shading initialization
-        sssky_diffuse_table ssSkyDiffuseTable;
-        if (en_self_shading)
-            ssSkyDiffuseTable.init(pv.tilt, pv.gcr);
 
         weather_header hdr;
         wdprov->header(&hdr);
@@ -779,599 +789,805 @@ public:
                 gf = 1.0;
         }
 
-        /* allocate output arrays */
-        ssc_number_t* p_gh = allocate("gh", nrec);
-        ssc_number_t* p_dn = allocate("dn", nrec);
-        ssc_number_t* p_df = allocate("df", nrec);
-        ssc_number_t* p_tamb = allocate("tamb", nrec);
-        ssc_number_t* p_wspd = allocate("wspd", nrec);
-        ssc_number_t* p_snow = allocate("snow", nrec);
-
-        ssc_number_t* p_sunup = allocate("sunup", nrec);
-        ssc_number_t* p_aoi = allocate("aoi", nrec);
-        ssc_number_t* p_shad_beam = allocate("shad_beam_factor", nrec); // just for reporting output
-        ssc_number_t* p_ss_beam = allocate("ss_beam_factor", nrec);
-        ssc_number_t* p_ss_sky_diffuse = allocate("ss_sky_diffuse_factor", nrec);
-        ssc_number_t* p_ss_gnd_diffuse = allocate("ss_gnd_diffuse_factor", nrec);
-        ssc_number_t* p_stow = allocate("tracker_stowing", nrec); // just for reporting output
-
-        ssc_number_t* p_tmod = allocate("tcell", nrec);
-        ssc_number_t* p_alb = allocate("alb", nrec);
-        ssc_number_t* p_soiling_f = allocate("soiling_f", nrec);
-        ssc_number_t* p_dcshadederate = allocate("dcshadederate", nrec);
-        ssc_number_t* p_dcsnowderate = allocate("dcsnowderate", nrec);
-        ssc_number_t* p_poa = allocate("poa", nrec);
-        ssc_number_t* p_tpoa = allocate("tpoa", nrec);
-        ssc_number_t* p_dc = allocate("dc", nrec);
-        ssc_number_t* p_ac = allocate("ac", nrec);
-        ssc_number_t* p_ac_pre_adjust = allocate("ac_pre_adjust", nrec);
-        ssc_number_t* p_inv_eff = allocate("inv_eff_output", nrec);
-        ssc_number_t* p_gen = allocate("gen", nlifetime);
+        int track_mode = 0;
+        switch (pv.type)
+        {
+        case FIXED_RACK:
+        case FIXED_ROOF:
+            track_mode = 0;
+            break;
+        case ONE_AXIS:
+        case ONE_AXIS_BACKTRACKING:
+            track_mode = 1;
+            break;
+        case TWO_AXIS:
+            track_mode = 2;
+            break;
+        case AZIMUTH_AXIS:
+            track_mode = 3;
+            break;
+        }
 
-        double annual_kwh = 0;
+        // self-shading inputs do not change with timestep
+        ssinputs ssin;
+        ssin.nstrx = (int)(((double)pv.nmodx) / pv.nmodperstr);
+        ssin.nmodx = pv.nmodx;
+        ssin.nmody = pv.nmody;
+        ssin.nrows = pv.nrows;
+        ssin.length = module.length;
+        ssin.width = module.width;
+        ssin.mod_orient = 0; // portrait module orientation
+        ssin.str_orient = 1; // horizontal stringing
+        ssin.row_space = pv.row_spacing;
+        ssin.ndiode = module.ndiode;
+        ssin.Vmp = module.vmp;
+        ssin.mask_angle_calc_method = 0; // worst case mask angle assumption
+        ssin.FF0 = module.ff;
+
+        // inverter model, rated at the AC nameplate of a system configuration
+        auto make_inverter = [&](double ac_nameplate)
+        {
+            sandia_inverter_t inverter;
+            inverter.Paco = ac_nameplate;
+            inverter.Pdco = inverter.Paco / (pv.inv_eff_percent * 0.01); // get inverter DC rating by dividing AC rating by efficiency
+            // set both Vdco and Vdc to zero. the assumption we make for voltages are irrelevant as long as C1, C2, and C3 are zero
+            inverter.Vdco = 0.0;
+            inverter.Pntare = 0.0; // simplifying assumption that inverter has no nighttime losses
+            // default values for C1, C2, C3 are zero per Sandia documentation: https://pvpmc.sandia.gov/modeling-steps/dc-to-ac-conversion/sandia-inverter-model/
+            // setting these to 0 results in similar inverter output to pvwattsv5
+            inverter.C1 = 0.0;
+            inverter.C2 = 0.0;
+            inverter.C3 = 0.0;
+
+            // Set based on market per ssc issue 870
+            inverter.Pso = 0.0; // simplifying assumption that the inverter can always operate - needed for knee
+            inverter.C0 = 0.0; // needed for curvature - voltage needed for this parameter to be used
+
+            if (pv.dc_nameplate < 10) { // Residential
+                inverter.Pso = 0.002246 * inverter.Paco;
+            }
+            else if (pv.dc_nameplate < 1000) { // Commercial >= 10kW
+                inverter.Pso = 0.002478 * inverter.Paco;
+            }
+            else { // Utility >= 1MW
+                inverter.Pso = 0.004931 * inverter.Paco;
+            }
+            return inverter;
+        };
 
-        size_t idx_life = 0;
-        float percent = 0;
+        // use wf albedo if use_wf_albedo is true and wf albedo is valid
+        // use user albedo if use_wf_albedo is false and user albedo is valid
+        // otherwise use default albedo (snow or no snow)
         int n_alb_errs = 0;
-        for (size_t y = 0; y < nyears; y++)
+        auto step_albedo = [&](const weather_record& wf, size_t idx)
         {
-            for (size_t idx = 0; idx < nrec; idx++)
+            double alb = 0;
+            if (use_wf_albedo)
             {
-                if (!wdprov->read(&wf))
-                    throw exec_error("pvwattsv8", util::format("could not read data line %d of %d in weather file", (int)(idx + 1), (int)nrec));
-                size_t hour_of_year = util::hour_of_year(wf.month, wf.day, wf.hour);
-
-#define NSTATUS_UPDATES 50  // set this to the number of times a progress update should be issued for the simulation
-                if (nrec > 50) //avoid divide by zero problems in the following if statement- probably don't need a lot of updates otherwise
+                if ((std::isfinite(wf.alb) && (wf.alb > 0 && wf.alb < 1)))
+                    alb = wf.alb;
+                else
+                    n_alb_errs++;
+            }
+            else
+            {
+                if (albedo_len == 1)
+                    alb = albedo[0];
+                else if (albedo_len == 12)
+                    alb = albedo[wf.month - 1];
+                else if (albedo_len == nrec)
+                    alb = albedo[idx];
+                else if (is_assigned("albedo") && (idx == 0)) // display warning once
+                    log(util::format("Albedo input array is not the correct length (1, 12, or %d entries). "
+                        "Using default albedo value of %f (snow) or %f (no snow). "
+                        "[year:%d month:%d day:%d hour:%d minute:%lg]. ",
+                        nrec, as_double("albedo_default_snow"), as_double("albedo_default"),
+                        wf.year, wf.month, wf.day, wf.hour, wf.minute), SSC_NOTICE);
+            }
+            if (alb <= 0 || alb >= 1)
+            {
+                if (std::isfinite(wf.snow) && wf.snow > 0.5 && wf.snow < 999 && en_snowloss)
+                    alb = as_double("albedo_default_snow");
+                else
+                    alb = as_double("albedo_default");
+                if (!use_wf_albedo && n_alb_errs < 5) // display warning up to 5 times
                 {
-                    if (idx % (nrec / NSTATUS_UPDATES) == 0)
-                    {
-                        percent = 100.0f * ((float)idx_life + 1) / ((float)nlifetime); //3 is the number of technologies we're assuming for this output (pvwatts + fuel cell + battery)
-                        // check percentage
-                        if (percent > 100.0f) percent = 99.0f;
-                        if (!update("", percent, (float)hour_of_year))
-                            throw exec_error("pvwattsv8", "Simulation stopped at hour " + util::to_string(hour_of_year + 1.0));
-                    }
+                    log(util::format("Albedo input value is not valid for time step %d. Using default albedo value of %f (snow) or %f (no snow). This warning only appears for the first five instances of this error.", idx, as_double("albedo_default_snow"), as_double("albedo_default")), SSC_NOTICE);
+                    n_alb_errs++;
                 }
+            }
+            return alb;
+        };
 
-                bool tracker_stowing = false;
-
-                p_gh[idx] = (ssc_number_t)wf.gh;
-                p_dn[idx] = (ssc_number_t)wf.dn;
-                p_df[idx] = (ssc_number_t)wf.df;
-                p_tamb[idx] = (ssc_number_t)wf.tdry;
-                p_wspd[idx] = (ssc_number_t)wf.wspd;
-                p_snow[idx] = (ssc_number_t)wf.snow; // if there is no snow data in the weather file, this will be NaN- consistent with pvsamv1
-                p_tmod[idx] = (ssc_number_t)wf.tdry;
-
-                // use wf albedo if use_wf_albedo is true and wf albedo is valid
-                // use user albedo if use_wf_albedo is false and user albedo is valid
-                // otherwise use default albedo (snow or no snow)
-                double alb = 0;
-                if (use_wf_albedo)
-                {
-                    if ((std::isfinite(wf.alb) && (wf.alb > 0 && wf.alb < 1)))
-                        alb = wf.alb;
-                    else
-                        n_alb_errs++;
+#define NSTATUS_UPDATES 50  // set this to the number of times a progress update should be issued for the simulation
+
+        // system configurations: a single system run has one, and multi-configuration mode evaluates many tilt, azimuth,
+        // and DC to AC ratio combinations in one pass over the weather data. the weather records, albedo, sun position, and
+        // external beam shading do not depend on the configuration, so they are calculated once per time step and shared.
+        // multi-configuration mode reports first year annual energy for each configuration and skips the time series outputs
+        // and loss diagram, except for gen, which is reported over the analysis period for the first configuration
+        struct system_config {
+            double tilt, azimuth;
+            double ac_nameplate;
+            double xfmr_rating;
+            sandia_inverter_t inverter;
+            sssky_diffuse_table ssSkyDiffuseTable;
+            pvsnowmodel snowmodel;
+            double annual_kwh; // first year
+        };
+
+        bool batch = is_assigned("batch_tilt");
+        std::vector<double> config_tilt(1, pv.tilt), config_azimuth(1, pv.azimuth), config_dc_ac_ratio(1, pv.dc_ac_ratio);
+        if (batch)
+        {
+            if (!wdprov->annualSimulation())
+                throw exec_error("pvwattsv8", "Multi-configuration mode requires weather data that is continuous over one year.");
+
+            config_tilt = as_vector_double("batch_tilt");
+            config_azimuth = as_vector_double("batch_azimuth");
+            config_dc_ac_ratio = is_assigned("batch_dc_ac_ratio") ? as_vector_double("batch_dc_ac_ratio") : std::vector<double>(config_tilt.size(), pv.dc_ac_ratio);
+            if (config_tilt.empty() || config_azimuth.size() != config_tilt.size() || config_dc_ac_ratio.size() != config_tilt.size())
+                throw exec_error("pvwattsv8", "Multi-configuration tilt, azimuth, and DC to AC ratio arrays must be nonempty and have the same length.");
+        }
+
+        size_t nconfig = config_tilt.size();
+        std::vector<system_config> configs(nconfig);
+        for (size_t c = 0; c < nconfig; c++)
+        {
+            if (batch && (config_tilt[c] < 0 || config_tilt[c] > 90 || config_azimuth[c] < 0 || config_azimuth[c] >= 360 || config_dc_ac_ratio[c] <= 0))
+                throw exec_error("pvwattsv8", util::format("Multi-configuration %d is invalid: tilt must be 0 to 90 degrees, azimuth 0 to less than 360 degrees, and DC to AC ratio positive.", (int)c));
+
+            system_config& cfg = configs[c];
+            cfg.tilt = config_tilt[c];
+            cfg.azimuth = config_azimuth[c];
+            cfg.ac_nameplate = pv.dc_nameplate / config_dc_ac_ratio[c];
+            cfg.xfmr_rating = cfg.ac_nameplate; // hardcoded to be equal to ac_nameplate, as pv.xfmr_rating
+            cfg.inverter = make_inverter(cfg.ac_nameplate);
+            cfg.annual_kwh = 0.0;
+
+            // self-shading initialization
+            if (en_self_shading)
+                cfg.ssSkyDiffuseTable.init(cfg.tilt, pv.gcr);
+
+            // if tracking mode is 1-axis tracking,
+            // don't need to limit tilt angles
+            if (en_snowloss && cfg.snowmodel.setup(pv.nmody,
+                (float)cfg.tilt,
+                pv.type == FIXED_RACK || pv.type == FIXED_ROOF)) {
+
+                if (!cfg.snowmodel.good) {
+                    log(cfg.snowmodel.msg, SSC_ERROR);
                 }
+            }
+        }
+
+        // conditions at one time step that are shared by all configurations
+        struct step_conditions {
+            size_t idx, idx_life, hour_of_year;
+            double alb;
+            double solazi, solzen, solalt;
+            int sunup;
+            double shad_beam;
+            double soiling_f;
+        };
+
+        // irradiance, temperature, and DC power of one configuration at one time step
+        struct step_result {
+            double aoi, poa, tpoa, tmod;
+            double dc; // before degradation (W)
+            bool tracker_stowing;
+            double ss_beam, ss_sky_diffuse, ss_gnd_diffuse;
+            double f_nonlinear, f_snow;
+        };
+
+        // one irradiance processor for the whole simulation, so the rear side view factors carry over between time steps
+        irrad irr;
+        irr.set_surface(track_mode, configs[0].tilt, configs[0].azimuth, pv.rotlim,
+            pv.type == ONE_AXIS_BACKTRACKING, pv.gcr, 0.0, 0.0, false, 0.0);
+
+        auto step_sun = [&](const weather_record& wf, step_conditions& s)
+        {
+            s.alb = step_albedo(wf, s.idx);
+
+            irr.set_time(wf.year, wf.month, wf.day, wf.hour, wf.minute,
+                instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour);
+            irr.set_location(hdr.lat, hdr.lon, hdr.tz);
+            irr.set_optional(hdr.elev, wf.pres, wf.tdry);
+            irr.set_sky_model(irrad::PEREZ, s.alb);
+            irr.set_beam_diffuse(wf.dn, wf.df);
+
+            // the sun position does not depend on the surface orientation
+            int code = irr.calc_sun();
+            if (0 != code)
+                throw exec_error("pvwattsv8",
+                    util::format("Failed to process irradiation on surface (code: %d) [year:%d month:%d day:%d hour:%d minute:%lg].",
+                        code, wf.year, wf.month, wf.day, wf.hour, wf.minute));
+
+            irr.get_sun(&s.solazi, &s.solzen, &s.solalt, nullptr, nullptr, nullptr, &s.sunup, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
+
+            s.shad_beam = 1.0;
+            if (shad.fbeam(s.hour_of_year, wf.minute, s.solalt, s.solazi))
+                s.shad_beam = shad.beam_shade_factor();
+
+            s.soiling_f = 0.0;
+            if (is_assigned("soiling"))
+            {
+                if (soiling_len == 1)
+                    s.soiling_f = soiling[0] * 0.01; //convert from percentage to decimal
+                else if (soiling_len == 12)
+                    s.soiling_f = soiling[wf.month - 1] * 0.01; //convert from percentage to decimal
+                else if (soiling_len == nrec)
+                    s.soiling_f = soiling[s.idx] * 0.01; //convert from percentage to decimal
                 else
+                    throw exec_error("pvwattsv8", "Soiling input array must have 1, 12, or nrecords values.");
+            }
+        };
+
+        // losses are added to the loss diagram only when record_losses is set,
+        // and per time step notices are only logged for the first configuration
+        auto step_dc = [&](const weather_record& wf, const step_conditions& s, system_config& cfg, bool record_losses, bool log_notices, step_result& r)
+        {
+            irr.set_surface(track_mode, cfg.tilt, cfg.azimuth, pv.rotlim,
+                pv.type == ONE_AXIS_BACKTRACKING, // backtracking mode
+                pv.gcr, 0.0, 0.0, false, 0.0);
+
+            int code = irr.calc_surface();
+
+            //create variables to store outputs
+            double aoi, stilt, sazi, rot, btd;
+            double ibeam = 0.0, iskydiff = 0.0, ignddiff = 0.0, irear = 0.0;
+
+            irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
+            irr.get_poa(&ibeam, &iskydiff, &ignddiff, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
+
+            if (module.bifaciality > 0)
+            {
+                irr.calc_rear_side(bifacialTransmissionFactor, 1, module.length * pv.nmody);
+                irear = irr.get_poa_rear() * module.bifaciality; //total rear irradiance is returned, so must multiply module bifaciality
+            }
+
+            if (-1 == code)
+            {
+                if (log_notices)
+                    log(util::format("Beam irradiance exceeded extraterrestrial value at record [year:%d month:%d day:%d hour:%d minute:%lg].",
+                        wf.year, wf.month, wf.day, wf.hour, wf.minute));
+            }
+            else if (0 != code)
+                throw exec_error("pvwattsv8",
+                    util::format("Failed to process irradiation on surface (code: %d) [year:%d month:%d day:%d hour:%d minute:%lg].",
+                        code, wf.year, wf.month, wf.day, wf.hour, wf.minute));
+
+            r.aoi = aoi;
+            r.poa = 0;
+            r.tpoa = 0;
+            r.tmod = wf.tdry;
+            r.dc = 0;
+            r.tracker_stowing = false;
+            r.ss_beam = r.ss_sky_diffuse = r.ss_gnd_diffuse = 1.0;
+            r.f_nonlinear = r.f_snow = 1.0;
+
+            if (s.sunup <= 0)
+                return;
+
+            // save the total available POA for the loss diagram
+            if (record_losses) ld("poa_nominal") += (ibeam + iskydiff + ignddiff) * wm2_to_wh;
+            if (record_losses) ld("poa_loss_bifacial") += (-irear) * wm2_to_wh;
+
+
+            // check for wind stowing on trackers
+            if ((pv.type == ONE_AXIS
+                || pv.type == ONE_AXIS_BACKTRACKING
+                || pv.type == TWO_AXIS)
+                && std::isfinite(wf.wspd) && wf.wspd > 0
+                && std::isfinite(wstow)
+                && enable_wind_stow)
+            {
+                double gust = gf * wf.wspd;
+
+                if (gust > wstow)
                 {
-                    if (albedo_len == 1)
-                        alb = albedo[0];
-                    else if (albedo_len == 12)
-                        alb = albedo[wf.month - 1];
-                    else if (albedo_len == nrec)
-                        alb = albedo[idx];
-                    else if (is_assigned("albedo") && (idx == 0)) // display warning once
-                        log(util::format("Albedo input array is not the correct length (1, 12, or %d entries). "
-                            "Using default albedo value of %f (snow) or %f (no snow). "
-                            "[year:%d month:%d day:%d hour:%d minute:%lg]. ",
-                            nrec, as_double("albedo_default_snow"), as_double("albedo_default"),
-                            wf.year, wf.month, wf.day, wf.hour, wf.minute), SSC_NOTICE);
-                }
-                if (alb <= 0 || alb >= 1)
-                {
-                    if (std::isfinite(wf.snow) && wf.snow > 0.5 && wf.snow < 999 && en_snowloss)
-                        alb = as_double("albedo_default_snow");
+                    // save poa before going into stow position
+                    double poa_no_stow = ibeam + iskydiff + ignddiff;
+
+                    if (pv.type == TWO_AXIS)
+                    {
+                        // two axis tracker stows at the horizontal position
+                        // easiest way to do this in two dimensions is to set it as a flat fixed tilt system
+                        // because the force to stow flag only fixes one rotation angle, not both
+                        irr.set_surface(irrad::FIXED_TILT, // tracking 0=fixed
+                            0, 180, // tilt, azimuth
+                            0, 0, 0.4, 0.0, 0.0, false, 0.0); // rotlim, bt, gcr, force to stow, stow angle
+                    }
                     else
-                        alb = as_double("albedo_default");
-                    if (!use_wf_albedo && n_alb_errs < 5) // display warning up to 5 times
                     {
-                        log(util::format("Albedo input value is not valid for time step %d. Using default albedo value of %f (snow) or %f (no snow). This warning only appears for the first five instances of this error.", idx, as_double("albedo_default_snow"), as_double("albedo_default")), SSC_NOTICE);
-                        n_alb_errs++;
+                        // one axis tracker stows at a prescribed rotation angle,
+                        // but still need to consider the rotation axis tilt and azimuth
+                        double stow_angle = std::abs(wind_stow_angle_deg);
+                        if (rot < 0) stow_angle = -stow_angle;  // go to stow in the same direction of current tracker position
+
+                        irr.set_surface(irrad::SINGLE_AXIS, cfg.tilt, cfg.azimuth,
+                            stow_angle, // rotation angle limit, the forced stow position
+                            false, // backtracking mode
+                            pv.gcr, 0.0, 0.0,
+                            true, stow_angle  // force tracker to the rotation limit (stow_angle here)
+                        );
                     }
-                }
 
-                // report albedo value as output
-                p_alb[idx] = (ssc_number_t)alb;
+                    irr.calc_surface(); // recalculate POA and aoi, and rear side irradiance if bifacial, in the new stow position
 
-                irrad irr;
-                irr.set_time(wf.year, wf.month, wf.day, wf.hour, wf.minute,
-                    instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour);
-                irr.set_location(hdr.lat, hdr.lon, hdr.tz);
-                irr.set_optional(hdr.elev, wf.pres, wf.tdry);
-                irr.set_sky_model(irrad::PEREZ, alb);
-                irr.set_beam_diffuse(wf.dn, wf.df);
+                    double irear_stow = 0.0;
+                    if (module.bifaciality > 0)
+                    {
+                        irr.calc_rear_side(bifacialTransmissionFactor, 1, module.length * pv.nmody);
+                        irear_stow = irr.get_poa_rear() * module.bifaciality; //total rear irradiance is returned, so must multiply module bifaciality
+                    }
 
-                int track_mode = 0;
-                switch (pv.type)
-                {
-                case FIXED_RACK:
-                case FIXED_ROOF:
-                    track_mode = 0;
-                    break;
-                case ONE_AXIS:
-                case ONE_AXIS_BACKTRACKING:
-                    track_mode = 1;
-                    break;
-                case TWO_AXIS:
-                    track_mode = 2;
-                    break;
-                case AZIMUTH_AXIS:
-                    track_mode = 3;
-                    break;
+                    irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
+                    irr.get_poa(&ibeam, &iskydiff, &ignddiff, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
+                    double poa_stow = ibeam + iskydiff + ignddiff;
+
+                    double stow_loss = (poa_no_stow - poa_stow) + (irear - irear_stow);
+                    if (record_losses) ld("poa_loss_tracker_stow") += stow_loss * wm2_to_wh;
+                    irear = irear_stow;
+                    r.tracker_stowing = true;
                 }
+            }
+
+            // apply hourly external shading factors to beam (if none enabled, factors are 1.0)
+            if (record_losses) ld("poa_loss_ext_beam_shade") += ibeam * (1.0 - s.shad_beam) * wm2_to_wh;
+            ibeam *= s.shad_beam;
+
+            // apply hourly external sky diffuse shading factor (specified as constant, nominally 1.0 if disabled in UI)
+            if (record_losses) ld("poa_loss_ext_diff_shade") += (iskydiff + ignddiff) * (1.0 - shad.fdiff()) * wm2_to_wh;
+            iskydiff *= shad.fdiff();
 
-                irr.set_surface(track_mode, pv.tilt, pv.azimuth, pv.rotlim,
-                    pv.type == ONE_AXIS_BACKTRACKING, // backtracking mode
-                    pv.gcr, 0.0, 0.0, false, 0.0);
+            // also applies to back irradiance if sky is blocked
+            irear *= shad.fdiff();
 
-                int code = irr.calc();
+            // save the unselfshaded beam irradiance if nonlinear losses are calculated
+            // to avoid double counting the beam irradiance loss when calculating module power output
+            double ibeam_unselfshaded = ibeam;
 
-                //create variables to store outputs
-                double solazi, solzen, solalt, aoi, stilt, sazi, rot, btd;
-                int sunup;
-                double ibeam = 0.0, iskydiff = 0.0, ignddiff = 0.0, irear = 0.0;
-                double poa = 0.0, tpoa = 0.0, tmod = 0.0, dc = 0.0, ac = 0.0;
+            // calculate any self-shading effects in fixed or tracking regular row systems
+            double f_nonlinear = 1.0; //nonlinear shading factor, 1 for no shading
+            double Fskydiff = 1.0; //shading factor for sky diffuse, 1 for no shading
+            double Fgnddiff = 1.0; //shading factor for ground-reflected diffuse, 1 for no shading
 
-                irr.get_sun(&solazi, &solzen, &solalt, nullptr, nullptr, nullptr, &sunup, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
-                irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
-                irr.get_poa(&ibeam, &iskydiff, &ignddiff, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
 
-                if (module.bifaciality > 0)
+            if (en_self_shading) //shading applies in each of these three cases- see reference implementation in pvsamv1
+                //&& (pv.nrows >= 10) // note that enabling self-shading for small systems might be suspicious
+                // because the intent of the self-shading algorithms used here are to apply to large systems
+                // however, some testing of the self-shading algorithms for smaller systems doesn't reveal any wildly wrong behavior,
+                // so enabling it for all systems sizes to prevent confusion to users
+            {
+                // first calculate linear shading for one-axis trackers for use in self-shading algorithms
+                double shad1xf = 0.0; // default: zero shade fraction
+                if (pv.type == ONE_AXIS)
                 {
-                    irr.calc_rear_side(bifacialTransmissionFactor, 1, module.length * pv.nmody);
-                    irear = irr.get_poa_rear() * module.bifaciality; //total rear irradiance is returned, so must multiply module bifaciality
+                    shad1xf = shadeFraction1x(s.solazi, s.solzen, cfg.tilt, cfg.azimuth, pv.gcr, rot, 0.0, 0.0);
                 }
 
-                if (-1 == code)
+                // run self-shading calculations for both FIXED_RACK and ONE_AXIS because the non-linear derate applies in both cases (below)
+                ssoutputs ssout;
+
+                if (!ss_exec(ssin,
+                    stilt, sazi, //surface tilt and azimuth
+                    s.solzen, s.solazi, //solar zenith and azimuth
+                    wf.dn, // Gb_nor (e.g. DNI)
+                    wf.df, //Gdh (e.g. DHI)
+                    ibeam * (1.0 - shad1xf), // Gb_poa
+                    iskydiff, //poa_sky
+                    ignddiff, // poa_gnd
+                    s.alb,
+                    pv.type == ONE_AXIS, // is tracking system?
+                    module.type == THINFILM,  // is linear shading? (only with long cell thin films)
+                    shad1xf,
+                    cfg.ssSkyDiffuseTable,
+                    ssout))
                 {
-                    log(util::format("Beam irradiance exceeded extraterrestrial value at record [year:%d month:%d day:%d hour:%d minute:%lg].",
-                        wf.year, wf.month, wf.day, wf.hour, wf.minute));
+                    throw exec_error("pvwattsv8", util::format("Self-shading calculation failed at %d.", (int)s.idx_life));
                 }
-                else if (0 != code)
-                    throw exec_error("pvwattsv8",
-                        util::format("Failed to process irradiation on surface (code: %d) [year:%d month:%d day:%d hour:%d minute:%lg].",
-                            code, wf.year, wf.month, wf.day, wf.hour, wf.minute));
-
-                p_sunup[idx] = (ssc_number_t)sunup;
-                p_aoi[idx] = (ssc_number_t)aoi;
 
-                double shad_beam = 1.0;
-                if (shad.fbeam(hour_of_year, wf.minute, solalt, solazi))
-                    shad_beam = shad.beam_shade_factor();
+                // fixed tilt system with linear self-shading: beam is derated by fixed shade fraction
+                // fixed tilt non-linear self-shading, beam would NOT usually be derated, because non-linear dc derate accounts for it
+                // however, to be able to distinguish between irradiance and non-linear shading in loss diagram:
+                // we will apply it here, BUT, we will use an un-self-shaded irradiance in the power calculations later
+                // so that the loss isn't double counted.
+                if (pv.type == FIXED_RACK)
+                {
+                    if (record_losses) ld("poa_loss_self_beam_shade") += ibeam * ssout.m_shade_frac_fixed * wm2_to_wh;
+                    ibeam *= (1 - ssout.m_shade_frac_fixed);
+                    r.ss_beam = 1 - ssout.m_shade_frac_fixed;
+                }
 
-                p_shad_beam[idx] = (ssc_number_t)shad_beam;
-                p_ss_beam[idx] = (ssc_number_t)1.0;
-                p_ss_sky_diffuse[idx] = (ssc_number_t)1.0;
-                p_ss_gnd_diffuse[idx] = (ssc_number_t)1.0;
+                // one-axis true tracking system with linear self-shading: beam is derated by linear shade fraction for 1-axis trackers
+                // one-axis non-linear self-shading, beam would NOT usually be derated, because non-linear dc derate accounts for it
+                // however, to be able to distinguish between irradiance and non-linear shading in loss diagram:
+                // we will apply it here, BUT, we will use an un-self-shaded irradiance in the power calculations later
+                // so that the loss isn't double counted.
+                else if (pv.type == ONE_AXIS)
+                {
+                    if (record_losses) ld("poa_loss_self_beam_shade") += ibeam * shad1xf * wm2_to_wh;
+                    ibeam *= (1 - shad1xf);
+                    r.ss_beam = 1 - shad1xf;
+                }
 
-                if (sunup > 0)
+                // for non-linear self-shading (fixed and one-axis, but not backtracking)
+                // the non-linear dc derate is calculated and we need to save it for later
+                /*if ((pv.type == FIXED_RACK || pv.type == ONE_AXIS) && module.type != THINFILM)
                 {
-                    // save the total available POA for the loss diagram
-                    if (y == 0 && wdprov->annualSimulation()) ld("poa_nominal") += (ibeam + iskydiff + ignddiff) * wm2_to_wh;
-                    if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_bifacial") += (-irear) * wm2_to_wh;
-
-
-                    // check for wind stowing on trackers
-                    if ((pv.type == ONE_AXIS
-                        || pv.type == ONE_AXIS_BACKTRACKING
-                        || pv.type == TWO_AXIS)
-                        && std::isfinite(wf.wspd) && wf.wspd > 0
-                        && std::isfinite(wstow)
-                        && enable_wind_stow)
-                    {
-                        double gust = gf * wf.wspd;
-
-                        if (gust > wstow)
-                        {
-                            // save poa before going into stow position
-                            double poa_no_stow = ibeam + iskydiff + ignddiff;
-
-                            if (pv.type == TWO_AXIS)
-                            {
-                                // two axis tracker stows at the horizontal position
-                                // easiest way to do this in two dimensions is to set it as a flat fixed tilt system
-                                // because the force to stow flag only fixes one rotation angle, not both
-                                irr.set_surface(irrad::FIXED_TILT, // tracking 0=fixed
-                                    0, 180, // tilt, azimuth
-                                    0, 0, 0.4, 0.0, 0.0, false, 0.0); // rotlim, bt, gcr, force to stow, stow angle
-                            }
-                            else
-                            {
-                                // one axis tracker stows at a prescribed rotation angle,
-                                // but still need to consider the rotation axis tilt and azimuth
-                                double stow_angle = std::abs(wind_stow_angle_deg);
-                                if (rot < 0) stow_angle = -stow_angle;  // go to stow in the same direction of current tracker position
-
-                                irr.set_surface(irrad::SINGLE_AXIS, pv.tilt, pv.azimuth,
-                                    stow_angle, // rotation angle limit, the forced stow position
-                                    false, // backtracking mode
-                                    pv.gcr, 0.0, 0.0,
-                                    true, stow_angle  // force tracker to the rotation limit (stow_angle here)
-                                );
-                            }
-
-                            irr.calc(); // recalculate POA and aoi, and rear side irradiance if bifacial, in the new stow position
-
-                            double irear_stow = 0.0;
-                            if (module.bifaciality > 0)
-                            {
-                                irr.calc_rear_side(bifacialTransmissionFactor, 1, module.length * pv.nmody);
-                                irear_stow = irr.get_poa_rear() * module.bifaciality; //total rear irradiance is returned, so must multiply module bifaciality
-                            }
-
-                            irr.get_angles(&aoi, &stilt, &sazi, &rot, &btd);
-                            irr.get_poa(&ibeam, &iskydiff, &ignddiff, nullptr, nullptr, nullptr); //nullptr used when you don't need to retrieve the output
-                            double poa_stow = ibeam + iskydiff + ignddiff;
-
-                            double stow_loss = (poa_no_stow - poa_stow) + (irear - irear_stow);
-                            if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_tracker_stow") += stow_loss * wm2_to_wh;
-                            irear = irear_stow;
-                            tracker_stowing = true;
-                        }
-                    }
+                    f_nonlinear = ssout.m_dc_derate;
+                }*/ //disconnecting non-linear shading for now due to possible bug in non-linear shading algorithm resulting in 9% loss in annual energy compared to linear case for large systems
 
-                    // apply hourly external shading factors to beam (if none enabled, factors are 1.0)
-                    if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_ext_beam_shade") += ibeam * (1.0 - shad_beam) * wm2_to_wh;
-                    ibeam *= shad_beam;
+                // for backtracked systems, there is no beam irradiance reduction or non-linear DC derate
+                // however, sky and ground-reflected diffuse are still blocked, so apply those to everything below
 
-                    // apply hourly external sky diffuse shading factor (specified as constant, nominally 1.0 if disabled in UI)
-                    if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_ext_diff_shade") += (iskydiff + ignddiff) * (1.0 - shad.fdiff()) * wm2_to_wh;
-                    iskydiff *= shad.fdiff();
+                // always derate diffuse for any self-shaded system,
+                // due to inter-row blocking of sky and ground view factors.
+                // the derates are calculated by the lib_pvshade.cpp:diffuse_reduce() function and are
+                // purely geometric - apply independent of whether DC derate loss is linear or nonlinear
+                Fskydiff = ssout.m_diffuse_derate;
+                Fgnddiff = ssout.m_reflected_derate;
 
-                    // also applies to back irradiance if sky is blocked
-                    irear *= shad.fdiff();
+            }
 
-                    // save the unselfshaded beam irradiance if nonlinear losses are calculated
-                    // to avoid double counting the beam irradiance loss when calculating module power output
-                    double ibeam_unselfshaded = ibeam;
+            // apply derate factors to diffuse
+            if (Fskydiff >= -0.00001 && Fskydiff <= 1.00001) //include tolerances due to double representation
+            {
+                if (record_losses) ld("poa_loss_self_diff_shade") += (1.0 - Fskydiff) * (iskydiff + irear) * wm2_to_wh; //irear is zero if not bifacial
+                iskydiff *= Fskydiff;
+                irear *= Fskydiff;
+                r.ss_sky_diffuse = Fskydiff;
+            }
+            else if (log_notices) log(util::format("Sky diffuse reduction factor invalid at time %lg: fskydiff=%lg, stilt=%lg.", s.idx, Fskydiff, stilt), SSC_NOTICE, (float)s.idx);
 
-                    // calculate any self-shading effects in fixed or tracking regular row systems
-                    double f_nonlinear = 1.0; //nonlinear shading factor, 1 for no shading
-                    double Fskydiff = 1.0; //shading factor for sky diffuse, 1 for no shading
-                    double Fgnddiff = 1.0; //shading factor for ground-reflected diffuse, 1 for no shading
+            if (Fgnddiff >= -0.00001 && Fgnddiff <= 1.00001) //include tolerances due to double representation
+            {
+                if (record_losses) ld("poa_loss_self_diff_shade") += (1.0 - Fgnddiff) * ignddiff * wm2_to_wh;
+                ignddiff *= Fgnddiff;
+                r.ss_gnd_diffuse = Fgnddiff;
+            }
+            else if (log_notices) log(util::format("Ground diffuse reduction factor invalid at time %lg: fgnddiff=%lg, stilt=%lg.", s.idx, Fgnddiff, stilt), SSC_NOTICE, (float)s.idx);
 
 
-                    if (en_self_shading) //shading applies in each of these three cases- see reference implementation in pvsamv1
-                        //&& (pv.nrows >= 10) // note that enabling self-shading for small systems might be suspicious
-                        // because the intent of the self-shading algorithms used here are to apply to large systems
-                        // however, some testing of the self-shading algorithms for smaller systems doesn't reveal any wildly wrong behavior,
-                        // so enabling it for all systems sizes to prevent confusion to users
-                    {
-                        // first calculate linear shading for one-axis trackers for use in self-shading algorithms
-                        double shad1xf = 0.0; // default: zero shade fraction
-                        if (pv.type == ONE_AXIS)
-                        {
-                            shad1xf = shadeFraction1x(solazi, solzen, pv.tilt, pv.azimuth, pv.gcr, rot, 0.0, 0.0);
-                        }
-
-                        // run self-shading calculations for both FIXED_RACK and ONE_AXIS because the non-linear derate applies in both cases (below)
-                        ssinputs ssin;
-                        ssin.nstrx = (int)(((double)pv.nmodx) / pv.nmodperstr);
-                        ssin.nmodx = pv.nmodx;
-                        ssin.nmody = pv.nmody;
-                        ssin.nrows = pv.nrows;
-                        ssin.length = module.length;
-                        ssin.width = module.width;
-                        ssin.mod_orient = 0; // portrait module orientation
-                        ssin.str_orient = 1; // horizontal stringing
-                        ssin.row_space = pv.row_spacing;
-                        ssin.ndiode = module.ndiode;
-                        ssin.Vmp = module.vmp;
-                        ssin.mask_angle_calc_method = 0; // worst case mask angle assumption
-                        ssin.FF0 = module.ff;
-                        ssoutputs ssout;
-
-                        if (!ss_exec(ssin,
-                            stilt, sazi, //surface tilt and azimuth
-                            solzen, solazi, //solar zenith and azimuth
-                            wf.dn, // Gb_nor (e.g. DNI)
-                            wf.df, //Gdh (e.g. DHI)
-                            ibeam * (1.0 - shad1xf), // Gb_poa
-                            iskydiff, //poa_sky
-                            ignddiff, // poa_gnd
-                            alb,
-                            pv.type == ONE_AXIS, // is tracking system?
-                            module.type == THINFILM,  // is linear shading? (only with long cell thin films)
-                            shad1xf,
-                            ssSkyDiffuseTable,
-                            ssout))
-                        {
-                            throw exec_error("pvwattsv8", util::format("Self-shading calculation failed at %d.", (int)idx_life));
-                        }
-
-                        // fixed tilt system with linear self-shading: beam is derated by fixed shade fraction
-                        // fixed tilt non-linear self-shading, beam would NOT usually be derated, because non-linear dc derate accounts for it
-                        // however, to be able to distinguish between irradiance and non-linear shading in loss diagram:
-                        // we will apply it here, BUT, we will use an un-self-shaded irradiance in the power calculations later
-                        // so that the loss isn't double counted.
-                        if (pv.type == FIXED_RACK)
-                        {
-                            if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_self_beam_shade") += ibeam * ssout.m_shade_frac_fixed * wm2_to_wh;
-                            ibeam *= (1 - ssout.m_shade_frac_fixed);
-                            p_ss_beam[idx] = (ssc_number_t)(1 - ssout.m_shade_frac_fixed);
-                        }
-
-                        // one-axis true tracking system with linear self-shading: beam is derated by linear shade fraction for 1-axis trackers
-                        // one-axis non-linear self-shading, beam would NOT usually be derated, because non-linear dc derate accounts for it
-                        // however, to be able to distinguish between irradiance and non-linear shading in loss diagram:
-                        // we will apply it here, BUT, we will use an un-self-shaded irradiance in the power calculations later
-                        // so that the loss isn't double counted.
-                        else if (pv.type == ONE_AXIS)
-                        {
-                            if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_self_beam_shade") += ibeam * shad1xf * wm2_to_wh;
-                            ibeam *= (1 - shad1xf);
-                            p_ss_beam[idx] = (ssc_number_t)(1 - shad1xf);
-                        }
-
-                        // for non-linear self-shading (fixed and one-axis, but not backtracking)
-                        // the non-linear dc derate is calculated and we need to save it for later
-                        /*if ((pv.type == FIXED_RACK || pv.type == ONE_AXIS) && module.type != THINFILM)
-                        {
-                            f_nonlinear = ssout.m_dc_derate;
-                        }*/ //disconnecting non-linear shading for now due to possible bug in non-linear shading algorithm resulting in 9% loss in annual energy compared to linear case for large systems
-
-                        // for backtracked systems, there is no beam irradiance reduction or non-linear DC derate
-                        // however, sky and ground-reflected diffuse are still blocked, so apply those to everything below
-
-                        // always derate diffuse for any self-shaded system,
-                        // due to inter-row blocking of sky and ground view factors.
-                        // the derates are calculated by the lib_pvshade.cpp:diffuse_reduce() function and are
-                        // purely geometric - apply independent of whether DC derate loss is linear or nonlinear
-                        Fskydiff = ssout.m_diffuse_derate;
-                        Fgnddiff = ssout.m_reflected_derate;
+            // apply soiling loss to the total effective POA
+            if (is_assigned("soiling"))
+            {
+                if (record_losses) ld("poa_loss_soiling") += (ibeam + iskydiff + ignddiff) * s.soiling_f * wm2_to_wh;
 
-                    }
+                ibeam *= (1.0 - s.soiling_f);
+                iskydiff *= (1.0 - s.soiling_f);
+                ignddiff *= (1.0 - s.soiling_f);
+                // note: assume no soiling on rear side?
+            }
+            else
+                if (record_losses) ld("poa_loss_soiling") = 0;
 
-                    // apply derate factors to diffuse
-                    if (Fskydiff >= -0.00001 && Fskydiff <= 1.00001) //include tolerances due to double representation
-                    {
-                        if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_self_diff_shade") += (1.0 - Fskydiff) * (iskydiff + irear) * wm2_to_wh; //irear is zero if not bifacial
-                        iskydiff *= Fskydiff;
-                        irear *= Fskydiff;
-                        p_ss_sky_diffuse[idx] = (ssc_number_t)Fskydiff;
-                    }
-                    else log(util::format("Sky diffuse reduction factor invalid at time %lg: fskydiff=%lg, stilt=%lg.", idx, Fskydiff, stilt), SSC_NOTICE, (float)idx);
+            // now add up total effective POA, accounting for external and self shading
+            double poa_front = ibeam + iskydiff + ignddiff;
+            double poa = poa_front + irear; //irear is zero if not bifacial
 
-                    if (Fgnddiff >= -0.00001 && Fgnddiff <= 1.00001) //include tolerances due to double representation
-                    {
-                        if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_self_diff_shade") += (1.0 - Fgnddiff) * ignddiff * wm2_to_wh;
-                        ignddiff *= Fgnddiff;
-                        p_ss_gnd_diffuse[idx] = (ssc_number_t)Fgnddiff;
-                    }
-                    else log(util::format("Ground diffuse reduction factor invalid at time %lg: fgnddiff=%lg, stilt=%lg.", idx, Fgnddiff, stilt), SSC_NOTICE, (float)idx);
+            // dc power nominal before any losses
+            double dc_nom = pv.dc_nameplate * poa / 1000; // Watts_DC * (POA W/m2 / 1000 W/m2 STC value );
+            if (record_losses) ld("dc_nominal") += dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
 
+            // nonlinear dc loss from shading
+            if (record_losses) ld("dc_loss_nonlinear") += dc_nom * (1.0 - f_nonlinear) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
 
-                    // apply soiling loss to the total effective POA
-                    if (is_assigned("soiling"))
-                    {
-                        double soiling_f = 0.0;
-                        if (soiling_len == 1)
-                            soiling_f = soiling[0] * 0.01; //convert from percentage to decimal
-                        else if (soiling_len == 12)
-                            soiling_f = soiling[wf.month - 1] * 0.01; //convert from percentage to decimal
-                        else if (soiling_len == nrec)
-                            soiling_f = soiling[idx] * 0.01; //convert from percentage to decimal
-                        else
-                            throw exec_error("pvwattsv8", "Soiling input array must have 1, 12, or nrecords values.");
+            // dc losses
+            if (record_losses) ld("dc_loss_other") += dc_nom * pv.dc_loss_percent * 0.01 * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+            double f_losses = (1 - pv.dc_loss_percent * 0.01);
 
-                        // report soiling factor output
-                        p_soiling_f[idx] = (ssc_number_t)soiling_f;
+            // run the snow loss model
+            double f_snow = 1.0;
+            if (en_snowloss)
+            {
+                float smLoss = 0.0f;
+                if (!cfg.snowmodel.getLoss(
+                    (float)poa, (float)stilt,
+                    (float)wf.wspd, (float)wf.tdry, (float)wf.snow,
+                    s.sunup, (float)ts_hour,
+                    smLoss))
+                {
+                    if (!cfg.snowmodel.good)
+                        throw exec_error("pvwattsv8", cfg.snowmodel.msg);
+                }
+                f_snow = (1.0 - smLoss);
+            }
 
-                        if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_soiling") += (ibeam + iskydiff + ignddiff) * soiling_f * wm2_to_wh;
+            // dc snow loss
+            if (record_losses) ld("dc_loss_snow") += dc_nom * (1.0 - f_snow) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+
+            // calculate actual DC power now with all the derates/losses
+            // remember, that for non-linear self-shading, we don't use derated ibeam for module power
+            // calculations because total loss is encapsulated in the DC derate
+            // but, we derated it earlier so we could break out the beam shading from the non-linear component.
+            // SO: if dcshadedderate < 1.0, then use ibeam_noselfshade
+            double poa_for_power =
+                (f_nonlinear < 1.0 && poa > 0.0) // if there is a nonlinear self-shading derate
+                ? (ibeam_unselfshaded + iskydiff + ignddiff) // then use the unshaded beam to calculate eff POA for power calc but adjust for IAM and spectral
+                : (ibeam + iskydiff + ignddiff); // otherwise, use the 'linearly' derated beam irradiance
+
+            // set up inputs to module model for both temperature and subsequent CEC module model calculations
+            // bifaciality is applied to irear on line 885 above for fixed arrays and line 962 for trackers - so, module.bifaciality should not be applied again here - SAM issue 1151
+            //pvinput_t in((f_nonlinear < 1.0 && poa > 0.0) ? ibeam_unselfshaded : ibeam, iskydiff, ignddiff, irear* module.bifaciality, poa_for_power,
+            pvinput_t in((f_nonlinear < 1.0 && poa > 0.0) ? ibeam_unselfshaded : ibeam, iskydiff, ignddiff, irear, poa_for_power,
+                wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+                s.solzen, aoi, hdr.elev,
+                stilt, sazi,
+                ((double)wf.hour) + wf.minute / 60.0,
+                irrad::DN_DF, false);
+
+            // module temperature calculations
+            double tmod = 0.0;
+            if (!modTempCalc(in, mod, -1.0, tmod)) throw exec_error("pvwattsv8", util::format("Module temperature calculation failed at index %d.", (int)s.idx_life)); //calculate temperature at MPP (-1.0 flag determines this)
+
+            // calculate transmitted POA (tpoa) to report as an output
+            double tpoa = 0.0;
+            if (aoi > AOI_MIN && aoi < AOI_MAX && poa_front > 0)
+            {
+                tpoa = calculateIrradianceThroughCoverDeSoto(
+                    aoi, stilt, ibeam, iskydiff, ignddiff, en_mlm == 0 && module.ar_glass);
+                if (tpoa < 0.0) tpoa = 0.0;
+                if (tpoa > poa) tpoa = poa_front;
+            }
 
-                        ibeam *= (1.0 - soiling_f);
-                        iskydiff *= (1.0 - soiling_f);
-                        ignddiff *= (1.0 - soiling_f);
-                        // note: assume no soiling on rear side?
-                    }
-                    else
-                        if (y == 0 && wdprov->annualSimulation()) ld("poa_loss_soiling") = 0;
+            // DC power conversion calculations
+            double dc = 0.0;
+            if (en_mlm) // hidden feature for pvwatts SDK users contributed by Aron Dobos
+            {
+                // adjustments to irradiance that are covered as part of the CEC model, but not by the mlm model
+                // module cover effects
+                double f_cover = 1.0;
+                f_cover = tpoa / poa_front;
+                // spectral correction via air mass modifier
+                double f_AM = air_mass_modifier(s.solzen, hdr.elev, AMdesoto);
+
+                // derate poa irradiance and record losses for loss diagram
+                poa_for_power *= f_cover * f_AM; //derate irradiance for module cover and spectral effects
+                poa_for_power += irear * f_AM; // backside irradiance model already includes back cover effects
+                if (record_losses) ld("dc_loss_cover") += (1 - f_cover) * dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+                if (record_losses) ld("dc_loss_spectral") += (1 - f_AM) * dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data*/
+
+                // single diode model per PVsyst using representative module parameters for each module type
+                double P_single_module_sdm = sdmml_power(sdm, poa_for_power, tmod);
+                dc = P_single_module_sdm * pv.dc_nameplate / (sdm.Vmp * sdm.Imp);
+            }
+            else // normal PVWattsV8 DC conversion module model
+            {
 
-                    // now add up total effective POA, accounting for external and self shading
-                    double poa_front = ibeam + iskydiff + ignddiff;
-                    poa = poa_front + irear; //irear is zero if not bifacial
+                // set up output structure for module model
+                pvoutput_t out(0, 0, 0, 0, 0, 0, 0, 0);
+                // call the module model
+                if (!mod(in, tmod, -1.0, out)) throw exec_error("pvwattsv8", util::format("Module power calculation failed at index %d.", (int)s.idx_life));
+                // scale the power output for a single module (out.Power) to the actual system size-
+                // divide the DC nameplate input by the "single module" nameplate (Vmp * Imp) to get a fractional number of modules in the system, and multiply by that fraction
+                dc = out.Power * pv.dc_nameplate / (mod.Vmp * mod.Imp);
+            }
 
-                    // dc power nominal before any losses
-                    double dc_nom = pv.dc_nameplate * poa / 1000; // Watts_DC * (POA W/m2 / 1000 W/m2 STC value );
-                    if (y == 0 && wdprov->annualSimulation()) ld("dc_nominal") += dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+            // apply common DC losses here (independent of module model)
+            dc *= f_nonlinear * f_snow * f_losses;
 
-                    // nonlinear dc loss from shading
-                    if (y == 0 && wdprov->annualSimulation()) ld("dc_loss_nonlinear") += dc_nom * (1.0 - f_nonlinear) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+            r.poa = poa;
+            r.tpoa = tpoa;
+            r.tmod = tmod;
+            r.dc = dc;
+            r.f_nonlinear = f_nonlinear;
+            r.f_snow = f_snow;
+        };
 
-                    // dc losses
-                    if (y == 0 && wdprov->annualSimulation()) ld("dc_loss_other") += dc_nom * pv.dc_loss_percent * 0.01 * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                    double f_losses = (1 - pv.dc_loss_percent * 0.01);
+        // inverter, clipping, and transformer losses of one configuration, from degraded DC power.
+        // returns AC power (W), which is negative at night due to the transformer no load loss
+        auto step_ac = [&](system_config& cfg, double dc, bool sun_up, size_t idx_life, bool record_losses, double& inv_eff)
+        {
+            double ac = 0.0;
+            if (sun_up)
+            {
+                // call inverter function
+                // set operating voltage (second parameter) to zero. the assumption we make for voltages are irrelevant as long as C0, C1, C2, and C3 are zero (set above)
+                // use null pointers for results that we don't care about
+                if (!cfg.inverter.acpower(dc, 0.0, &ac, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr)) throw exec_error("pvwattsv8", util::format("Inverter power calculation failed at index %d.", (int)idx_life));
 
-                    // run the snow loss model
-                    double f_snow = 1.0;
-                    if (en_snowloss)
-                    {
-                        float smLoss = 0.0f;
-                        if (!snowmodel.getLoss(
-                            (float)poa, (float)stilt,
-                            (float)wf.wspd, (float)wf.tdry, (float)wf.snow,
-                            sunup, (float)ts_hour,
-                            smLoss))
-                        {
-                            if (!snowmodel.good)
-                                throw exec_error("pvwattsv8", snowmodel.msg);
-                        }
-                        f_snow = (1.0 - smLoss);
-                    }
+                // track inverter efficiency
+                inv_eff = (dc > 0) ? ac / dc * 100 : 0.0;
 
-                    // dc snow loss
-                    if (y == 0 && wdprov->annualSimulation()) ld("dc_loss_snow") += dc_nom * (1.0 - f_snow) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-
-                    // calculate actual DC power now with all the derates/losses
-                    // remember, that for non-linear self-shading, we don't use derated ibeam for module power
-                    // calculations because total loss is encapsulated in the DC derate
-                    // but, we derated it earlier so we could break out the beam shading from the non-linear component.
-                    // SO: if dcshadedderate < 1.0, then use ibeam_noselfshade
-                    double poa_for_power =
-                        (f_nonlinear < 1.0 && poa > 0.0) // if there is a nonlinear self-shading derate
-                        ? (ibeam_unselfshaded + iskydiff + ignddiff) // then use the unshaded beam to calculate eff POA for power calc but adjust for IAM and spectral
-                        : (ibeam + iskydiff + ignddiff); // otherwise, use the 'linearly' derated beam irradiance
-
-                    // set up inputs to module model for both temperature and subsequent CEC module model calculations
-                    // bifaciality is applied to irear on line 885 above for fixed arrays and line 962 for trackers - so, module.bifaciality should not be applied again here - SAM issue 1151
-                    //pvinput_t in((f_nonlinear < 1.0 && poa > 0.0) ? ibeam_unselfshaded : ibeam, iskydiff, ignddiff, irear* module.bifaciality, poa_for_power,
-                    pvinput_t in((f_nonlinear < 1.0 && poa > 0.0) ? ibeam_unselfshaded : ibeam, iskydiff, ignddiff, irear, poa_for_power,
-                        wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-                        solzen, aoi, hdr.elev,
-                        stilt, sazi,
-                        ((double)wf.hour) + wf.minute / 60.0,
-                        irrad::DN_DF, false);
-
-                    // module temperature calculations
-                    if (!modTempCalc(in, mod, -1.0, tmod)) throw exec_error("pvwattsv8", util::format("Module temperature calculation failed at index %d.", (int)idx_life)); //calculate temperature at MPP (-1.0 flag determines this)
-
-                    // calculate transmitted POA (tpoa) to report as an output
-                    if (aoi > AOI_MIN && aoi < AOI_MAX && poa_front > 0)
-                    {
-                        tpoa = calculateIrradianceThroughCoverDeSoto(
-                            aoi, stilt, ibeam, iskydiff, ignddiff, en_mlm == 0 && module.ar_glass);
-                        if (tpoa < 0.0) tpoa = 0.0;
-                        if (tpoa > poa) tpoa = poa_front;
-                    }
+                // record AC results
+                if (record_losses) ld("ac_nominal") += dc * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+                if (record_losses) ld("ac_loss_efficiency") += (dc - ac) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
 
-                    // DC power conversion calculations
-                    if (en_mlm) // hidden feature for pvwatts SDK users contributed by Aron Dobos
-                    {
-                        // adjustments to irradiance that are covered as part of the CEC model, but not by the mlm model
-                        // module cover effects
-                        double f_cover = 1.0;
-                        f_cover = tpoa / poa_front;
-                        // spectral correction via air mass modifier
-                        double f_AM = air_mass_modifier(solzen, hdr.elev, AMdesoto);
-
-                        // derate poa irradiance and record losses for loss diagram
-                        poa_for_power *= f_cover * f_AM; //derate irradiance for module cover and spectral effects
-                        poa_for_power += irear * f_AM; // backside irradiance model already includes back cover effects
-                        if (y == 0 && wdprov->annualSimulation()) ld("dc_loss_cover") += (1 - f_cover) * dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                        if (y == 0 && wdprov->annualSimulation()) ld("dc_loss_spectral") += (1 - f_AM) * dc_nom * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data*/
-
-                        // single diode model per PVsyst using representative module parameters for each module type
-                        double P_single_module_sdm = sdmml_power(sdm, poa_for_power, tmod);
-                        dc = P_single_module_sdm * pv.dc_nameplate / (sdm.Vmp * sdm.Imp);
-                    }
-                    else // normal PVWattsV8 DC conversion module model
-                    {
+                // power clipping
+                double cliploss = ac > cfg.ac_nameplate ? ac - cfg.ac_nameplate : 0.0;
+                if (record_losses) ld("ac_loss_inverter_clipping") += cliploss * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+                ac -= cliploss;
 
-                        // set up output structure for module model
-                        pvoutput_t out(0, 0, 0, 0, 0, 0, 0, 0);
-                        // call the module model
-                        if (!mod(in, tmod, -1.0, out)) throw exec_error("pvwattsv8", util::format("Module power calculation failed at index %d.", (int)idx_life));
-                        // scale the power output for a single module (out.Power) to the actual system size-
-                        // divide the DC nameplate input by the "single module" nameplate (Vmp * Imp) to get a fractional number of modules in the system, and multiply by that fraction
-                        dc = out.Power * pv.dc_nameplate / (mod.Vmp * mod.Imp);
-                    }
+                // make sure no negative AC values (no parasitic nighttime losses calculated for PVWatts)
+                if (ac < 0) ac = 0;
+            }
 
-                    // apply common DC losses here (independent of module model)
-                    dc *= f_nonlinear * f_snow * f_losses;
-                    p_dcshadederate[idx] = (ssc_number_t)f_nonlinear;
-                    //p_dcsnowderate[idx] = (ssc_number_t)f_snow; // output is percentage - calculated value is derate
-                    p_dcsnowderate[idx] =  (1.0 - f_snow) * 100.0;
+            // transformer loss (night and day)
+            double iron_loss = pv.xfmr_nll_f * cfg.xfmr_rating;
+            double winding_loss = pv.xfmr_ll_f * ac * (ac / cfg.xfmr_rating);
+            double xfmr_loss = iron_loss + winding_loss;
+            if (record_losses) ld("ac_loss_transformer") += xfmr_loss * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+            return ac - xfmr_loss;
+        };
+
+        // everything upstream of DC degradation repeats identically each year of a lifetime simulation,
+        // so after the first year only the degradation, inverter, and transformer calculations are rerun.
+        // the snow model carries state across the year boundary, so it requires the full calculation every year
+        bool reuse_first_year_dc = nyears > 1 && !en_snowloss;
+        std::vector<double> dc_first_year; // DC power of the first configuration before degradation (W), NaN when the sun is down
+        std::vector<size_t> hour_of_year_first_year;
+        if (reuse_first_year_dc) {
+            dc_first_year.resize(nrec);
+            hour_of_year_first_year.resize(nrec);
+        }
 
-                    // apply DC degradation
-                    dc *= degradationFactor[y];
-
-                    // inverter calculations
-                    sandia_inverter_t inverter;
-                    inverter.Paco = pv.ac_nameplate;
-                    inverter.Pdco = inverter.Paco / (pv.inv_eff_percent * 0.01); // get inverter DC rating by dividing AC rating by efficiency
-                    // set both Vdco and Vdc to zero. the assumption we make for voltages are irrelevant as long as C1, C2, and C3 are zero
-                    inverter.Vdco = 0.0;
-                    inverter.Pntare = 0.0; // simplifying assumption that inverter has no nighttime losses
-                    // default values for C1, C2, C3 are zero per Sandia documentation: https://pvpmc.sandia.gov/modeling-steps/dc-to-ac-conversion/sandia-inverter-model/
-                    // setting these to 0 results in similar inverter output to pvwattsv5
-                    inverter.C1 = 0.0;
-                    inverter.C2 = 0.0;
-                    inverter.C3 = 0.0;
-
-                    // Set based on market per ssc issue 870
-                    inverter.Pso = 0.0; // simplifying assumption that the inverter can always operate - needed for knee
-                    inverter.C0 = 0.0; // needed for curvature - voltage needed for this parameter to be used
-
-                    if (pv.dc_nameplate < 10) { // Residential
-                        inverter.Pso = 0.002246 * inverter.Paco;
-                    }
-                    else if (pv.dc_nameplate < 1000) { // Commercial >= 10kW
-                        inverter.Pso = 0.002478 * inverter.Paco;
-                    }
-                    else { // Utility >= 1MW
-                        inverter.Pso = 0.004931 * inverter.Paco;
+        /* allocate output arrays, only gen in multi-configuration mode */
+        auto allocate_ts = [&](const std::string& name) { return batch ? nullptr : allocate(name, nrec); };
+        ssc_number_t* p_gh = allocate_ts("gh");
+        ssc_number_t* p_dn = allocate_ts("dn");
+        ssc_number_t* p_df = allocate_ts("df");
+        ssc_number_t* p_tamb = allocate_ts("tamb");
+        ssc_number_t* p_wspd = allocate_ts("wspd");
+        ssc_number_t* p_snow = allocate_ts("snow");
+
+        ssc_number_t* p_sunup = allocate_ts("sunup");
+        ssc_number_t* p_aoi = allocate_ts("aoi");
+        ssc_number_t* p_shad_beam = allocate_ts("shad_beam_factor"); // just for reporting output
+        ssc_number_t* p_ss_beam = allocate_ts("ss_beam_factor");
+        ssc_number_t* p_ss_sky_diffuse = allocate_ts("ss_sky_diffuse_factor");
+        ssc_number_t* p_ss_gnd_diffuse = allocate_ts("ss_gnd_diffuse_factor");
+        ssc_number_t* p_stow = allocate_ts("tracker_stowing"); // just for reporting output
+
+        ssc_number_t* p_tmod = allocate_ts("tcell");
+        ssc_number_t* p_alb = allocate_ts("alb");
+        ssc_number_t* p_soiling_f = allocate_ts("soiling_f");
+        ssc_number_t* p_dcshadederate = allocate_ts("dcshadederate");
+        ssc_number_t* p_dcsnowderate = allocate_ts("dcsnowderate");
+        ssc_number_t* p_poa = allocate_ts("poa");
+        ssc_number_t* p_tpoa = allocate_ts("tpoa");
+        ssc_number_t* p_dc = allocate_ts("dc");
+        ssc_number_t* p_ac = allocate_ts("ac");
+        ssc_number_t* p_ac_pre_adjust = allocate_ts("ac_pre_adjust");
+        ssc_number_t* p_inv_eff = allocate_ts("inv_eff_output");
+        ssc_number_t* p_gen = allocate("gen", nlifetime);
+
+        size_t idx_life = 0;
+        float percent = 0;
+        for (size_t y = 0; y < nyears; y++)
+        {
+            if (y > 0 && reuse_first_year_dc)
+            {
+                for (size_t idx = 0; idx < nrec; idx++)
+                {
+                    size_t hour_of_year = hour_of_year_first_year[idx];
+                    if (nrec > 50 && idx % (nrec / NSTATUS_UPDATES) == 0)
+                    {
+                        percent = 100.0f * ((float)idx_life + 1) / ((float)nlifetime);
+                        if (percent > 100.0f) percent = 99.0f;
+                        if (!update("", percent, (float)hour_of_year))
+                            throw exec_error("pvwattsv8", "Simulation stopped at hour " + util::to_string(hour_of_year + 1.0));
                     }
 
-                    // call inverter function
-                    // set operating voltage (second parameter) to zero. the assumption we make for voltages are irrelevant as long as C0, C1, C2, and C3 are zero (set above)
-                    // use null pointers for results that we don't care about
-                    if (!inverter.acpower(dc, 0.0, &ac, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr)) throw exec_error("pvwattsv8", util::format("Inverter power calculation failed at index %d.", (int)idx_life));
+                    bool sun_up = !std::isnan(dc_first_year[idx]);
+                    double dc = sun_up ? dc_first_year[idx] * degradationFactor[y] : 0.0;
+                    double inv_eff = 0.0;
+                    double ac = step_ac(configs[0], dc, sun_up, idx_life, false, inv_eff);
+                    ssc_number_t ac_adjusted = (ssc_number_t)(ac * haf(hour_of_year));
 
-                    // track inverter efficiency
-                    p_inv_eff[idx] = (dc > 0) ? ac/dc * 100 : 0.0;
+                    if (!batch)
+                    {
+                        if (sun_up) p_inv_eff[idx] = (ssc_number_t)inv_eff;
+                        p_dc[idx] = (ssc_number_t)dc;
+                        p_ac_pre_adjust[idx] = (ssc_number_t)ac;
+                        p_ac[idx] = ac_adjusted;
+                    }
+                    p_gen[idx_life] = (ssc_number_t)(ac_adjusted * util::watt_to_kilowatt);
+                    idx_life++;
+                }
+                continue;
+            }
 
-                    // record AC results
-                    if (y == 0 && wdprov->annualSimulation()) ld("ac_nominal") += dc * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                    if (y == 0 && wdprov->annualSimulation()) ld("ac_loss_efficiency") += (dc - ac) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+            // every configuration contributes first year energy, only the first one is simulated after that
+            size_t nconfig_year = y == 0 ? nconfig : 1;
+            bool record_losses = !batch && y == 0 && wdprov->annualSimulation();
 
-                    // power clipping
-                    double cliploss = ac > pv.ac_nameplate ? ac - pv.ac_nameplate : 0.0;
-                    if (y == 0 && wdprov->annualSimulation()) ld("ac_loss_inverter_clipping") += cliploss * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                    ac -= cliploss;
+            for (size_t idx = 0; idx < nrec; idx++)
+            {
+                if (!wdprov->read(&wf))
+                    throw exec_error("pvwattsv8", util::format("could not read data line %d of %d in weather file", (int)(idx + 1), (int)nrec));
+                size_t hour_of_year = util::hour_of_year(wf.month, wf.day, wf.hour);
 
-                    // make sure no negative AC values (no parasitic nighttime losses calculated for PVWatts)
-                    if (ac < 0) ac = 0;
-                }
-                else
+                if (nrec > 50) //avoid divide by zero problems in the following if statement- probably don't need a lot of updates otherwise
                 {
-                    poa = 0;
-                    tpoa = 0;
-                    tmod = wf.tdry;
-                    dc = 0;
-                    ac = 0;
+                    if (idx % (nrec / NSTATUS_UPDATES) == 0)
+                    {
+                        percent = 100.0f * ((float)idx_life + 1) / ((float)nlifetime); //3 is the number of technologies we're assuming for this output (pvwatts + fuel cell + battery)
+                        // check percentage
+                        if (percent > 100.0f) percent = 99.0f;
+                        if (!update("", percent, (float)hour_of_year))
+                            throw exec_error("pvwattsv8", "Simulation stopped at hour " + util::to_string(hour_of_year + 1.0));
+                    }
                 }
 
-                // transformer loss (night and day)
-                double iron_loss = pv.xfmr_nll_f * pv.xfmr_rating;
-                double winding_loss = pv.xfmr_ll_f * ac * (ac / pv.xfmr_rating);
-                double xfmr_loss = iron_loss + winding_loss;
-                if (y == 0 && wdprov->annualSimulation()) ld("ac_loss_transformer") += xfmr_loss * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                ac -= xfmr_loss;
+                step_conditions s;
+                s.idx = idx;
+                s.idx_life = idx_life;
+                s.hour_of_year = hour_of_year;
+                step_sun(wf, s);
+                bool sun_up = s.sunup > 0;
 
-                p_stow[idx] = (tracker_stowing ? 1.0 : 0.0);
-                p_shad_beam[idx] = (ssc_number_t)shad_beam; // might be updated by 1 axis self shading so report updated value
-
-                p_poa[idx] = (ssc_number_t)poa; // W/m2
-                p_tpoa[idx] = (ssc_number_t)tpoa;  // W/m2
-                p_tmod[idx] = (ssc_number_t)tmod;
-                p_dc[idx] = (ssc_number_t)dc; // power, Watts
-                p_ac_pre_adjust[idx] = (ssc_number_t)ac; //power, Watts
-                p_ac[idx] = (ssc_number_t)(ac * haf(hour_of_year)); // power, Watts
+                for (size_t c = 0; c < nconfig_year; c++)
+                {
+                    system_config& cfg = configs[c];
+                    step_result r;
+                    step_dc(wf, s, cfg, record_losses && c == 0, c == 0, r);
 
-                // accumulate hourly energy (kWh) (was initialized to zero when allocated)
-                p_gen[idx_life] = (ssc_number_t)(p_ac[idx] * util::watt_to_kilowatt);
+                    if (c == 0 && reuse_first_year_dc)
+                    {
+                        dc_first_year[idx] = sun_up ? r.dc : std::numeric_limits<double>::quiet_NaN();
+                        hour_of_year_first_year[idx] = hour_of_year;
+                    }
 
+                    // apply DC degradation
+                    double dc = r.dc * degradationFactor[y];
+                    double inv_eff = 0.0;
+                    double ac = step_ac(cfg, dc, sun_up, idx_life, record_losses && c == 0, inv_eff);
+                    ssc_number_t ac_adjusted = (ssc_number_t)(ac * haf(hour_of_year)); // power, Watts
+                    ssc_number_t gen_kw = (ssc_number_t)(ac_adjusted * util::watt_to_kilowatt);
+
+                    if (y == 0) //report first year annual energy
+                        cfg.annual_kwh += gen_kw / step_per_hour;
+
+                    if (c > 0)
+                        continue;
+
+                    // accumulate hourly energy (kWh) (was initialized to zero when allocated)
+                    p_gen[idx_life] = gen_kw;
+
+                    if (record_losses) ld("ac_loss_adjustments") += ac * (1.0 - haf(hour_of_year)) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+                    if (record_losses) ld("ac_delivered") += ac * haf(hour_of_year) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
+
+                    if (batch)
+                        continue;
+
+                    p_gh[idx] = (ssc_number_t)wf.gh;
+                    p_dn[idx] = (ssc_number_t)wf.dn;
+                    p_df[idx] = (ssc_number_t)wf.df;
+                    p_tamb[idx] = (ssc_number_t)wf.tdry;
+                    p_wspd[idx] = (ssc_number_t)wf.wspd;
+                    p_snow[idx] = (ssc_number_t)wf.snow; // if there is no snow data in the weather file, this will be NaN- consistent with pvsamv1
+
+                    // report albedo value as output
+                    p_alb[idx] = (ssc_number_t)s.alb;
+
+                    p_sunup[idx] = (ssc_number_t)s.sunup;
+                    p_aoi[idx] = (ssc_number_t)r.aoi;
+                    p_shad_beam[idx] = (ssc_number_t)s.shad_beam;
+                    p_ss_beam[idx] = (ssc_number_t)r.ss_beam;
+                    p_ss_sky_diffuse[idx] = (ssc_number_t)r.ss_sky_diffuse;
+                    p_ss_gnd_diffuse[idx] = (ssc_number_t)r.ss_gnd_diffuse;
+                    p_stow[idx] = (r.tracker_stowing ? 1.0 : 0.0);
+
+                    if (sun_up)
+                    {
+                        // report soiling factor output
+                        p_soiling_f[idx] = (ssc_number_t)s.soiling_f;
+                        p_dcshadederate[idx] = (ssc_number_t)r.f_nonlinear;
+                        //p_dcsnowderate[idx] = (ssc_number_t)f_snow; // output is percentage - calculated value is derate
+                        p_dcsnowderate[idx] = (1.0 - r.f_snow) * 100.0;
+                        p_inv_eff[idx] = (ssc_number_t)inv_eff;
+                    }
 
-                if (y == 0 && wdprov->annualSimulation()) { //report first year annual energy
-                    annual_kwh += p_gen[idx] / step_per_hour;
+                    p_poa[idx] = (ssc_number_t)r.poa; // W/m2
+                    p_tpoa[idx] = (ssc_number_t)r.tpoa;  // W/m2
+                    p_tmod[idx] = (ssc_number_t)r.tmod;
+                    p_dc[idx] = (ssc_number_t)dc; // power, Watts
+                    p_ac_pre_adjust[idx] = (ssc_number_t)ac; //power, Watts
+                    p_ac[idx] = ac_adjusted;
                 }
 
-                if (y == 0 && wdprov->annualSimulation()) ld("ac_loss_adjustments") += ac * (1.0 - haf(hour_of_year)) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-                if (y == 0 && wdprov->annualSimulation()) ld("ac_delivered") += ac * haf(hour_of_year) * ts_hour; //ts_hour required to correctly convert to Wh for subhourly data
-
                 idx_life++;
             }
 
@@ -1381,17 +1597,35 @@ public:
             wdprov->rewind();
         }
 
-        if (wdprov->annualSimulation())
+        if (batch)
         {
-            ssc_number_t* p_annual_energy_dist_time = gen_heatmap(this, (double)step_per_hour);
+            ssc_number_t* p_batch_energy = allocate("batch_annual_energy", nconfig);
+            ssc_number_t* p_batch_cf = allocate("batch_capacity_factor", nconfig);
+            for (size_t c = 0; c < nconfig; c++)
+            {
+                p_batch_energy[c] = (ssc_number_t)configs[c].annual_kwh;
+                p_batch_cf[c] = (ssc_number_t)(util::kilowatt_to_watt * configs[c].annual_kwh / pv.dc_nameplate / 87.6);
+            }
+        }
+        else if (wdprov->annualSimulation())
+        {
+            double annual_kwh = configs[0].annual_kwh;
+
+            timeseries_aggregator agg(this, step_per_hour);
+            agg.heatmap("gen", "annual_energy_distribution_time");
+            agg.monthly_for_year("gen", "monthly_energy", ts_hour);
+            agg.annual_for_year("gen", "annual_energy", ts_hour);
 
-            accumulate_monthly_for_year("gen", "monthly_energy", ts_hour, step_per_hour);
-            accumulate_annual_for_year("gen", "annual_energy", ts_hour, step_per_hour);
+            agg.monthly("dc", "dc_monthly", 0.001 * ts_hour);
+            agg.monthly("ac", "ac_monthly", 0.001 * ts_hour);
+            agg.monthly("poa", "poa_monthly", 0.001 * ts_hour); // convert to energy
 
-            accumulate_monthly("dc", "dc_monthly", 0.001 * ts_hour);
-            accumulate_monthly("ac", "ac_monthly", 0.001 * ts_hour);
+            agg.annual("ac", "ac_annual", 0.001 * ts_hour);
+            agg.annual("ac_pre_adjust", "ac_annual_pre_adjust", 0.001 * ts_hour);
+            agg.compute();
 
-            ssc_number_t* poam = accumulate_monthly("poa", "poa_monthly", 0.001 * ts_hour); // convert to energy
+            size_t count = 0;
+            ssc_number_t* poam = as_array("poa_monthly", &count);
             ssc_number_t* solrad = allocate("solrad_monthly", 12);
             ssc_number_t solrad_ann = 0;
             for (int m = 0; m < 12; m++)
@@ -1401,9 +1635,6 @@ public:
             }
             assign("solrad_annual", var_data(solrad_ann / 12));
 
-            accumulate_annual("ac", "ac_annual", 0.001 * ts_hour);
-            accumulate_annual("ac_pre_adjust", "ac_annual_pre_adjust", 0.001 * ts_hour);
-
             // metric outputs
             double kWhperkW = util::kilowatt_to_watt * annual_kwh / pv.dc_nameplate;
             assign("kwh_per_kw", var_data((ssc_number_t)kWhperkW));
@@ -1411,29 +1642,17 @@ public:
             assign("capacity_factor_ac", var_data((ssc_number_t)util::kilowatt_to_watt* annual_kwh / pv.ac_nameplate / 87.6)); //same conversion as above
         }
 
-        // location outputs
-        assign("location", var_data(hdr.location));
-        assign("city", var_data(hdr.city));
-        assign("state", var_data(hdr.state));
-        assign("lat", var_data((ssc_number_t)hdr.lat));
-        assign("lon", var_data((ssc_number_t)hdr.lon));
-        assign("tz", var_data((ssc_number_t)hdr.tz));
-        assign("elev", var_data((ssc_number_t)hdr.elev));
-        assign("percent_complete", var_data((ssc_number_t)percent));
-
-        double gcr_for_land = pv.gcr;
-        if (gcr_for_land < 0.01) gcr_for_land = 1.0;
-        double landf = is_assigned("landf") ? as_number("landf") : 1.0f;
-        assign("land_acres", var_data((ssc_number_t)(landf * module_m2 / gcr_for_land * 0.0002471)));
-
-        // for battery model, specify a number of inverters
-        assign("inverter_efficiency", var_data((ssc_number_t)(as_double("inv_eff"))));
+        assign_site_outputs(hdr, module_m2, percent);
 
-        if (en_snowloss && snowmodel.badValues > 0)
-            log(util::format("The snow model has detected %d bad snow depth values (less than 0 or greater than 610 cm). These values have been set to zero.", snowmodel.badValues), SSC_WARNING);
+        for (size_t c = 0; c < nconfig; c++)
+        {
+            if (en_snowloss && configs[c].snowmodel.badValues > 0)
+                log(util::format("%sThe snow model has detected %d bad snow depth values (less than 0 or greater than 610 cm). These values have been set to zero.",
+                    batch ? util::format("Multi-configuration %d: ", (int)c).c_str() : "", configs[c].snowmodel.badValues), SSC_WARNING);
+        }
 
         // assign loss factors to outputs (kwh)
-        if (wdprov->annualSimulation())
+        if (!batch && wdprov->annualSimulation())
         {
             if (!ld.assign(this, "lossd_"))
                 log(ld.errormsg(), SSC_WARNING);
@@ -2332,7 +2332,7 @@ public:
 
                                 ssc_number_t tier_credit = 0.0, sr = 0.0, tier_energy = 0.0;
                                 // time step sell rates
-                                if (as_boolean("ur_en_ts_sell_rate")) {
+                                if (rate.en_ts_sell_rate) {
                                     if (c < rate.m_ec_ts_sell_rate.size()) {
                                         tier_energy = energy_surplus;
                                         sr = rate.m_ec_ts_sell_rate[c];
@@ -2407,7 +2407,7 @@ public:
 
                                 ssc_number_t tier_charge = 0.0, br = 0.0, tier_energy = 0.0;
                                 // time step sell rates
-                                if (as_boolean("ur_en_ts_buy_rate")) {
+                                if (rate.en_ts_buy_rate) {
                                     if (c < rate.m_ec_ts_buy_rate.size()) {
                                         tier_energy = energy_deficit;
                                         br = rate.m_ec_ts_buy_rate[c];
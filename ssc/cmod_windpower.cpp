@@ -31,6 +31,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
+#include <algorithm>
+
 #include "core.h"
 #include "lib_windfile.h"
 #include "lib_windwatts.h"
@@ -62,6 +64,14 @@ static var_info _cm_vtab_windpower[] = {
 	{ SSC_INPUT  , SSC_ARRAY  , "wind_farm_xCoordinates"             , "Turbine X coordinates"                    , "m"       ,""                                    , "Farm"                                 , "*"                                               , ""                                                , "" } ,
 	{ SSC_INPUT  , SSC_ARRAY  , "wind_farm_yCoordinates"             , "Turbine Y coordinates"                    , "m"       ,""                                    , "Farm"                                 , "*"                                               , "LENGTH_EQUAL=wind_farm_xCoordinates"             , "" } ,
     { SSC_INPUT  , SSC_NUMBER , "max_turbine_override"               , "Override the max number of turbines for wake modeling","numTurbines","set new max num turbines","Farm"                                , ""                                                , ""                                                , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "wind_farm_wake_profiles"            , "Interpolate eddy-viscosity wake profiles" , "0/1"     ,"eddy-viscosity model only"           , "Farm"                                 , "?=0"                                             , "INTEGER,MIN=0,MAX=1"                             , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "wind_farm_response_bins"            , "Interpolate binned farm wake response"    , "0/1"     ,"time series resource only"           , "Farm"                                 , "?=0"                                             , "INTEGER,MIN=0,MAX=1"                             , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "wind_farm_bin_direction"            , "Farm response bin width, direction"       , "deg"     ,""                                    , "Farm"                                 , "?=1"                                             , "POSITIVE"                                        , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "wind_farm_bin_speed"                , "Farm response bin width, wind speed"      , "m/s"     ,""                                    , "Farm"                                 , "?=0.25"                                          , "POSITIVE"                                        , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "wind_farm_bin_density"              , "Farm response bin width, air density"     , "kg/m3"   ,""                                    , "Farm"                                 , "?=0.01"                                          , "POSITIVE"                                        , "" } ,
+	{ SSC_INPUT  , SSC_NUMBER , "nthreads"                           , "Number of threads"                        , ""        ,"0 uses all available cores"          , "Farm"                                 , "?=1"                                             , "INTEGER,MIN=0"                                   , "" } ,
+	{ SSC_INPUT  , SSC_MATRIX , "wind_farm_layouts_x"                , "Candidate layout turbine X coordinates"   , "m"       ,"one layout per row, time series only" , "Farm"                                 , "?"                                               , ""                                                , "" } ,
+	{ SSC_INPUT  , SSC_MATRIX , "wind_farm_layouts_y"                , "Candidate layout turbine Y coordinates"   , "m"       ,"one layout per row"                  , "Farm"                                 , "a:wind_farm_layouts_x"                           , ""                                                , "" } ,
 
 	{ SSC_INPUT  , SSC_NUMBER , "en_low_temp_cutoff"                 , "Enable Low Temperature Cutoff"            , "0/1"     ,""                                    , "Losses"                               , "?=0"                                             , "INTEGER"                                         , "" } ,
 	{ SSC_INPUT  , SSC_NUMBER , "low_temp_cutoff"                    , "Low Temperature Cutoff"                   , "C"       ,""                                    , "Losses"                               , "en_low_temp_cutoff=1"                            , ""                                                , "" } ,
@@ -119,6 +129,10 @@ static var_info _cm_vtab_windpower[] = {
     { SSC_OUTPUT , SSC_NUMBER , "wake_losses"                        , "Wake losses"                              , "%"       ,""                                    , "Annual"                           ,"" , ""                                                , "" } ,
 
     { SSC_OUTPUT , SSC_NUMBER , "cutoff_losses"                      , "Low temp and Icing Cutoff losses"         , "%"       ,""                                    , "Annual"                           ,"" , ""                                                , "" } ,
+    { SSC_OUTPUT , SSC_NUMBER , "wind_farm_bin_error"                , "Sampled farm power error of binned wake response", "%" ,""                                    , "Annual"                           ,"" , ""                                                , "" } ,
+    { SSC_OUTPUT , SSC_ARRAY  , "layout_annual_energy"               , "Annual energy of each candidate layout"   , "kWh"     ,""                                    , "Layouts"                          ,"" , ""                                                , "" } ,
+    { SSC_OUTPUT , SSC_ARRAY  , "layout_wake_losses"                 , "Wake losses of each candidate layout"     , "%"       ,""                                    , "Layouts"                          ,"" , ""                                                , "" } ,
+    { SSC_OUTPUT , SSC_MATRIX , "layout_turbine_eff"                 , "Turbine efficiency in each candidate layout", "%"     ,"one layout per row"                  , "Layouts"                          ,"" , ""                                                , "" } ,
 	var_info_invalid };
 
 winddata::winddata(var_data *data_table)
@@ -313,6 +327,10 @@ void cm_windpower::exec()
 	if (wpc.nTurbines > wpc.GetMaxTurbines())
 		throw exec_error("windpower", util::format("the wind model is only configured to handle up to %d turbines.", wpc.GetMaxTurbines()));
 
+	// candidate layouts are evaluated against the time series resource only
+	if (is_assigned("wind_farm_layouts_x") && as_integer("wind_resource_model_choice") != 0)
+		throw exec_error("windpower", "wind_farm_layouts_x and wind_farm_layouts_y require the time series resource (wind_resource_model_choice=0).");
+
 	// create adjustment factors and losses
 	adjustment_factors haf(this, "adjust");
 	if (!haf.setup())
@@ -354,18 +372,18 @@ void cm_windpower::exec()
 
 		int nstep = 8760;
 		ssc_number_t farm_kw = (ssc_number_t)turbine_kw * wpc.nTurbines / (ssc_number_t)nstep;
-		ssc_number_t *farmpwr = allocate("gen", nstep);
-		for (int i = 0; i < nstep; i++) //nstep is always 8760 for Weibull
-		{
-			farmpwr[i] = farm_kw; // fill "gen"
+		ssc_number_t *farmpwr = allocate("gen", nstep); //nstep is always 8760 for Weibull
+		std::fill(farmpwr, farmpwr + nstep, farm_kw); // fill "gen"
+		for (int i = 0; i < nstep; i++)
 			farmpwr[i] *= haf(i); //apply adjustment factor/availability and curtailment losses
-		}
 
 		for (size_t i = 0; i < wpc.nTurbines; i++)
 			turbine_output[i] = (ssc_number_t)turbine_outkW[i];
 
-		accumulate_monthly("gen", "monthly_energy");
-		accumulate_annual("gen", "annual_energy");
+		timeseries_aggregator agg(this, 1);
+		agg.monthly("gen", "monthly_energy");
+		agg.annual("gen", "annual_energy");
+		agg.compute();
 
 		// metric outputs moved to technology
 		double kWhperkW = 0.0;
@@ -381,26 +399,31 @@ void cm_windpower::exec()
 		return;
 	}
 
-    // create wakeModel
-    std::shared_ptr<wakeModelBase> wakeModel(nullptr);
+    // create wakeModel; the time series simulation creates one more per thread since wake models keep scratch arrays
     int wakeModelChoice = as_integer("wind_farm_wake_model");
-    if (wakeModelChoice == 0)
-        wakeModel = std::make_shared<simpleWakeModel>(simpleWakeModel(wpc.nTurbines, &wt));
-    else if (wakeModelChoice == 1)
-        wakeModel = std::make_shared<parkWakeModel>(parkWakeModel(wpc.nTurbines, &wt));
-    else if (wakeModelChoice == 2)
-    {
+    if (wakeModelChoice == 2)
         wpc.turbulenceIntensity *= 100;
-        wakeModel = std::make_shared<eddyViscosityWakeModel>(eddyViscosityWakeModel(wpc.nTurbines, &wt, as_double("wind_resource_turbulence_coeff")));
-    }
     else if (wakeModelChoice == 3)
-    {
         wake_int_loss_percent = as_double("wake_int_loss");
-        wakeModel = std::make_shared<constantWakeModel>(constantWakeModel(wpc.nTurbines, &wt, (100. - wake_int_loss_percent)/100.));
-    }
-    else{
+    else if (wakeModelChoice != 0 && wakeModelChoice != 1)
         throw exec_error("windpower", util::format("wind_farm_wake_model must be 0, 1, 2 or 3."));
-    }
+    bool wakeProfiles = as_boolean("wind_farm_wake_profiles");
+    double turbulenceCoeff = as_double("wind_resource_turbulence_coeff");
+    auto createWakeModel = [&](windTurbine *turbine) -> std::shared_ptr<wakeModelBase> {
+        if (wakeModelChoice == 0)
+            return std::make_shared<simpleWakeModel>(simpleWakeModel(wpc.nTurbines, turbine));
+        if (wakeModelChoice == 1)
+            return std::make_shared<parkWakeModel>(parkWakeModel(wpc.nTurbines, turbine));
+        if (wakeModelChoice == 2)
+        {
+            auto evModel = std::make_shared<eddyViscosityWakeModel>(eddyViscosityWakeModel(wpc.nTurbines, turbine, turbulenceCoeff));
+            if (wakeProfiles)
+                evModel->SetProfileLibrary();
+            return evModel;
+        }
+        return std::make_shared<constantWakeModel>(constantWakeModel(wpc.nTurbines, turbine, (100. - wake_int_loss_percent)/100.));
+    };
+    std::shared_ptr<wakeModelBase> wakeModel = createWakeModel(&wt);
     if (!wpc.InitializeModel(wakeModel))
         throw exec_error("windpower", util::format("Error initializing wake model."));
 
@@ -418,15 +441,17 @@ void cm_windpower::exec()
         int nstep = 8760;
         ssc_number_t farm_kw = farmPower / (ssc_number_t)nstep;
         ssc_number_t *farmpwr = allocate("gen", nstep);
+        std::fill(farmpwr, farmpwr + nstep, farm_kw); // fill "gen"
         for (int i = 0; i < nstep; i++)
         {
-            farmpwr[i] = farm_kw; // fill "gen"
             farmpwr[i] *= haf(i); //apply adjustment factor/availability and curtailment losses
             farmpwr[i] *= lossMultiplier;
         }
 
-        accumulate_monthly("gen", "monthly_energy");
-        accumulate_annual("gen", "annual_energy");
+        timeseries_aggregator agg(this, 1);
+        agg.monthly("gen", "monthly_energy");
+        agg.annual("gen", "annual_energy");
+        agg.compute();
 
         // average wind speed
         double avg_speed = 0.;
@@ -510,9 +535,9 @@ void cm_windpower::exec()
 	ssc_number_t *air_pres = allocate("pressure", nstep);
 
 
-	std::vector<double> Power(wpc.nTurbines, 0.), Thrust(wpc.nTurbines, 0.),
-		Eff(wpc.nTurbines, 0.), Wind(wpc.nTurbines, 0.), Turb(wpc.nTurbines, 0.),
-		DistDown(wpc.nTurbines, 0.), DistCross(wpc.nTurbines, 0.);
+	bool responseBins = as_boolean("wind_farm_response_bins");
+	if (responseBins && !wpc.SetResponseBins(as_double("wind_farm_bin_direction"), as_double("wind_farm_bin_speed"), as_double("wind_farm_bin_density")))
+		throw exec_error("windpower", wpc.GetErrorDetails());
 
 	ssc_number_t *monthly = allocate("monthly_energy", 12);
 	for (int i = 0; i < 12; i++)
@@ -522,17 +547,13 @@ void cm_windpower::exec()
 	double withoutCutOffLosses = 0.0;
 	double annual_after_wake_loss = 0.0;
 
-	// compute power output at i-th timestep
+	// read the resource for every time step, farm output carries no state between steps so it is computed after
+	std::vector<double> windSteps(nstep), dirSteps(nstep), tempSteps(nstep), presSteps(nstep);
 	int i = 0;
 	for (size_t hr = 0; hr < 8760; hr++)
 	{
-		int imonth = util::month_of((double)hr) - 1;
-
 		for (size_t istep = 0; istep < steps_per_hour; istep++)
 		{
-			if (i % (nstep / 20) == 0)
-				update("", 100.0f * ((float)i) / ((float)nstep), (float)i); //update percentage complete in UI
-
 			double wind, dir, temp, pres, closest_dir_meas_ht;
 
 			//skip leap day if applicable
@@ -577,43 +598,88 @@ void cm_windpower::exec()
 				wt.measurementHeight = wt.hubHeight;
 			}
 
-			double farmp = 0., gross_farmp = 0.;
-
-			if ((int)wpc.nTurbines != wpc.windPowerUsingResource(
-                    /* inputs */
-                    wind,    /* m/s */
-                    dir,    /* degrees */
-                    pres,    /* Atm or Pa */
-                    temp,    /* deg C */
-
-                    /* outputs */
-                    &farmp,
-                    &gross_farmp,
-                    &Power[0],
-                    &Thrust[0],
-                    &Eff[0],
-                    &Wind[0],
-                    &Turb[0],
-                    &DistDown[0],
-                    &DistCross[0]))
-				throw exec_error("windpower", util::format("error in wind calculation at time %d, details: %s", i, wpc.GetErrorDetails().c_str()));
+			windSteps[i] = wind;
+			dirSteps[i] = dir;
+			tempSteps[i] = temp;
+			presSteps[i] = pres;
+			i++;
+		} // end steps_per_hour loop
+	} // end 1->8760 loop
+
+	// compute power output at each time step across threads, each with its own turbine and wake model scratch;
+	// binned responses are filled in as steps reach them so they stay on one thread
+	int nthreads = responseBins ? 1 : util::thread_count(as_integer("nthreads"), nstep);
+
+	std::vector<windTurbine> threadTurbines(nthreads - 1, wt);
+	std::vector<windPowerCalculator> threadCalcs(nthreads - 1, wpc);
+	for (int t = 0; t < nthreads - 1; t++)
+	{
+		threadCalcs[t].windTurb = &threadTurbines[t];
+		threadCalcs[t].InitializeModel(createWakeModel(&threadTurbines[t]));
+	}
+
+	struct turbineScratch
+	{
+		std::vector<double> Power, Thrust, Eff, Wind, Turb, DistDown, DistCross;
+		turbineScratch(size_t n) : Power(n), Thrust(n), Eff(n), Wind(n), Turb(n), DistDown(n), DistCross(n) {}
+	};
+	std::vector<turbineScratch> scratch(nthreads, turbineScratch(wpc.nTurbines));
+
+	std::vector<double> farmSteps(nstep), grossSteps(nstep);
+	util::parallel_for(nstep, nthreads, [&](size_t s, int t) {
+		windPowerCalculator &calc = t == 0 ? wpc : threadCalcs[t - 1];
+		turbineScratch &ts = scratch[t];
+		if (t == 0 && s % (nstep / 20) == 0)
+			update("", 100.0f * ((float)s) / ((float)nstep), (float)s); //update percentage complete in UI
+
+		if ((int)wpc.nTurbines != calc.windPowerUsingResource(
+                /* inputs */
+                windSteps[s],    /* m/s */
+                dirSteps[s],    /* degrees */
+                presSteps[s],    /* Atm or Pa */
+                tempSteps[s],    /* deg C */
+
+                /* outputs */
+                &farmSteps[s],
+                &grossSteps[s],
+                &ts.Power[0],
+                &ts.Thrust[0],
+                &ts.Eff[0],
+                &ts.Wind[0],
+                &ts.Turb[0],
+                &ts.DistDown[0],
+                &ts.DistCross[0]))
+			throw exec_error("windpower", util::format("error in wind calculation at time %d, details: %s", (int)s, calc.GetErrorDetails().c_str()));
+	});
+
+	// apply losses and adjustment factors in time order, keeping each step's energy per kW for candidate layouts
+	bool layouts = is_assigned("wind_farm_layouts_x");
+	std::vector<double> stepWeight(layouts ? nstep : 0);
+	i = 0;
+	for (size_t hr = 0; hr < 8760; hr++)
+	{
+		int imonth = util::month_of((double)hr) - 1;
+
+		for (size_t istep = 0; istep < steps_per_hour; istep++)
+		{
+			double farmp = farmSteps[i], gross_farmp = grossSteps[i];
+			double temp = tempSteps[i], pres = presSteps[i];
 
 			annual_gross += gross_farmp;
 			annual_after_wake_loss += farmp;
 			farmp *= lossMultiplier;
 			// apply and track cutoff losses
 			withoutCutOffLosses += farmp * haf(hr);
-			if (lowTempCutoff){
-				if (temp < lowTempCutoffValue) farmp = 0.0;
-			}
-			if (icingCutoff){
-				if (temp < icingTempCutoffValue && wdprov->relativeHumidity()[i] > icingRHCutoffValue)
-					farmp = 0.0;
-			}
+			bool cutoff = (lowTempCutoff && temp < lowTempCutoffValue)
+				|| (icingCutoff && temp < icingTempCutoffValue && wdprov->relativeHumidity()[i] > icingRHCutoffValue);
+			if (cutoff)
+				farmp = 0.0;
 
+			if (layouts)
+				stepWeight[i] = cutoff ? 0.0 : lossMultiplier * haf(hr) / steps_per_hour;
 			farmpwr[i] = (ssc_number_t)farmp*haf(hr); //adjustment factors are constrained to be hourly, not sub-hourly, so it's correct for this to be indexed on the hour
-			wspd[i] = (ssc_number_t)wind;
-			wdir[i] = (ssc_number_t)dir;
+			wspd[i] = (ssc_number_t)windSteps[i];
+			wdir[i] = (ssc_number_t)dirSteps[i];
 			air_temp[i] = (ssc_number_t)temp;
             if (pres > 1.1) pres = pres / physics::Pa_PER_Atm; // assumes that value greater than 1.1 is i Pa
 			air_pres[i] = (ssc_number_t)pres;
@@ -625,6 +691,50 @@ void cm_windpower::exec()
 			i++;
 		} // end steps_per_hour loop
 	} // end 1->8760 loop
+	// evaluate candidate layouts over the resource already read, with this farm's turbine, wake model and losses
+	if (layouts)
+	{
+		util::matrix_t<double> layout_x = as_matrix("wind_farm_layouts_x");
+		util::matrix_t<double> layout_y = as_matrix("wind_farm_layouts_y");
+		if (layout_x.nrows() != layout_y.nrows() || layout_x.ncols() != layout_y.ncols())
+			throw exec_error("windpower", "wind_farm_layouts_x and wind_farm_layouts_y must have the same dimensions.");
+
+		wind_layout_batch_t batch;
+		batch.farm = wpc;
+		batch.createWakeModel = createWakeModel;
+		if (responseBins){
+			batch.binDirStep = as_double("wind_farm_bin_direction");
+			batch.binSpeedStep = as_double("wind_farm_bin_speed");
+			batch.binDensityStep = as_double("wind_farm_bin_density");
+		}
+		batch.windSpeed = windSteps;
+		batch.windDirection = dirSteps;
+		batch.pressure = presSteps;
+		batch.temperature = tempSteps;
+		batch.stepWeight = stepWeight;
+		batch.xCoords.resize(layout_x.nrows());
+		batch.yCoords.resize(layout_x.nrows());
+		for (size_t c = 0; c < layout_x.nrows(); c++){
+			batch.xCoords[c].assign(&layout_x.at(c, 0), &layout_x.at(c, 0) + layout_x.ncols());
+			batch.yCoords[c].assign(&layout_y.at(c, 0), &layout_y.at(c, 0) + layout_y.ncols());
+		}
+
+		if (batch.calculate(as_integer("nthreads")) != layout_x.nrows())
+			for (size_t c = 0; c < layout_x.nrows(); c++)
+				if (!batch.errors[c].empty())
+					throw exec_error("windpower", util::format("candidate layout %d: %s", (int)c, batch.errors[c].c_str()));
+
+		ssc_number_t *layout_energy = allocate("layout_annual_energy", layout_x.nrows());
+		ssc_number_t *layout_loss = allocate("layout_wake_losses", layout_x.nrows());
+		ssc_number_t *layout_eff = allocate("layout_turbine_eff", layout_x.nrows(), layout_x.ncols());
+		for (size_t c = 0; c < layout_x.nrows(); c++){
+			layout_energy[c] = (ssc_number_t)batch.annualEnergy[c];
+			layout_loss[c] = (ssc_number_t)batch.wakeLoss[c];
+			for (size_t t = 0; t < layout_x.ncols(); t++)
+				layout_eff[c * layout_x.ncols() + t] = (ssc_number_t)batch.turbineEff(c, t);
+		}
+	}
+
     ssc_number_t* p_annual_energy_dist_time = gen_heatmap(this, steps_per_hour);
 	// assign outputs
 	assign("annual_energy", var_data((ssc_number_t)annual));
@@ -635,6 +745,8 @@ void cm_windpower::exec()
 	assign("kwh_per_kw", var_data((ssc_number_t)kWhperkW));
 	assign("cutoff_losses", var_data((ssc_number_t)((withoutCutOffLosses - annual) / withoutCutOffLosses)));
 	assign("annual_gross_energy", annual_gross);
+	if (responseBins)
+		assign("wind_farm_bin_error", var_data((ssc_number_t)wpc.GetResponseBinError()));
 
     assign("lat", wdprov->lat);
     assign("lon", wdprov->lon);
@@ -31,6 +31,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 #include "common.h"
 #include "vartab.h"
@@ -598,29 +601,22 @@ ssc_number_t* gen_heatmap(compute_module* cm, double step_per_hour) {
     if (!cm)
         return 0;
     size_t count = (size_t)(8760 * step_per_hour);
- //   size_t imonth = 0;
     size_t iday = 0;
     size_t hour;
     size_t count_gen;
     ssc_number_t* p_gen = cm->as_array("gen", &count_gen);
     ssc_number_t* p_annual_energy_dist_time = cm->allocate("annual_energy_distribution_time", 25, 366);
+    // row 0 holds the day index, column 0 the hour of day
+    for (size_t d = 0; d < 366; d++)
+        p_annual_energy_dist_time[d] = (ssc_number_t)d;
+    for (size_t h = 1; h < 25; h++)
+        p_annual_energy_dist_time[h * 366] = (ssc_number_t)(h - 1);
     for (size_t i = 0; i < count; i++) {
         hour = (size_t)fmod(floor(double(i) / step_per_hour), 24);
         iday = (size_t)floor((double(i) / step_per_hour) / 24) ;
-        for (size_t d = 0; d < 366; d++) {
-            for (size_t h = 0; h < 25; h++) {
-                if (i == 0) {
-                    p_annual_energy_dist_time[h * 366] = (ssc_number_t)(h - 1);
-                    p_annual_energy_dist_time[d] = (ssc_number_t)d;
-                }
-                if (iday == d && hour == (h - 1) && d != 365) {
-                    p_annual_energy_dist_time[h * 366 + d + 1] += p_gen[i] * 1 / step_per_hour;
-                    break;
-                }
-            }
-        }
+        if (iday < 365)
+            p_annual_energy_dist_time[(hour + 1) * 366 + iday + 1] += p_gen[i] * 1 / step_per_hour;
     }
-    p_annual_energy_dist_time[0] = 0;
     return p_annual_energy_dist_time;
 
 
@@ -644,6 +640,16 @@ bool calculate_p50p90(compute_module *cm){
 	return true;
 }
 
+double empirical_exceedance(std::vector<double> values, double exceedance){
+    if (values.empty())
+        return std::numeric_limits<double>::quiet_NaN();
+    std::sort(values.begin(), values.end());
+    double pos = (1. - exceedance) * (values.size() - 1);
+    size_t lo = (size_t)std::floor(pos);
+    size_t hi = std::min(lo + 1, values.size() - 1);
+    return values[lo] + (pos - lo) * (values[hi] - values[lo]);
+}
+
 /* the conditions on inputs will have to be expanded and abstracted to handle all technologies with dispatchable storage */
 var_info vtab_forecast_price_signal[] = {
 	// model selected PPA or Merchant Plant based
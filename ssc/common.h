@@ -72,6 +72,10 @@ extern var_info vtab_hybrid_fin_om[];
 
 bool calculate_p50p90(compute_module *cm);
 
+// value exceeded with probability `exceedance` (0.9 for P90) in an empirical sample,
+// interpolating linearly between order statistics
+double empirical_exceedance(std::vector<double> values, double exceedance);
+
 void calculate_resilience_outputs(compute_module *cm, std::unique_ptr<resilience_runner> &resilience);
 
 ssc_number_t* gen_heatmap(compute_module* cm, double step_per_hour);
@@ -1066,6 +1066,119 @@ ssc_number_t compute_module::accumulate_annual_for_year(const std::string &ts_va
     return (ssc_number_t) (sum * scale);
 }
 
+timeseries_aggregator::timeseries_aggregator(compute_module *cm, size_t step_per_hour)
+    : m_cm(cm), m_step_per_hour(step_per_hour) {
+}
+
+std::vector<timeseries_aggregator::reduction> &timeseries_aggregator::source(const std::string &ts_var) {
+    for (auto &s : m_sources)
+        if (s.first == ts_var)
+            return s.second;
+    m_sources.push_back(std::make_pair(ts_var, std::vector<reduction>()));
+    return m_sources.back().second;
+}
+
+void timeseries_aggregator::annual(const std::string &ts_var, const std::string &annual_var, double scale) {
+    reduction r = { ANNUAL, annual_var, scale, 1, true, 0.0, 0 };
+    source(ts_var).push_back(r);
+}
+
+void timeseries_aggregator::monthly(const std::string &ts_var, const std::string &monthly_var, double scale) {
+    reduction r = { MONTHLY, monthly_var, scale, 1, true, 0.0, 0 };
+    source(ts_var).push_back(r);
+}
+
+void timeseries_aggregator::annual_for_year(const std::string &ts_var, const std::string &annual_var, double scale, size_t year) {
+    reduction r = { ANNUAL, annual_var, scale, year, false, 0.0, 0 };
+    source(ts_var).push_back(r);
+}
+
+void timeseries_aggregator::monthly_for_year(const std::string &ts_var, const std::string &monthly_var, double scale, size_t year) {
+    reduction r = { MONTHLY, monthly_var, scale, year, false, 0.0, 0 };
+    source(ts_var).push_back(r);
+}
+
+void timeseries_aggregator::heatmap(const std::string &ts_var, const std::string &heatmap_var) {
+    reduction r = { HEATMAP, heatmap_var, 1.0, 1, false, 0.0, 0 };
+    source(ts_var).push_back(r);
+}
+
+void timeseries_aggregator::compute() {
+    size_t annual_values = m_step_per_hour * 8760;
+    double step_per_hour = (double)m_step_per_hour;
+
+    for (auto &src : m_sources) {
+        std::vector<reduction> &reductions = src.second;
+
+        size_t count = 0;
+        ssc_number_t *ts = m_cm->as_array(src.first, &count);
+
+        size_t last_year = 1;
+        bool single_year = false;
+        for (auto &r : reductions) {
+            last_year = std::max(last_year, r.year);
+            single_year = single_year || r.single_year;
+        }
+        if (!ts || m_step_per_hour < 1 || m_step_per_hour > 60 || last_year * annual_values > count
+            || (single_year && annual_values != count))
+            throw exec_error("generic", "Failed to aggregate time series (hourly or subhourly): " + src.first);
+
+        for (auto &r : reductions) {
+            if (r.type == MONTHLY)
+                r.out = m_cm->allocate(r.var, 12);
+            else if (r.type == HEATMAP) {
+                r.out = m_cm->allocate(r.var, 25, 366);
+                for (size_t d = 0; d < 366; d++)
+                    r.out[d] = (ssc_number_t)d;
+                for (size_t h = 1; h < 25; h++)
+                    r.out[h * 366] = (ssc_number_t)(h - 1);
+            }
+        }
+
+        for (size_t year = 1; year <= last_year; year++) {
+            bool needed = false;
+            for (auto &r : reductions)
+                needed = needed || r.year == year;
+            if (!needed) continue;
+
+            size_t c = (year - 1) * annual_values;
+            size_t i = 0; // step within the year
+            for (int m = 0; m < 12; m++) {
+                for (size_t n = 0; n < util::nday[m] * 24 * m_step_per_hour; n++, c++, i++) {
+                    ssc_number_t v = ts[c];
+                    for (auto &r : reductions) {
+                        if (r.year != year) continue;
+                        if (r.type == ANNUAL)
+                            r.sum += v;
+                        else if (r.type == MONTHLY)
+                            r.out[m] += v;
+                        else {
+                            size_t hour = i / m_step_per_hour;
+                            r.out[(hour % 24 + 1) * 366 + hour / 24 + 1] += v * 1 / step_per_hour;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (auto &r : reductions) {
+            if (r.type == ANNUAL)
+                m_cm->assign(r.var, var_data((ssc_number_t)(r.sum * r.scale)));
+            else if (r.type == MONTHLY)
+                for (int m = 0; m < 12; m++)
+                    r.out[m] *= (ssc_number_t)r.scale;
+        }
+    }
+}
+
+ssc_number_t timeseries_aggregator::annual_value(const std::string &annual_var) {
+    for (auto &src : m_sources)
+        for (auto &r : src.second)
+            if (r.type == ANNUAL && r.var == annual_var)
+                return (ssc_number_t)(r.sum * r.scale);
+    throw exec_error("generic", "No annual time series aggregation registered for " + annual_var);
+}
+
 bool write_cmod_to_lk_script(FILE* fp, ssc_data_t p_data)
 {
     const char* name = ssc_data_first(p_data);
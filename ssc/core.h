@@ -316,6 +316,51 @@ public:
 		  if (!m_cm->on_extproc_output(text)) m_cm->log( "stdout(child): " + text, SSC_NOTICE ); }
 };
 
+/**
+* Fused time series post-processing. Register the annual, monthly and heatmap outputs a module
+* needs, then compute() looks up each source series once and fills all of its outputs in a
+* single pass. Results are identical to accumulate_annual_for_year, accumulate_monthly_for_year
+* and gen_heatmap.
+*/
+class timeseries_aggregator
+{
+public:
+	timeseries_aggregator( compute_module *cm, size_t step_per_hour );
+
+	// sum of single year ts_var times scale, assigned as a number; ts_var must have exactly one year of steps
+	void annual( const std::string &ts_var, const std::string &annual_var, double scale = 1.0 );
+	// monthly sums of single year ts_var times scale, assigned as a 12 element array; ts_var must have exactly one year of steps
+	void monthly( const std::string &ts_var, const std::string &monthly_var, double scale = 1.0 );
+	// as annual and monthly, for one year of a ts_var which has at least that many years of steps
+	void annual_for_year( const std::string &ts_var, const std::string &annual_var, double scale = 1.0, size_t year = 1 );
+	void monthly_for_year( const std::string &ts_var, const std::string &monthly_var, double scale = 1.0, size_t year = 1 );
+	// 25 x 366 hour-of-day by day-of-year energy matrix of the first year, laid out as gen_heatmap
+	void heatmap( const std::string &ts_var, const std::string &heatmap_var );
+
+	void compute();
+
+	// annual result assigned by compute()
+	ssc_number_t annual_value( const std::string &annual_var );
+
+private:
+	enum { ANNUAL, MONTHLY, HEATMAP };
+	struct reduction {
+		int type;
+		std::string var;
+		double scale;
+		size_t year;
+		bool single_year;
+		double sum;
+		ssc_number_t *out;
+	};
+
+	compute_module *m_cm;
+	size_t m_step_per_hour;
+	std::vector< std::pair< std::string, std::vector<reduction> > > m_sources;
+
+	std::vector<reduction> &source( const std::string &ts_var );
+};
+
 
 
 #define DEFINE_MODULE_ENTRY( name, desc, ver ) \
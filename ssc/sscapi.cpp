@@ -68,8 +68,10 @@ extern module_entry_info
 	cm_entry_singlediode,
 	cm_entry_singlediodeparams,
 	cm_entry_iec61853par,
+	cm_entry_iec61853par_batch,
 	cm_entry_iec61853interp,
 	cm_entry_6parsolve,
+	cm_entry_6parsolve_batch,
 	cm_entry_pvsamv1,
 	cm_entry_pvwattsv0,
 	cm_entry_pvwattsv1,
@@ -166,7 +168,8 @@ extern module_entry_info
 	cm_entry_battery_stateful,
     cm_entry_csp_subcomponent,
     cm_entry_hybrid_steps,
-    cm_entry_hybrid
+    cm_entry_hybrid,
+    cm_entry_p50p90_ensemble
     ;
 
 /* official module table */
@@ -174,8 +177,10 @@ static module_entry_info *module_table[] = {
 	&cm_entry_singlediode,
 	&cm_entry_singlediodeparams,
 	&cm_entry_iec61853par,
+	&cm_entry_iec61853par_batch,
 	&cm_entry_iec61853interp,
 	&cm_entry_6parsolve,
+	&cm_entry_6parsolve_batch,
 	&cm_entry_pv6parmod,
 	&cm_entry_pvsamv1,
 	//&cm_entry_pvwattsv0,
@@ -273,6 +278,7 @@ static module_entry_info *module_table[] = {
     &cm_entry_csp_subcomponent,
     &cm_entry_hybrid_steps,
     &cm_entry_hybrid,
+    &cm_entry_p50p90_ensemble,
 0 };
 
 SSCEXPORT ssc_module_t ssc_module_create( const char *name )
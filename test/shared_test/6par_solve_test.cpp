@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
+#include <cmath>
 #include <vector>
 #include <string>
 #include <gtest/gtest.h>
@@ -92,3 +93,81 @@ TEST(SixParSolve_6par_solve, CIGSModules) {
         EXPECT_GT(err, -1);
     }
 }
+
+TEST(SixParSolve_6par_solve, BatchModules) {
+    // type, Vmp, Imp, Voc, Isc, alpha_isc, beta_voc, gamma_pmp, Nser, Tref
+    std::vector<std::vector<double>> datasheet_values {
+            {module6par::monoSi, 31.8, 17.29, 38.1, 18.39, 0.007356, -0.09525, -0.34, 110, 43},
+            {module6par::monoSi, 31.7, 17.29, 38.1, 18.39, 0.0007356, -0.09525, -0.34, 110, 43},
+            {module6par::monoSi, 34.6, 17.34, 41.7, 18.42, 0.007368, -0.10425, -0.34, 120, 43},
+            {module6par::monoSi, 34.85, 17.22, 41.4, 18.5, 0.0074, -0.11178, -0.35, 120, 44},
+            {module6par::monoSi, 34.7, 17.28, 41.5, 18.45, 0.0074, -0.1100, -0.35, 120, 44},
+            {module6par::CIGS, 88.3, 1.7, 108.9, 1.83, 0.000183, -0.29403, -0.32, 96, 42}
+    };
+
+    module6par_batch batch;
+    for (auto &mod : datasheet_values)
+        batch.modules.push_back(module6par((int)mod[0], mod[1], mod[2], mod[3], mod[4], mod[6], mod[5], mod[7], (int)mod[8], mod[9] + 273.15));
+    module6par_batch serial = batch;
+
+    batch.solve(300, 1e-7, 4);
+    serial.solve(300, 1e-7, 1);
+
+    int nwarm = 0;
+    for (size_t i = 0; i < datasheet_values.size(); i++) {
+        EXPECT_GT(batch.err[i], -1) << "module " << i;
+        EXPECT_LT(batch.residual[i], 1e-3) << "module " << i;
+        nwarm += batch.warm_started[i];
+
+        // results do not depend on the number of threads
+        EXPECT_EQ(batch.modules[i].a, serial.modules[i].a);
+        EXPECT_EQ(batch.modules[i].Rsh, serial.modules[i].Rsh);
+        EXPECT_EQ(batch.warm_started[i], serial.warm_started[i]);
+    }
+    EXPECT_GT(nwarm, 0);
+}
+
+TEST(SixParSolve_6par_solve, BatchWarmStartMatchesSingleSolve) {
+    // type, Vmp, Imp, Voc, Isc, alpha_isc, beta_voc, gamma_pmp, Nser, Tref
+    std::vector<std::vector<double>> datasheet_values {
+            {module6par::monoSi, 31.8, 17.29, 38.1, 18.39, 0.007356, -0.09525, -0.34, 110, 43},
+            {module6par::monoSi, 31.7, 17.29, 38.1, 18.39, 0.0007356, -0.09525, -0.34, 110, 43},
+            {module6par::monoSi, 34.6, 17.34, 41.7, 18.42, 0.007368, -0.10425, -0.34, 120, 43},
+            {module6par::monoSi, 34.85, 17.22, 41.4, 18.5, 0.0074, -0.11178, -0.35, 120, 44},
+            {module6par::monoSi, 34.7, 17.28, 41.5, 18.45, 0.0074, -0.1100, -0.35, 120, 44},
+            {module6par::CIGS, 88.3, 1.7, 108.9, 1.83, 0.000183, -0.29403, -0.32, 96, 42}
+    };
+
+    module6par_batch batch;
+    for (auto &mod : datasheet_values)
+        batch.modules.push_back(module6par((int)mod[0], mod[1], mod[2], mod[3], mod[4], mod[6], mod[5], mod[7], (int)mod[8], mod[9] + 273.15));
+    std::vector<module6par> single = batch.modules;
+    batch.solve(300, 1e-7, 1, true);
+
+    // nexact counts the warm-started modules compared parameter by parameter
+    int nwarm = 0, nexact = 0;
+    for (size_t i = 0; i < single.size(); i++) {
+        // cold start, as 6parsolve does
+        ASSERT_GT(single[i].solve_with_sanity_and_heuristics<double>(300, 1e-7), -1) << "module " << i;
+        ASSERT_GT(batch.err[i], -1) << "module " << i;
+        nwarm += batch.warm_started[i];
+
+        const module6par &warm = batch.modules[i], &cold = single[i];
+        double cold_residual = single[i].max_residual();
+        if (cold_residual > 1e-3) {
+            // the cold solve only converged for a perturbed Isc, which the warm start does not need
+            EXPECT_TRUE(batch.warm_started[i]) << "module " << i;
+            EXPECT_LT(batch.residual[i], cold_residual) << "module " << i;
+            continue;
+        }
+        nexact += batch.warm_started[i];
+        EXPECT_NEAR(warm.a, cold.a, 1e-4 * cold.a) << "module " << i;
+        EXPECT_NEAR(warm.Il, cold.Il, 1e-4 * cold.Il) << "module " << i;
+        EXPECT_NEAR(warm.Io, cold.Io, 1e-3 * cold.Io) << "module " << i;
+        EXPECT_NEAR(warm.Rs, cold.Rs, 1e-3 * cold.Rs) << "module " << i;
+        EXPECT_NEAR(warm.Rsh, cold.Rsh, 1e-3 * cold.Rsh) << "module " << i;
+        EXPECT_NEAR(warm.Adj, cold.Adj, 1e-3 * std::abs(cold.Adj) + 1e-6) << "module " << i;
+    }
+    EXPECT_GT(nwarm, 0);
+    EXPECT_GE(nexact, 2);
+}
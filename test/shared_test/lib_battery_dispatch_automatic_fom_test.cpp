@@ -664,3 +664,110 @@ TEST_F(AutoFOM_lib_battery_dispatch, DispatchFOM_DCAuto_ClipChargeFlatRate) {
 
     }
 }
+
+TEST_F(AutoFOM_lib_battery_dispatch, DispatchFOM_DCAutoCopiedForecast) {
+    double dtHour = 1;
+    CreateBattery(dtHour);
+    dispatchAuto = new dispatch_automatic_front_of_meter_t(batteryModel, dtHour, 10, 100, 1, 49960, 49960, max_power,
+                                                           max_power, max_power, max_power, 1, dispatch_t::FOM_AUTOMATED_ECONOMIC, dispatch_t::WEATHER_FORECAST_CHOICE::WF_LOOK_AHEAD, dispatch_t::FRONT, 1, 18, 1, true, true, false,
+                                                           false, 77000, replacementCost, 1, cyclingCost, omCost, ppaRate, ur, 98, 98, 98, interconnection_limit);
+    dispatchAuto->update_pv_data(pv);
+    dispatchAuto->update_cliploss_data(clip);
+
+    // the forecasts and their window statistics are carried over by the copy, so both should see the same benefits
+    dispatch_automatic_front_of_meter_t dispatchCopy(*dispatchAuto);
+    std::vector<BatteryPower*> powers = { dispatchAuto->getBatteryPower(), dispatchCopy.getBatteryPower() };
+    for (auto power : powers) {
+        power->connectionMode = ChargeController::DC_CONNECTED;
+        power->voltageSystem = 600;
+        power->setSharedInverter(m_sharedInverter);
+    }
+
+    for (size_t h = 0; h < 24; h++) {
+        for (auto power : powers) {
+            power->powerGeneratedBySystem = pv[h];
+            power->powerSystem = pv[h];
+            power->powerSystemClipped = clip[h];
+        }
+        dispatchAuto->update_dispatch(0, h, 0, h);
+        dispatchCopy.update_dispatch(0, h, 0, h);
+        EXPECT_NEAR(dispatchCopy.benefit_charge(), dispatchAuto->benefit_charge(), 1e-9) << "error in copied benefit at hour " << h;
+        EXPECT_NEAR(dispatchCopy.benefit_gridcharge(), dispatchAuto->benefit_gridcharge(), 1e-9) << "error in copied benefit at hour " << h;
+        EXPECT_NEAR(dispatchCopy.benefit_clipcharge(), dispatchAuto->benefit_clipcharge(), 1e-9) << "error in copied benefit at hour " << h;
+        EXPECT_NEAR(dispatchCopy.benefit_discharge(), dispatchAuto->benefit_discharge(), 1e-9) << "error in copied benefit at hour " << h;
+        EXPECT_EQ(dispatchCopy.benefit_clipcharge() > 0, clip[h] > 0) << "error in copied clipping forecast at hour " << h;
+    }
+}
+
+TEST_F(AutoFOM_lib_battery_dispatch, DispatchFOM_DCOptimized) {
+    double dtHour = 1;
+    CreateBattery(dtHour);
+    dispatchAuto = new dispatch_automatic_front_of_meter_t(batteryModel, dtHour, 10, 100, 1, 49960, 49960, max_power,
+                                                           max_power, max_power, max_power, 1, dispatch_t::FOM_OPTIMIZED, dispatch_t::WEATHER_FORECAST_CHOICE::WF_LOOK_AHEAD, dispatch_t::FRONT, 1, 18, 1, true, true, false,
+                                                           false, 77000, replacementCost, 1, cyclingCost, omCost, ppaRate, ur, 98, 98, 98, interconnection_limit);
+
+    // battery setup
+    dispatchAuto->update_pv_data(pv);
+    dispatchAuto->update_cliploss_data(clip);
+    batteryPower = dispatchAuto->getBatteryPower();
+    batteryPower->connectionMode = ChargeController::DC_CONNECTED;
+    batteryPower->voltageSystem = 600;
+    batteryPower->setSharedInverter(m_sharedInverter);
+
+    // Prices are 0.04938 $/kWh for hours 0 - 5, 0.03246 for hours 6 - 16 and 0.15828 for hours 17 - 21, and each solve looks
+    // 18 hours ahead. With 98% efficiencies and a 0.005 $/kWh cycling cost, discharging at 0.04938 nets 0.0434 $/kWh, buying PV
+    // at 0.03246 costs 0.0331 $/kWh stored, and energy left at the end of a horizon is worth 0.0268 $/kWh. The battery starts at
+    // 50% SOC, about 65 MWh above the minimum, and cannot charge and discharge in the same hour.
+    // Hour 0: the horizon only reaches one expensive hour, so stored energy is worth its end value. Discharging 25 MW earns
+    //         25000 * (0.0434 - 0.0268) = $415, more than the $262 the 9767 kW of clipped power would be worth
+    // Hour 1: the inverter only has 77000 - 70098 = 6902 kW of room to discharge, which earns $115, less than the $270 of
+    //         storing the 10052 kW of clipped power
+    // Hour 2: the horizon now needs 75 MWh for hours 17 - 19, more than is stored plus the clipped power still to come, so
+    //         stored energy is worth the PV price. Storing 9202 kW of clipped power ($305) beats discharging 25 MW ($257)
+    // Hours 3 - 4: PV fills the inverter, so the only option is to charge from clipped power
+    // Hours 6 - 9: Charge from PV during the lowest prices until full
+    // Hours 17 - 22: Discharge at full power during the highest prices, then the rest down to min SOC
+    std::vector<double> targetkW = { 25000, -10052.4, -9202.19, -7205.42, -1854.6, 0., // 0 - 5
+                                    -7267.76, -25000, -25000, -25000, 0., 0., // 6 - 11
+                                    0., 0., 0., 0., 0., 25000, // 12 - 17
+                                    25000, 25000, 25000, 25000, 20530.62, 0. }; // 18 - 23
+    std::vector<double> SOC = { 34.69, 40.65, 46.07, 50.31, 51.41, 51.41, // 0 - 5
+                                55.67, 70.06, 84.38, 98.64, 98.64, 98.64, // 6 - 11
+                                98.64, 98.64, 98.64, 98.64, 98.64, 83.85, // 12 - 17
+                                68.99, 54.00, 38.78, 22.98, 10, 10 }; // 18 - 23
+    for (size_t h = 0; h < 24; h++) {
+        batteryPower->powerGeneratedBySystem = pv[h];
+        batteryPower->powerSystem = pv[h];
+        batteryPower->powerSystemClipped = clip[h];
+
+        dispatchAuto->dispatch(0, h, 0);
+        EXPECT_NEAR(batteryPower->powerBatteryTarget, targetkW[h], 0.1) << "error in expected target at hour " << h;
+        EXPECT_NEAR(dispatchAuto->battery_soc(), SOC[h], 0.1) << "error in SOC at hour " << h;
+    }
+}
+
+TEST(FOMDispatchLP_lib_battery_dispatch, NoSimultaneousChargeDischarge) {
+    // a full battery facing negative prices would be paid to charge from the grid while discharging at the same time
+    fom_dispatch_lp_t lp(1, 1., 50, 0.9, 0.9, 0.9);
+    fom_dispatch_lp_t::horizon_t horizon;
+    horizon.price_sell = { -0.1 };
+    horizon.price_buy = { -0.1 };
+    horizon.power_pv_max = { 0 };
+    horizon.power_clipped_max = { 0 };
+    horizon.power_discharge_max = { 50 };
+    horizon.power_grid_charge_max = 50;
+    horizon.energy_initial = 100;
+    horizon.energy_max = 100;
+    horizon.cost_discharge = 0;
+
+    ASSERT_TRUE(lp.solve(horizon));
+    EXPECT_NEAR(lp.power_battery(0), 0, 1e-6);
+    EXPECT_NEAR(lp.energy(0), 100, 1e-6);
+    EXPECT_NEAR(lp.objective(), 0, 1e-6) << "cycling within the step should not earn revenue";
+
+    // with room to store, charging alone is paid
+    horizon.energy_initial = 50;
+    ASSERT_TRUE(lp.solve(horizon));
+    EXPECT_NEAR(lp.power_battery(0), -50, 1e-6);
+    EXPECT_NEAR(lp.objective(), 50 * 0.1 / 0.9, 1e-6);
+}
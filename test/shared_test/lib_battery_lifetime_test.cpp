@@ -447,3 +447,36 @@ TEST_F(lib_battery_lifetime_test, TestCycleDegradationDifferentOrdering) {
     }
     EXPECT_NEAR(low_hi_model->capacity_percent_cycle(), 52.02, 0.1);
 }
+
+TEST_F(lib_battery_lifetime_test, TestRainflowStateRestored) {
+    // damped cycling stacks up peaks until the large swings at the end close the cycles
+    std::vector<double> DOD = { 0, 90, 10, 80, 20, 70, 30, 60, 40, 50, 45 };
+    std::vector<double> DOD_end = { 0, 100, 0, 100, 0 };
+    size_t idx = 0;
+    for (; idx < DOD.size(); idx++)
+        model->runLifetimeModels(idx, true, idx > 0 ? DOD[idx - 1] : 0, DOD[idx], 20);
+
+    // a state read back from outside carries the peaks but not their running max
+    lifetime_state state = model->get_state();
+    state.cycle->rainflow_peaks_max.clear();
+    std::unique_ptr<lifetime_calendar_cycle_t> restored_model = std::unique_ptr<lifetime_calendar_cycle_t>(new lifetime_calendar_cycle_t(cycles_vs_DOD, dt_hour, 1.02, 2.66e-3, -7280, 930));
+    restored_model->set_state(state);
+
+    double prev_DOD = DOD.back();
+    for (double D : DOD_end) {
+        model->runLifetimeModels(idx, true, prev_DOD, D, 20);
+        restored_model->runLifetimeModels(idx, true, prev_DOD, D, 20);
+        prev_DOD = D;
+        idx++;
+    }
+
+    lifetime_state s = model->get_state();
+    lifetime_state s_restored = restored_model->get_state();
+    EXPECT_GT(s.n_cycles, 4);
+    EXPECT_EQ(s_restored.n_cycles, s.n_cycles);
+    EXPECT_NEAR(s.cycle_DOD, 100, 1e-7);
+    EXPECT_NEAR(s_restored.cycle_DOD, s.cycle_DOD, 1e-7);
+    EXPECT_NEAR(s_restored.cycle->q_relative_cycle, s.cycle->q_relative_cycle, 1e-7);
+    EXPECT_EQ(s_restored.cycle->rainflow_peaks, s.cycle->rainflow_peaks);
+    EXPECT_EQ(s.cycle->rainflow_peaks_max.size(), s.cycle->rainflow_peaks.size());
+}
@@ -410,6 +410,39 @@ TEST_F(lib_battery_test, runDuplicates) {
     delete Battery;
 }
 
+TEST_F(lib_battery_test, SnapshotAndRestore) {
+    auto Battery = new battery_t(*batteryModel);
+    for (size_t i = 0; i < 20; i++) {
+        double I = (i % 4 < 2) ? 10 : -10;
+        Battery->run(i, I);
+    }
+
+    // snapshot into existing storage, which must not be aliased with the battery's own
+    battery_state snapshot;
+    Battery->get_state(snapshot);
+    auto cap_ptr = snapshot.capacity.get();
+    double I = 10;
+    Battery->run(20, I);
+    EXPECT_NE(snapshot.capacity->q0, Battery->get_state().capacity->q0);
+
+    Battery->set_state(snapshot);
+    EXPECT_TRUE(*snapshot.capacity == *Battery->get_state().capacity);
+    Battery->get_state(snapshot);
+    EXPECT_EQ(cap_ptr, snapshot.capacity.get());
+
+    // restoring from another battery gives the same trajectory as running from the snapshot
+    batteryModel->set_state(*Battery);
+    I = 10;
+    Battery->run(20, I);
+    I = 10;
+    batteryModel->run(20, I);
+    EXPECT_TRUE(*batteryModel->get_state().capacity == *Battery->get_state().capacity);
+    EXPECT_DOUBLE_EQ(batteryModel->V(), Battery->V());
+    EXPECT_EQ(batteryModel->get_state().lifetime->cycle->rainflow_peaks, Battery->get_state().lifetime->cycle->rainflow_peaks);
+
+    delete Battery;
+}
+
 TEST_F(lib_battery_test, createFromParams) {
     auto params = std::make_shared<battery_params>(batteryModel->get_params());
     auto bat = battery_t(params);
@@ -364,6 +364,78 @@ TEST_F(voltage_dynamic_lib_battery_voltage_test, calculateMaxDischargeSubMinute)
     EXPECT_NEAR(cap->SOC(), 92.736, 1e-3);
 }
 
+TEST_F(voltage_dynamic_lib_battery_voltage_test, currentForTargetMatchesIterative) {
+    n_strings = 5;
+    double qmax = Qfull * n_strings;
+    for (double dt_hour : { 1., 1. / 60. }) {
+        voltage_dynamic_solver_probe probe(n_cells_series, n_strings, voltage_nom, Vfull, Vexp, Vnom, Qfull, Qexp,
+                                           Qnom, Vcut, C_rate, R, dt_hour);
+        probe.set_initial_SOC(50);
+        for (double SOC : { 10., 50., 90. }) {
+            for (double P : { -5000., -1000., 500., 2000., 5000., 8000. }) {
+                double q = SOC / 100. * qmax;
+                EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4)
+                    << "dt " << dt_hour << ", SOC " << SOC << ", power " << P;
+            }
+        }
+    }
+}
+
+TEST_F(voltage_dynamic_lib_battery_voltage_test, currentForTargetMemo) {
+    n_strings = 5;
+    double dt_hour = 1;
+    voltage_dynamic_solver_probe probe(n_cells_series, n_strings, voltage_nom, Vfull, Vexp, Vnom, Qfull, Qexp,
+                                       Qnom, Vcut, C_rate, R, dt_hour);
+    probe.set_initial_SOC(50);
+    double q = 5, qmax = 11, P = 2000;
+    double current = probe.calculate_current_for_target_w(P, q, qmax, 293);
+    EXPECT_NEAR(current, probe.current_iterative(P, q, qmax), 1e-4);
+    ASSERT_TRUE(probe.target_memo().valid);
+
+    // an identical call returns the stored current without solving, as does a different temperature, which the
+    // model does not depend on
+    double marker = -999;
+    probe.target_memo().current = marker;
+    EXPECT_EQ(probe.calculate_current_for_target_w(P, q, qmax, 293), marker);
+    EXPECT_EQ(probe.calculate_current_for_target_w(P, q, qmax, 313), marker);
+
+    // any other input solves again
+    q = 6;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+    probe.target_memo().current = marker;
+    qmax = 10.5;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+    probe.target_memo().current = marker;
+    P = 2500;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+    probe.target_memo().current = marker;
+    probe.set_dt_hr(0.5);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+}
+
+TEST_F(voltage_dynamic_lib_battery_voltage_test, currentForTargetFallback) {
+    n_strings = 5;
+    double dt_hour = 1;
+    voltage_dynamic_solver_probe probe(n_cells_series, n_strings, voltage_nom, Vfull, Vexp, Vnom, Qfull, Qexp,
+                                       Qnom, Vcut, C_rate, R, dt_hour);
+    probe.set_initial_SOC(50);
+    double qmax = Qfull * n_strings;
+
+    // near empty, the linearized voltage has no root for 2 kW
+    double q = 0.1 * qmax, P = 2000;
+    EXPECT_LT(probe.discriminant(P, q, qmax), 0);
+    EXPECT_LT(probe.current_quadratic(P, q, qmax), 0);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), 3.168, 1e-3);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+
+    // it has a root for 500 W, but the Newton polish from that root fails
+    P = 500;
+    EXPECT_GT(probe.discriminant(P, q, qmax), 0);
+    EXPECT_LT(probe.current_quadratic(P, q, qmax), 0);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), 0.628, 1e-3);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax), 1e-4);
+}
+
 TEST_F(voltage_dynamic_lib_battery_voltage_cutoff_test, calculateMaxChargeHourly) {
     double dt_hour = 1;
     CreateModel(dt_hour);
@@ -1383,3 +1455,78 @@ TEST_F(voltage_vanadium_lib_battery_voltage_test, calculateMaxDischargeSubMinute
     cap->updateCapacity(max_current, dt_hour);
     EXPECT_NEAR(cap->SOC(), 13.93, 1e-3);
 }
+
+TEST_F(voltage_vanadium_lib_battery_voltage_test, currentForTargetMatchesIterative) {
+    double qmax = 10;
+    for (double dt_hour : { 1., 1. / 60. }) {
+        voltage_vanadium_solver_probe probe(n_cells_series, n_strings, voltage_nom, R, dt_hour);
+        probe.set_initial_SOC(50);
+        for (double SOC : { 10., 50., 90. }) {
+            for (double P : { -20000., -5000., -1000., 500., 2000., 5000. }) {
+                double q = SOC / 100. * qmax;
+                EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax, 293), 1e-4)
+                    << "dt " << dt_hour << ", SOC " << SOC << ", power " << P;
+            }
+        }
+    }
+}
+
+TEST_F(voltage_vanadium_lib_battery_voltage_test, currentForTargetCharging) {
+    double dt_hour = 1;
+    voltage_vanadium_solver_probe probe(n_cells_series, n_strings, voltage_nom, R, dt_hour);
+    probe.set_initial_SOC(50);
+    double q = 5, qmax = 10;
+    for (double P : { -20000., -5000., -1000. }) {
+        double I = 0;
+        EXPECT_TRUE(probe.current_quadratic(P, q, qmax, 293, I)) << "power " << P;
+        EXPECT_LT(I, 0) << "power " << P;
+        double current = probe.calculate_current_for_target_w(P, q, qmax, 293);
+        EXPECT_NEAR(current, I * n_strings, 1e-10) << "power " << P;
+        EXPECT_NEAR(current, probe.current_iterative(P, q, qmax, 293), 1e-4) << "power " << P;
+    }
+    EXPECT_NEAR(probe.calculate_current_for_target_w(-5000, q, qmax, 293), -9.247, 1e-3);
+}
+
+TEST_F(voltage_vanadium_lib_battery_voltage_test, currentForTargetMemo) {
+    double dt_hour = 1;
+    voltage_vanadium_solver_probe probe(n_cells_series, n_strings, voltage_nom, R, dt_hour);
+    probe.set_initial_SOC(50);
+    double q = 5, qmax = 10, P = 2000, T = 293;
+    double current = probe.calculate_current_for_target_w(P, q, qmax, T);
+    EXPECT_NEAR(current, probe.current_iterative(P, q, qmax, T), 1e-4);
+    ASSERT_TRUE(probe.target_memo().valid);
+
+    // an identical call returns the stored current without solving
+    double marker = -999;
+    probe.target_memo().current = marker;
+    EXPECT_EQ(probe.calculate_current_for_target_w(P, q, qmax, T), marker);
+
+    // any other input solves again
+    q = 6;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, T), probe.current_iterative(P, q, qmax, T), 1e-4);
+    probe.target_memo().current = marker;
+    qmax = 9;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, T), probe.current_iterative(P, q, qmax, T), 1e-4);
+    probe.target_memo().current = marker;
+    T = 313;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, T), probe.current_iterative(P, q, qmax, T), 1e-4);
+    probe.target_memo().current = marker;
+    P = -2000;
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, T), probe.current_iterative(P, q, qmax, T), 1e-4);
+    probe.target_memo().current = marker;
+    probe.set_dt_hr(0.5);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, T), probe.current_iterative(P, q, qmax, T), 1e-4);
+}
+
+TEST_F(voltage_vanadium_lib_battery_voltage_test, currentForTargetFallback) {
+    double dt_hour = 1;
+    voltage_vanadium_solver_probe probe(n_cells_series, n_strings, voltage_nom, R, dt_hour);
+    probe.set_initial_SOC(50);
+
+    // near empty, the linearized voltage has no root for 10 kW
+    double q = 1, qmax = 10, P = 10000, I = 0;
+    EXPECT_LT(probe.discriminant(P, q, qmax, 293), 0);
+    EXPECT_FALSE(probe.current_quadratic(P, q, qmax, 293, I));
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), 18.119, 1e-3);
+    EXPECT_NEAR(probe.calculate_current_for_target_w(P, q, qmax, 293), probe.current_iterative(P, q, qmax, 293), 1e-4);
+}
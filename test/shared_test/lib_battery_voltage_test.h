@@ -35,7 +35,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define SAM_SIMULATION_CORE_LIB_BATTERY_VOLTAGE_TEST_H
 
 #include <gtest/gtest.h>
+#include <functional>
 
+#include "6par_newton.h"
 #include "lib_util.h"
 //#include "lib_battery_voltage.h"
 #include "lib_battery.h"
@@ -193,4 +195,94 @@ protected:
     }
 };
 
+// Exposes the closed form current solve and its memo, and runs the line search Newton solve it replaced for comparison
+class voltage_dynamic_solver_probe : public voltage_dynamic_t {
+public:
+    using voltage_dynamic_t::voltage_dynamic_t;
+
+    voltage_solve_memo &target_memo() { return memo_target; }
+
+    void set_dt_hr(double dt_hr) { params->dt_hr = dt_hr; }
+
+    // cell current of the closed form solve, negative if it falls back to the line search
+    double current_quadratic(double P_watts, double q, double qmax) {
+        return solve_current_quadratic(set_solver(P_watts, q, qmax));
+    }
+
+    // discriminant of the quadratic from the cell voltage linearized about zero current
+    double discriminant(double P_watts, double q, double qmax) {
+        double direction = set_solver(P_watts, q, qmax);
+        double dV_dI;
+        double V = solver_voltage(0, direction, &dV_dI);
+        return V * V + 4. * dV_dI * solver_power;
+    }
+
+    // battery current of the line search Newton solve
+    double current_iterative(double P_watts, double q, double qmax) {
+        double direction = set_solver(P_watts, q, qmax);
+        std::function<void(const double *, double *)> f = [this, direction](const double *x, double *resid) {
+            if (direction > 0)
+                solve_current_for_discharge_power(x, resid);
+            else
+                solve_current_for_charge_power(x, resid);
+        };
+        double x[1], resid[1];
+        x[0] = solver_power / (state->cell_voltage != 0 ? state->cell_voltage : params->dynamic.Vnom) * params->dt_hr;
+        bool check = false;
+        newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f, 100, 1e-6, 1e-6, 0.7);
+        return x[0] * params->num_strings * direction;
+    }
+
+private:
+    double set_solver(double P_watts, double q, double qmax) {
+        solver_power = std::abs(P_watts) / (params->num_cells_series * params->num_strings);
+        solver_q = q / params->num_strings;
+        solver_Q = qmax / params->num_strings;
+        solver_Q_mod = params->dynamic.Vcut != 0 ? calculate_Qfull_mod(solver_Q) : solver_Q;
+        return P_watts > 0 ? 1. : -1.;
+    }
+};
+
+class voltage_vanadium_solver_probe : public voltage_vanadium_redox_t {
+public:
+    using voltage_vanadium_redox_t::voltage_vanadium_redox_t;
+
+    voltage_solve_memo &target_memo() { return memo_target; }
+
+    void set_dt_hr(double dt_hr) { params->dt_hr = dt_hr; }
+
+    // returns false if the closed form solve falls back to the line search
+    bool current_quadratic(double P_watts, double q, double qmax, double kelvin, double &I) {
+        set_solver(P_watts, q, qmax, kelvin);
+        return solve_current_quadratic(I);
+    }
+
+    double discriminant(double P_watts, double q, double qmax, double kelvin) {
+        set_solver(P_watts, q, qmax, kelvin);
+        double dV_dI;
+        double V = solver_voltage(0, &dV_dI);
+        return V * V + 4. * dV_dI * solver_power;
+    }
+
+    double current_iterative(double P_watts, double q, double qmax, double kelvin) {
+        set_solver(P_watts, q, qmax, kelvin);
+        std::function<void(const double *, double *)> f = [this](const double *x, double *resid) {
+            solve_current_for_power(x, resid);
+        };
+        double x[1], resid[1];
+        x[0] = solver_power / (state->cell_voltage != 0. ? state->cell_voltage : params->Vnom_default) * params->dt_hr;
+        bool check = false;
+        newton<double, std::function<void(const double *, double *)>, 1>(x, resid, check, f, 100, 1e-6, 1e-6, 0.7);
+        return x[0] * params->num_strings;
+    }
+
+private:
+    void set_solver(double P_watts, double q, double qmax, double kelvin) {
+        solver_power = P_watts / (params->num_cells_series * params->num_strings);
+        solver_q = q / params->num_strings;
+        solver_Q = qmax / params->num_strings;
+        solver_T_k = kelvin;
+    }
+};
+
 #endif //SAM_SIMULATION_CORE_LIB_BATTERY_VOLTAGE_TEST_H
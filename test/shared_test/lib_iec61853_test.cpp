@@ -0,0 +1,118 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <lib_iec61853.h>
+
+/**
+* IEC 61853 parameter fitting tests, using a test matrix generated from the FS-267 parameters
+*/
+
+static util::matrix_t<double> fs267_test_matrix(double Il_scale)
+{
+    iec61853_module_t m;
+    m.set_fs267_from_matlab();
+    const int ncells = 116;
+    const double q = 1.6e-19, k = 1.38e-23;
+    const double irrs[] = { 200, 400, 600, 800, 1000, 1100 };
+    const double temps[] = { 15, 25, 50, 75 };
+
+    util::matrix_t<double> input(24, iec61853_module_t::COL_MAX);
+    size_t r = 0;
+    for (size_t i = 0; i < 6; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            double G = irrs[i];
+            double Tc = temps[j] + 273.15;
+            double a = ncells * m.n * k * Tc / q;
+            double Il = Il_scale * G / 1000 * (m.Il + m.alphaIsc * (Tc - 298.15));
+            double Eg = (1 - 0.0002677 * (Tc - 298.15)) * m.Egref;
+            double Io = m.Io * pow(Tc / 298.15, 3.0) * exp(11600 * (m.Egref / 298.15 - Eg / Tc));
+            double Rs = m.D1 + m.D2 * (Tc - 298.15) + m.D3 * (1 - G / 1000.0) * pow(1000.0 / G, 2.0);
+            double Rsh = m.C1 + m.C2 * (pow(1000.0 / G, m.C3) - 1);
+            double Voc = openvoltage_5par(90, a, Il, Io, Rsh);
+            double Vmp, Imp;
+            double Pmp = maxpower_5par(Voc, a, Il, Io, Rs, Rsh, &Vmp, &Imp);
+            input(r, iec61853_module_t::COL_IRR) = G;
+            input(r, iec61853_module_t::COL_TC) = temps[j];
+            input(r, iec61853_module_t::COL_PMP) = Pmp;
+            input(r, iec61853_module_t::COL_VMP) = Vmp;
+            input(r, iec61853_module_t::COL_VOC) = Voc;
+            input(r, iec61853_module_t::COL_ISC) = current_5par(0, 0.9 * Il, a, Il, Io, Rs, Rsh);
+            r++;
+        }
+    }
+    return input;
+}
+
+TEST(iec61853Test, AnalyticJacobianMatchesFiniteDifference) {
+    util::matrix_t<double> input = fs267_test_matrix(1.0), par_analytic, par_fd;
+
+    iec61853_module_t analytic;
+    ASSERT_TRUE(analytic.calculate(input, 116, iec61853_module_t::CdTe, par_analytic, false));
+
+    iec61853_module_t fd;
+    fd.UseAnalyticJacobian = false;
+    ASSERT_TRUE(fd.calculate(input, 116, iec61853_module_t::CdTe, par_fd, false));
+
+    EXPECT_NEAR(analytic.Egref, fd.Egref, 1e-6 * std::abs(fd.Egref));
+    EXPECT_NEAR(analytic.C1, fd.C1, 1e-6 * std::abs(fd.C1));
+    EXPECT_NEAR(analytic.C2, fd.C2, 1e-4 * std::abs(fd.C2));
+    EXPECT_NEAR(analytic.C3, fd.C3, 1e-4 * std::abs(fd.C3));
+    EXPECT_NEAR(analytic.D1, fd.D1, 1e-4 * std::abs(fd.D1));
+    EXPECT_NEAR(analytic.D3, fd.D3, 1e-4 * std::abs(fd.D3));
+}
+
+TEST(iec61853Test, BatchMatchesSerial) {
+    const double scales[] = { 1.0, 0.9, 1.1, 1.05, 0.95 };
+    iec61853_batch_t batch;
+    batch.resize(5);
+    for (size_t i = 0; i < 5; i++) {
+        batch.input[i] = fs267_test_matrix(scales[i]);
+        batch.nseries[i] = 116;
+        batch.type[i] = iec61853_module_t::CdTe;
+    }
+    EXPECT_EQ(batch.calculate(3), 5);
+
+    for (size_t i = 0; i < 5; i++) {
+        iec61853_module_t serial;
+        util::matrix_t<double> par;
+        ASSERT_TRUE(serial.calculate(batch.input[i], 116, iec61853_module_t::CdTe, par, false));
+        EXPECT_EQ(batch.ok[i], 1);
+        EXPECT_DOUBLE_EQ(batch.modules[i].Il, serial.Il);
+        EXPECT_DOUBLE_EQ(batch.modules[i].Io, serial.Io);
+        EXPECT_DOUBLE_EQ(batch.modules[i].Egref, serial.Egref);
+        EXPECT_DOUBLE_EQ(batch.modules[i].C2, serial.C2);
+        EXPECT_DOUBLE_EQ(batch.modules[i].D1, serial.D1);
+    }
+}
@@ -880,6 +880,46 @@ TEST_F(BifacialIrradTest, TestVerticalOrientation)
     ASSERT_NEAR(std::accumulate(rearIrradiance.begin(), rearIrradiance.end(), 0.), 874.733, 0.05);
 }
 
+/**
+*   Test that the rear-side calculation reusing cached view factors and scratch buffers across time steps
+*   matches a calculation from a freshly constructed irradiance processor
+*/
+TEST_F(BifacialIrradTest, TestRearSideCachedGeometry)
+{
+    std::vector<double> spatialAlbedos = { 0.2, 0.3, 0.4, 0.5, 0.6, 0.2, 0.3, 0.4, 0.5, 0.6 };
+    for (int trackingModeTest : {0, 1}) {
+        tracking = trackingModeTest;
+        for (size_t s = 0; s < samples.size(); s++) {
+            runIrradCalc(samples[s]);
+            irr->set_sky_model(skyModel, albedo, spatialAlbedos);
+            irr->calc();
+            irr->calc_rear_side(transmissionFactor, 1.0, slopeLength);
+            double rearCached = irr->get_poa_rear();
+            std::vector<double> rearSpatialCached = irr->get_poa_rear_spatial();
+            std::vector<double> groundSpatialCached = irr->get_ground_spatial();
+
+            delete irr;
+            irr = new irrad();
+            runIrradCalc(samples[s]);
+            irr->set_sky_model(skyModel, albedo, spatialAlbedos);
+            irr->calc();
+            irr->calc_rear_side(transmissionFactor, 1.0, slopeLength);
+
+            ASSERT_DOUBLE_EQ(rearCached, irr->get_poa_rear()) << "Failed at t = " << samples[s];
+            std::vector<double> rearSpatial = irr->get_poa_rear_spatial();
+            std::vector<double> groundSpatial = irr->get_ground_spatial();
+            ASSERT_EQ(rearSpatialCached.size(), rearSpatial.size());
+            for (size_t i = 0; i < rearSpatial.size(); i++) {
+                ASSERT_DOUBLE_EQ(rearSpatialCached[i], rearSpatial[i]) << "Failed at t = " << samples[s] << " i = " << i;
+            }
+            ASSERT_EQ(groundSpatialCached.size(), groundSpatial.size());
+            for (size_t i = 0; i < groundSpatial.size(); i++) {
+                ASSERT_DOUBLE_EQ(groundSpatialCached[i], groundSpatial[i]) << "Failed at t = " << samples[s] << " i = " << i;
+            }
+        }
+    }
+}
+
 /**
 *   Test single-axis tracking and bactracking rotations and shaded fraction
 */
@@ -963,3 +1003,59 @@ TEST(SingleAxisTrackingTest, SunBelowTiltedArray) {
 }
 
 
+
+/**
+*   Batch POA decomposition matches step by step poaDecomp, including the steps with the sun behind the array
+*/
+TEST(PoaDecompTest, BatchMatchesSequential) {
+    poa_decomp_batch_t batch;
+    poaDecompReq &req = batch.data;
+    req.elev = 1600;
+
+    // a vertical south facing surface in early summer has the sun behind it in the morning and evening
+    size_t ndays = 3;
+    for (size_t d = 0; d < ndays; d++) {
+        for (int h = 0; h < 24; h++) {
+            double sun[9], angle[5];
+            solarpos(2019, 6, 20 + (int)d, h, 30, 39.7, -105.2, -7, sun);
+            incidence(0, 90, 180, 0, sun[1], sun[0], false, 0, 0, 0, false, 0, angle);
+            req.inc.push_back(angle[0]);
+            req.tilt.push_back(angle[1]);
+            req.zen.push_back(sun[1]);
+            req.exTer.push_back(sun[8]);
+            req.POA.push_back(sun[1] < M_PI / 2 ? 100 + 700 * std::max(0.0, cos(angle[0])) : -999);
+            batch.tDew.push_back(5 + h % 7);
+        }
+    }
+    batch.albedo.push_back(0.2);
+
+    size_t nok = batch.calculate(2);
+    ASSERT_EQ(batch.dn.size(), req.POA.size());
+
+    size_t behind = 0;
+    for (size_t i = 0; i < req.POA.size(); i++) {
+        if (req.zen[i] >= M_PI / 2) {
+            EXPECT_EQ(batch.gh[i], 0);
+            continue;
+        }
+        if (req.inc[i] >= M_PI / 2) behind++;
+
+        poaDecompReq step = req;
+        step.i = i;
+        step.dayStart = i - i % 24;
+        step.doy = (int)(i / 24);
+        step.tDew = batch.tDew[i];
+        double angle[5] = { req.inc[i], req.tilt[i], 0, 0, 0 };
+        double sun[9] = { 0, req.zen[i], 0, 0, 0, 0, 0, 0, req.exTer[i] };
+        double dn, df, gh, poa[3] = { 0, 0, 0 }, diffc[3] = { 0, 0, 0 };
+        int err = poaDecomp(req.POA[i], angle, sun, 0.2, &step, dn, df, gh, poa, diffc);
+
+        EXPECT_EQ(batch.errorcode[i], err) << "step " << i;
+        EXPECT_DOUBLE_EQ(batch.dn[i], dn) << "step " << i;
+        EXPECT_DOUBLE_EQ(batch.df[i], df) << "step " << i;
+        EXPECT_DOUBLE_EQ(batch.gh[i], gh) << "step " << i;
+        EXPECT_DOUBLE_EQ(batch.poaBeam[i], poa[0]) << "step " << i;
+    }
+    EXPECT_GT(behind, 0);
+    EXPECT_GT(nok, 0);
+}
@@ -0,0 +1,78 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <lib_mlmodel.h>
+
+/**
+* Mermoud Lejeune model IAM table tests
+*/
+
+class MLModelTest_lib_mlmodel : public ::testing::Test {
+protected:
+    mlmodel_module_t tabulated;
+    mlmodel_module_t direct;
+
+    // spline IAM from pvyield_common_data; only the IAM inputs are needed
+    void setup(mlmodel_module_t& mod, bool useTable) {
+        double angle[9] = { 0.0, 30.0, 50.0, 65.0, 70.0, 75.0, 80.0, 85.0, 90.0 };
+        double value[9] = { 1.0, 1.0, 1.0, 0.961, 0.918, 0.837, 0.705, 0.457, 0.0 };
+        mod.IAM_mode = 3; // cubic spline with user-supplied data
+        mod.IAM_c_cs_elements = 9;
+        for (int i = 0; i < 9; i++) {
+            mod.IAM_c_cs_incAngle[i] = angle[i];
+            mod.IAM_c_cs_iamValue[i] = value[i];
+        }
+        mod.IAM_c_cs_useTable = useTable;
+        mod.initializeManual();
+    }
+
+    void SetUp() override {
+        setup(tabulated, true);
+        setup(direct, false);
+    }
+};
+
+TEST_F(MLModelTest_lib_mlmodel, IAMTableMatchesSpline) {
+    // sweep the range of the incidence angle data, which is also the domain of the spline
+    const size_t n = 20000;
+    for (size_t i = 0; i <= n; i++) {
+        double theta = 90. * i / n;
+        EXPECT_NEAR(tabulated.IAMvalue_spline(theta), direct.IAMvalue_spline(theta), 1e-8) << "theta " << theta;
+    }
+    // the spline knots themselves
+    for (int i = 0; i < 9; i++) {
+        double theta = tabulated.IAM_c_cs_incAngle[i];
+        EXPECT_NEAR(tabulated.IAMvalue_spline(theta), direct.IAMvalue_spline(theta), 1e-8) << "theta " << theta;
+    }
+}
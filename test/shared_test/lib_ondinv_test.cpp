@@ -0,0 +1,120 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <lib_ondinv.h>
+
+/**
+* ONDA inverter efficiency table tests
+*/
+
+class ONDInverterTest_lib_ondinv : public ::testing::Test {
+protected:
+    ond_inverter tabulated;
+    ond_inverter direct;
+
+    // 500 kW inverter with three efficiency curves, from pvyield_common_data
+    void setup(ond_inverter& inv, bool useTable) {
+        inv.PNomConv = 500000;
+        inv.PMaxOUT = 600000;
+        inv.VOutConv = 300;
+        inv.VMppMin = 450;
+        inv.VMPPMax = 825;
+        inv.VAbsMax = 1000;
+        inv.PSeuil = 2500;
+        inv.ModeOper = "MPPT";
+        inv.CompPMax = "Lim";
+        inv.CompVMax = "Lim";
+        inv.ModeAffEnum = "Efficiencyf_PIn";
+        inv.PNomDC = 500000;
+        inv.PMaxDC = 600000;
+        inv.IMaxDC = 1375;
+        inv.INomDC = 1145;
+        inv.INomAC = 965;
+        inv.IMaxAC = 1160;
+        inv.TPNom = 50;
+        inv.TPMax = 25;
+        inv.TPLim1 = 51;
+        inv.TPLimAbs = 60;
+        inv.PLim1 = 495000;
+        inv.PLimAbs = 0;
+        inv.NbInputs = 15;
+        inv.NbMPPT = 1;
+        inv.Aux_Loss = 350;
+        inv.Night_Loss = 65;
+        inv.lossRDc = 0.01162243;
+        inv.lossRAc = 0.001552915;
+        inv.effCurve_elements = 8;
+        inv.doAllowOverpower = -1;
+        inv.doUseTemperatureLimit = -1;
+        inv.doUseEfficiencyTable = useTable;
+
+        double vnom[3] = { 450, 600, 825 };
+        double pdc[3][8] = { { 2500, 25400, 50400, 100000, 149700, 249900, 375300, 500000 },
+                             { 2500, 25300, 50600, 100400, 149900, 249900, 375300, 500000 },
+                             { 2500, 25600, 50500, 100000, 150000, 250200, 375600, 500000 } };
+        double eta[3][8] = { { 0, 0.937, 0.966, 0.981, 0.986, 0.986, 0.983, 0.981 },
+                             { 0, 0.925, 0.968, 0.976, 0.9810001, 0.984, 0.982, 0.98 },
+                             { 0, 0.8469999, 0.97, 0.958, 0.971, 0.976, 0.976, 0.974 } };
+        for (int j = 0; j < 3; j++) {
+            inv.VNomEff[j] = vnom[j];
+            for (int i = 0; i < 100; i++) {
+                inv.effCurve_Pdc[j][i] = i < 8 ? pdc[j][i] : 0;
+                inv.effCurve_eta[j][i] = i < 8 ? eta[j][i] : 0;
+                inv.effCurve_Pac[j][i] = inv.effCurve_Pdc[j][i] * inv.effCurve_eta[j][i];
+            }
+        }
+        inv.initializeManual();
+    }
+
+    void SetUp() override {
+        setup(tabulated, true);
+        setup(direct, false);
+    }
+};
+
+TEST_F(ONDInverterTest_lib_ondinv, EfficiencyTableMatchesSpline) {
+    // sweep from below the atan region to above the last curve point, which is clamped
+    const size_t n = 20000;
+    for (int j = 0; j < 3; j++) {
+        for (size_t i = 0; i <= n; i++) {
+            double Pdc = 550000. * i / n;
+            EXPECT_NEAR(tabulated.calcEfficiency(Pdc, j), direct.calcEfficiency(Pdc, j), 1e-10) << "curve " << j << ", Pdc " << Pdc;
+        }
+        // the curve points themselves
+        for (int i = 2; i < 8; i++) {
+            double Pdc = tabulated.effCurve_Pdc[j][i];
+            EXPECT_NEAR(tabulated.calcEfficiency(Pdc, j), direct.calcEfficiency(Pdc, j), 1e-10) << "curve " << j << ", Pdc " << Pdc;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <lib_pvshade.h>
+
+/**
+* Self-shading sky diffuse derate table tests
+*/
+
+TEST(sssky_diffuse_table_lib_pvshade, initialTiltExact) {
+    sssky_diffuse_table table;
+    table.init(33.33, 0.4);
+    EXPECT_EQ(table.lookup(33.33), table.compute(33.33));
+    EXPECT_NEAR(table.lookup(0.), 1., 1e-8);
+}
+
+TEST(sssky_diffuse_table_lib_pvshade, gridInterpolation) {
+    for (double gcr : {0.2, 0.4, 0.7}) {
+        sssky_diffuse_table table;
+        table.init(0., gcr);
+        for (double tilt = 0.; tilt < 90.; tilt += 0.731) {
+            EXPECT_NEAR(table.lookup(tilt), table.compute(tilt), 1e-6) << "gcr " << gcr << ", tilt " << tilt;
+        }
+        // grid nodes are computed exactly
+        EXPECT_DOUBLE_EQ(table.lookup(45.), table.compute(45.));
+    }
+}
+
+TEST(sssky_diffuse_table_lib_pvshade, reinitWithNewGcr) {
+    sssky_diffuse_table table;
+    table.init(0., 0.3);
+    double derate_low_gcr = table.lookup(30.05);
+    table.init(0., 0.6);
+    double derate_high_gcr = table.lookup(30.05);
+    EXPECT_NEAR(derate_high_gcr, table.compute(30.05), 1e-6);
+    EXPECT_LT(derate_high_gcr, derate_low_gcr);
+}
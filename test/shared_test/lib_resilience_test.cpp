@@ -727,3 +727,45 @@ TEST_F(ResilienceTest_lib_resilience, PVWattsACHourly_Charge)
     for (size_t i = 0; i < cdf.size(); i++)
         EXPECT_NEAR(cdf[i] + survival_fx[i], 1., 1e-3) << i;
 }
+
+TEST_F(ResilienceTest_lib_resilience, ThreadsAndOutageInterval)
+{
+    // batt is dc-connected and charging, so the outages started later last long enough to be split across threads
+    CreateBattery(false, 1, 1., 0.5, -0.5);
+
+    resilience_runner serial(batt);
+    resilience_runner threaded(batt, 1, 4);
+    resilience_runner sampled(batt, 3);
+    std::vector<double> crit_load(load.size(), 0.05);
+    std::vector<double> pv(ac.size(), 0.);
+    const double voltage = 500;
+    size_t max_surviving = 0;
+    for (size_t i = 0; i < 100; i++){
+        batt->initialize_time(0, i, 0);
+        serial.add_battery_at_outage_timestep(*dispatch, i);
+        threaded.add_battery_at_outage_timestep(*dispatch, i);
+        sampled.add_battery_at_outage_timestep(*dispatch, i);
+        serial.run_surviving_batteries(crit_load[i], 0, 0, 0, 0, 0);
+        threaded.run_surviving_batteries(crit_load[i], 0, 0, 0, 0, 0);
+        sampled.run_surviving_batteries(crit_load[i], 0, 0, 0, 0, 0);
+        batt->advance(vartab, ac[i], voltage, load[i], load[i]);
+        max_surviving = std::max(max_surviving, threaded.get_n_surviving_batteries());
+    }
+    EXPECT_GT(max_surviving, 64);
+    EXPECT_EQ(sampled.get_n_surviving_batteries(), (serial.get_n_surviving_batteries() + 2) / 3);
+
+    serial.run_surviving_batteries_by_looping(&crit_load[0], &pv[0]);
+    threaded.run_surviving_batteries_by_looping(&crit_load[0], &pv[0]);
+    sampled.run_surviving_batteries_by_looping(&crit_load[0], &pv[0]);
+
+    auto serial_hours = serial.get_hours_survived();
+    auto threaded_hours = threaded.get_hours_survived();
+    auto sampled_hours = sampled.get_hours_survived();
+    EXPECT_GT(serial_hours[99], 0);
+    for (size_t i = 0; i < 100; i++){
+        EXPECT_EQ(threaded_hours[i], serial_hours[i]) << i;
+        EXPECT_EQ(sampled_hours[i], serial_hours[i - i % 3]) << i;
+    }
+    EXPECT_NEAR(threaded.get_avg_crit_load_kwh(), serial.get_avg_crit_load_kwh(), 1e-12);
+    EXPECT_NEAR(threaded.compute_metrics(), serial.compute_metrics(), 1e-12);
+}
@@ -261,3 +261,41 @@ TEST_F(sharedInverterTest_lib_shared_inverter, calculateEffForACPower) {
         EXPECT_NEAR(inv->powerAC_kW, -sandia.Paco / 1000., 1e-3) << "inverter cannot produce more than max (negative) Paco";
     }
 }
+
+TEST_F(sharedInverterTest_lib_shared_inverter, calculateRequiredDCPowerAboveClipping) {
+    // any target above max ac returns the same, smallest dc power that reaches the clipping limit
+    double p_kwdc = inv->calculateRequiredDCPower(sandia.Paco * 1.05 / 1000., sandia.Vdco, 25);
+    for (auto p : { 1.1, 2., 10. }) {
+        EXPECT_NEAR(inv->calculateRequiredDCPower(sandia.Paco * p / 1000., sandia.Vdco, 25), p_kwdc, 1e-5) << "Paco * " << p;
+        EXPECT_NEAR(inv->calculateRequiredDCPower(-sandia.Paco * p / 1000., sandia.Vdco, 25), -p_kwdc, 1e-5) << "Paco * -" << p;
+    }
+
+    inv->calculateACPower(p_kwdc, sandia.Vdco, 25);
+    EXPECT_NEAR(inv->powerAC_kW, sandia.Paco / 1000., 1e-5);
+    inv->calculateACPower(p_kwdc - 1e-3, sandia.Vdco, 25);
+    EXPECT_LT(inv->powerAC_kW, sandia.Paco / 1000.) << "less dc power should not reach the clipping limit";
+}
+
+TEST_F(sharedInverterTest_lib_shared_inverter, calculateEffForACPowerWithTempDerate) {
+    std::vector<double> c1 = { 200., 20., -0.02, 40., -0.04 };
+    std::vector<double> c2 = { 700., 30., -0.03, 60., -0.06 };
+    std::vector<std::vector<double>> curves = { c1, c2 };
+    EXPECT_FALSE(inv->setTempDerateCurves(curves));
+
+    double T = 35.;
+    inv->calculateACPower(sandia.Pdco / 1000., sandia.Vdco, T);
+    double max_kwac = inv->powerAC_kW;
+    EXPECT_LT(max_kwac, sandia.Paco / 1000.) << "derate should limit ac output below Paco";
+
+    for (auto p : { 0.1, 0.5, 0.9 }) {
+        double p_kwac = max_kwac * p;
+        double p_kwdc = inv->calculateRequiredDCPower(p_kwac, sandia.Vdco, T);
+        inv->calculateACPower(p_kwdc, sandia.Vdco, T);
+        EXPECT_NEAR(inv->powerAC_kW, p_kwac, 1e-3) << "derated inverter should produce required ac of max * " << p;
+    }
+
+    // derated maximum cannot be exceeded
+    double p_kwdc = inv->calculateRequiredDCPower(sandia.Paco / 1000., sandia.Vdco, T);
+    inv->calculateACPower(p_kwdc, sandia.Vdco, T);
+    EXPECT_NEAR(inv->powerAC_kW, max_kwac, 1e-3);
+}
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 
+#include <cmath>
 #include <string>
 #include <gtest/gtest.h>
 #include <lib_util.h>
@@ -63,6 +64,64 @@ TEST(libUtilTests, testNearestColValue) {
     ASSERT_EQ(8, util::nearest_col_index(cycles_vs_DOD, 0, 100));
 }
 
+TEST(libUtilTests, testUniformCubicTable) {
+    util::uniform_cubic_table table;
+    EXPECT_FALSE(table.in_range(0.));
+
+    // quadratics are reproduced exactly away from the end intervals
+    std::vector<double> y;
+    for (size_t i = 0; i <= 10; i++)
+        y.push_back(std::pow(i * 0.5, 2));
+    table.init(0., 5., y);
+    EXPECT_TRUE(table.in_range(0.));
+    EXPECT_TRUE(table.in_range(5.));
+    EXPECT_FALSE(table.in_range(5.1));
+    EXPECT_NEAR(table.eval(0.), 0., 1e-12);
+    EXPECT_NEAR(table.eval(5.), 25., 1e-12);
+    EXPECT_NEAR(table.eval(2.3), 2.3 * 2.3, 1e-12);
+    EXPECT_NEAR(table.eval(3.75), 3.75 * 3.75, 1e-12);
+
+    // dense tables track smooth curves closely
+    y.clear();
+    for (size_t i = 0; i < 1025; i++)
+        y.push_back(std::sin(i * 3. / 1024));
+    table.init(0., 3., y);
+    for (double x = 0.; x <= 3.; x += 0.0137)
+        EXPECT_NEAR(table.eval(x), std::sin(x), 1e-7) << x;
+}
+
+TEST(libUtilTests, testParallelFor) {
+    EXPECT_EQ(util::thread_count(8, 3), 3);
+    EXPECT_EQ(util::thread_count(-1, 0), 1);
+    EXPECT_GE(util::thread_count(0, 1000), 1);
+
+    // every task runs exactly once, on a valid thread index
+    std::vector<int> runs(1000, 0);
+    std::vector<int> thread(1000, -1);
+    util::parallel_for(runs.size(), 4, [&](size_t i, int t) {
+        runs[i]++;
+        thread[i] = t;
+    });
+    for (size_t i = 0; i < runs.size(); i++) {
+        EXPECT_EQ(runs[i], 1) << i;
+        EXPECT_TRUE(thread[i] >= 0 && thread[i] < 4) << i;
+    }
+
+    // a worker's exception reaches the caller after the threads join, instead of terminating
+    for (int nthreads : { 1, 4 }) {
+        try {
+            util::parallel_for(1000, nthreads, [](size_t i, int) {
+                if (i == 37)
+                    throw std::runtime_error("task 37");
+            });
+            FAIL() << "exception was not rethrown";
+        }
+        catch (std::runtime_error& e) {
+            EXPECT_STREQ(e.what(), "task 37");
+        }
+    }
+}
+
 TEST(sscapiTest, SSC_DATARR_test)
 {
     // create data entries
@@ -231,6 +231,42 @@ TEST(lib_utility_rate_test, test_demand_charges_crossing_months)
 	ASSERT_NEAR(11.25, cost, 0.02);
 }
 
+TEST(lib_utility_rate_test, test_restore_state_crossing_months)
+{
+    rate_data data;
+    set_up_default_commercial_rate_data(data); // Net billing
+
+    int steps_per_hour = 1;
+    std::vector<double> monthly_load_forecast = { 150, 75 };
+    std::vector<double> monthly_gen_forecast = { 0, 0 };
+    std::vector<double> monthly_avg_gross_load = { 100, 50 };
+    util::matrix_t<double> monthly_peaks;
+    monthly_peaks.resize_fill(1, 1, 0.0);
+
+    UtilityRateForecast rate_forecast(&data, steps_per_hour, monthly_load_forecast, monthly_gen_forecast, monthly_avg_gross_load, 2, monthly_peaks);
+    rate_forecast.initializeMonth(0, 0);
+    rate_forecast.copyTOUForecast();
+
+    // - is load
+    std::vector<double> forecast = { -100, -50, -50, -25 };
+    std::vector<double> larger_forecast = { -120, -60, -80, -25 };
+    int hour_of_year = 742; // 10 pm on Jan 31st
+
+    UtilityRateForecast what_if(rate_forecast);
+    double larger_cost = what_if.forecastCost(larger_forecast, 0, hour_of_year, 0);
+
+    // Restoring gives the same cost as a fresh copy, without the usage from the first forecast
+    what_if.restoreState(rate_forecast);
+    double cost = what_if.forecastCost(forecast, 0, hour_of_year, 0);
+    ASSERT_NEAR(11.25, cost, 0.02);
+
+    UtilityRateForecast fresh_copy(rate_forecast);
+    ASSERT_DOUBLE_EQ(cost, fresh_copy.forecastCost(forecast, 0, hour_of_year, 0));
+
+    what_if.restoreState(rate_forecast);
+    ASSERT_DOUBLE_EQ(larger_cost, what_if.forecastCost(larger_forecast, 0, hour_of_year, 0));
+}
+
 // Test imperfect peak forecast
 TEST(lib_utility_rate_test, test_demand_charges_inaccurate_forecast)
 {
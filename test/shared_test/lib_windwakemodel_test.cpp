@@ -33,6 +33,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 #include <iostream>
 
@@ -216,3 +217,45 @@ TEST_F(eddyViscosityWakeModelTest, wakeCalcTriangleInterference_lib_windwakemode
 	}
 	EXPECT_EQ(turbIntensity[1], turbIntensity[2]);
 }
+
+/// Crosswind index returns exactly the turbines within the half width, including those on the boundary
+TEST(crosswindIndexTest, rangeQuery_lib_windwakemodel){
+	std::vector<double> crosswind = { 4, -2, 0, 7, -2, 1 };
+	crosswindIndex index;
+	index.build(&crosswind[0], crosswind.size());
+
+	size_t first, last;
+	index.range(0, 2, &first, &last);
+	std::vector<size_t> found;
+	for (size_t pos = first; pos < last; pos++)
+		found.push_back(index.turbine(pos));
+	std::sort(found.begin(), found.end());
+	std::vector<size_t> expected = { 1, 2, 4, 5 };
+	EXPECT_EQ(found, expected);
+
+	index.range(20, 1, &first, &last);
+	EXPECT_EQ(first, last) << "No turbines that far across the wind";
+}
+
+/// Wake profile library interpolation stays close to solving each wake
+TEST_F(eddyViscosityWakeModelTest, wakeCalcProfileLibrary_lib_windwakemodel){
+	for (int i = 0; i < numberTurbines; i++){
+		distDownwind[i] = 5 * i;
+		distCrosswind[i] = 0.5 * i;
+	}
+	std::vector<double> exactPower(power), exactWindSpeed(windSpeed), exactTI(turbIntensity);
+	evm.wakeCalculations(seaLevelAirDensity, &distDownwind[0], &distCrosswind[0], &exactPower[0], &eff[0], &thrust[0], &exactWindSpeed[0], &exactTI[0]);
+
+	ASSERT_TRUE(evm.SetProfileLibrary());
+	EXPECT_TRUE(evm.UsingProfileLibrary());
+	evm.wakeCalculations(seaLevelAirDensity, &distDownwind[0], &distCrosswind[0], &power[0], &eff[0], &thrust[0], &windSpeed[0], &turbIntensity[0]);
+	EXPECT_GT(evm.GetProfileLibraryCount(), 0);
+	for (int i = 0; i < numberTurbines; i++){
+		EXPECT_NEAR(windSpeed[i], exactWindSpeed[i], 0.01) << "windSpeeds at turbine " << i;
+		EXPECT_NEAR(power[i], exactPower[i], 0.005 * exactPower[0]) << "Power calculated at index " << i;
+		EXPECT_NEAR(turbIntensity[i], exactTI[i], 1e-4) << "Turb intensity at turbine " << i;
+	}
+
+	EXPECT_FALSE(evm.SetProfileLibrary(1., 0.25, 0.01)) << "Thrust coefficient step too wide";
+	EXPECT_FALSE(evm.UsingProfileLibrary());
+}
@@ -122,6 +122,26 @@ TEST_F(windPowerCalculatorTest, windPowerUsingWeibull_lib_windwatts){
 	EXPECT_NEAR(energyTotal, 5639180, e);
 }
 
+/// Per-bin Weibull energy from the turbine's cached bin edges against integrating the distribution directly
+TEST_F(windPowerCalculatorTest, windPowerUsingWeibullBins_lib_windwatts){
+	double weibullK = 2.;
+	double avgSpeed = 7.25;
+	double refHeight = 50.;
+	std::vector<double> energy(wpc.windTurb->powerCurveArrayLength);
+	double energyTotal = wpc.windPowerUsingWeibull(weibullK, avgSpeed, refHeight, &energy[0]);
+
+	double lambda = pow(wpc.windTurb->hubHeight / refHeight, wpc.windTurb->shearExponent) * avgSpeed / tgamma(1 + 1 / weibullK);
+	std::vector<double> ws = wpc.windTurb->getPowerCurveWS(), kw = wpc.windTurb->getPowerCurveKW();
+	double sum = 0, previous = 1.0 - exp(-pow(0.125 / lambda, weibullK));
+	for (size_t i = 1; i < ws.size(); i++){
+		double current = 1.0 - exp(-pow((ws[i] + 0.125) / lambda, weibullK));
+		EXPECT_NEAR(energy[i], 8760.0 * (current - previous) * kw[i], 1e-6) << "Bin " << i;
+		previous = current;
+		sum += energy[i];
+	}
+	EXPECT_NEAR(sum, energyTotal, 1e-6);
+}
+
 TEST_F(windPowerCalculatorTest, windPowerUsingDistribution_lib_windwatts){
     // mimic a weibull with k factor 2 and avg speed 7.25 for comparison -> scale param : 8.181
     std::vector<std::vector<double>> dst = {{1.5, 180, .12583},
@@ -156,3 +176,61 @@ TEST_F(windPowerCalculatorTest, windPowerUsingDistribution_1turbine_lib_windwatt
     EXPECT_NEAR(farmPower, 15075000. / 3, e);
     EXPECT_NEAR(farmPowerGross, 15075000. / 3, e);
 }
+
+/// Cells of the distribution with zero frequency are skipped without changing the result
+TEST_F(windPowerCalculatorTest, windPowerUsingDistributionZeroCells_lib_windwatts){
+    std::vector<std::vector<double>> dst = {{1.5, 180, .12583},
+                                            {5, 180, .3933},
+                                            {8, 90, 0.},
+                                            {8, 180, .18276},
+                                            {10, 180, .1341},
+                                            {12, 270, 0.},
+                                            {13.5, 180, .14217},
+                                            {19, 180, .0211}};
+    std::shared_ptr<wakeModelBase> wakeModel = std::make_shared<fakeWakeModel>();
+    wpc.InitializeModel(wakeModel);
+    EXPECT_TRUE(wpc.windPowerUsingDistribution(dst, &farmPower, &farmPowerGross));
+    EXPECT_NEAR(farmPower, 15075000, e);
+    EXPECT_NEAR(farmPowerGross, 15075000, e);
+}
+
+TEST_F(windPowerCalculatorTest, windPowerUsingResourceBinned_lib_windwatts){
+	// 3 x 3 farm, 5 rotor diameters apart, with Park wakes
+	nTurbines = 9;
+	wpc.nTurbines = nTurbines;
+	wpc.XCoords.clear();
+	wpc.YCoords.clear();
+	for (int i = 0; i < nTurbines; i++){
+		wpc.XCoords.push_back(5. * wt.rotorDiameter * (i % 3));
+		wpc.YCoords.push_back(5. * wt.rotorDiameter * (i / 3));
+	}
+	std::vector<double> p(nTurbines), t(nTurbines), ef(nTurbines), ws(nTurbines), ti(nTurbines), dd(nTurbines), dc(nTurbines);
+
+	windPowerCalculator exact = wpc;
+	exact.InitializeModel(std::make_shared<parkWakeModel>(parkWakeModel(nTurbines, &wt)));
+	wpc.InitializeModel(std::make_shared<parkWakeModel>(parkWakeModel(nTurbines, &wt)));
+	ASSERT_TRUE(wpc.SetResponseBins(1., 0.25, 0.01, 10));
+	EXPECT_TRUE(wpc.UsingResponseBins());
+
+	double sumExact = 0, sumBinned = 0;
+	for (int step = 0; step < 500; step++){
+		double speed = 4. + 0.037 * step;
+		double dir = fmod(7.3 * step, 360.);
+		double temp = 5. + 0.05 * step;
+		double exactPower, binnedPower, gross;
+		ASSERT_EQ(exact.windPowerUsingResource(speed, dir, 1.0, temp, &exactPower, &gross, &p[0], &t[0], &ef[0], &ws[0], &ti[0], &dd[0], &dc[0]), nTurbines);
+		ASSERT_EQ(wpc.windPowerUsingResource(speed, dir, 1.0, temp, &binnedPower, &gross, &p[0], &t[0], &ef[0], &ws[0], &ti[0], &dd[0], &dc[0]), nTurbines);
+		sumExact += exactPower;
+		sumBinned += binnedPower;
+		double farmFromTurbines = 0;
+		for (int i = 0; i < nTurbines; i++)
+			farmFromTurbines += p[i];
+		EXPECT_NEAR(farmFromTurbines, binnedPower, 1e-6 * binnedPower + 1e-9);
+	}
+	EXPECT_NEAR(sumBinned / sumExact, 1., 0.01);
+	EXPECT_GT(wpc.GetResponseBinCount(), 0);
+	EXPECT_LT(wpc.GetResponseBinError(), 2.);
+
+	ASSERT_TRUE(wpc.SetResponseBins(0, 0, 0));
+	EXPECT_FALSE(wpc.UsingResponseBins());
+}
@@ -462,3 +462,77 @@ TEST_F(CMBatteryStatefulIntegration_cmod_battery_stateful, ssc_1023) {
     EXPECT_NEAR(temp, 20, 1e-4);
 }
 
+
+TEST_F(CMBatteryStatefulIntegration_cmod_battery_stateful, RunBatch) {
+    CreateModel(1);
+
+    std::vector<double> currents = { 1, 1, 2, -3, -3, 0, 4, 4, -1, 2 };
+    std::vector<double> SOC, V, P;
+    for (double I : currents) {
+        ssc_data_set_number(data, "input_current", I);
+        EXPECT_TRUE(ssc_module_exec(mod, data));
+        auto vt = static_cast<var_table*>(data);
+        SOC.push_back(vt->as_number("SOC"));
+        V.push_back(vt->as_number("V"));
+        P.push_back(vt->as_number("P"));
+    }
+
+    // same steps in two batches, keeping the state in the model between calls
+    ssc_data_t batch_data = json_to_ssc_data(params_str.c_str());
+    ssc_data_set_number(batch_data, "dt_hr", 1);
+    ssc_module_t batch_mod = ssc_module_create("battery_stateful");
+    EXPECT_TRUE(ssc_stateful_module_setup(batch_mod, batch_data));
+    ssc_data_set_number(batch_data, "sync_state", 0);
+    ssc_data_set_number(batch_data, "snapshot_interval", 3);
+
+    std::vector<double> SOC_batch, V_batch, P_batch;
+    auto vt = static_cast<var_table*>(batch_data);
+    for (size_t start : { 0, 5 }) {
+        std::vector<double> controls(currents.begin() + start, currents.begin() + start + 5);
+        vt->assign("input_current_batch", var_data(controls));
+        EXPECT_TRUE(ssc_module_exec(batch_mod, batch_data));
+        for (auto& soc : vt->as_vector_double("SOC_batch")) SOC_batch.push_back(soc);
+        for (auto& v : vt->as_vector_double("V_batch")) V_batch.push_back(v);
+        for (auto& p : vt->as_vector_double("P_batch")) P_batch.push_back(p);
+    }
+
+    ASSERT_EQ(SOC_batch.size(), currents.size());
+    for (size_t i = 0; i < currents.size(); i++) {
+        EXPECT_NEAR(SOC_batch[i], SOC[i], 1e-7) << i;
+        EXPECT_NEAR(V_batch[i], V[i], 1e-7) << i;
+        EXPECT_NEAR(P_batch[i], P[i], 1e-7) << i;
+    }
+    EXPECT_NEAR(vt->as_number("SOC"), SOC.back(), 1e-7);
+    EXPECT_EQ(vt->as_integer("last_idx"), 10);
+
+    // the second batch runs lifetime steps 6 to 10, so its only snapshot is after the third step
+    auto indices = vt->as_vector_double("snapshot_indices");
+    ASSERT_EQ(indices.size(), 1);
+    EXPECT_EQ(indices[0], 8);
+    var_data* snapshot = vt->lookup("state_snapshots")->table.lookup("8");
+    ASSERT_TRUE(snapshot);
+    EXPECT_NEAR(snapshot->table.as_number("SOC"), SOC[7], 1e-7);
+
+    ssc_data_free(batch_data);
+    ssc_module_free(batch_mod);
+}
+
+TEST_F(CMBatteryStatefulIntegration_cmod_battery_stateful, RunBatchWithoutScalarInput) {
+    CreateModel(1);
+    ssc_module_free(mod);
+
+    // set up again with only the batch input
+    auto vt = static_cast<var_table*>(data);
+    vt->unassign("input_current");
+    mod = ssc_module_create("battery_stateful");
+    EXPECT_TRUE(ssc_stateful_module_setup(mod, data));
+
+    // neither the scalar nor the batch input is given
+    EXPECT_FALSE(ssc_module_exec(mod, data));
+
+    std::vector<double> currents = { 1, 2, -3 };
+    vt->assign("input_current_batch", var_data(currents));
+    EXPECT_TRUE(ssc_module_exec(mod, data));
+    EXPECT_EQ(vt->as_vector_double("SOC_batch").size(), currents.size());
+    EXPECT_NEAR(vt->as_number("I"), -3, 1e-7);
+}
@@ -0,0 +1,102 @@
+/*
+BSD 3-Clause License
+
+Copyright Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "../ssc/core.h"
+#include "../ssc/vartab.h"
+#include "../ssc/common.h"
+#include "../input_cases/pvwatts_cases.h"
+
+TEST(P50P90Ensemble_cmod_p50p90_ensemble, PVWattsv8WeatherYears)
+{
+    ssc_data_t data = ssc_data_create();
+    ASSERT_FALSE(pvwatts_nofinancial_testfile(data));
+
+    const char* files[] = { "USA AZ Phoenix (TMY2).csv", "USA AZ Tucson (TMY2).csv",
+        "phoenix_az_33.450495_-111.983688_psmv3_60_tmy.csv", "psm_40_-80_tmy2.csv" };
+
+    // run each weather year on its own for reference
+    std::vector<double> single;
+    std::vector<ssc_var_t> years;
+    for (const char* f : files) {
+        char path[256];
+        sprintf(path, "%s/test/input_cases/pvsamv1_data/%s", SSCDIR, f);
+        ssc_data_set_string(data, "solar_resource_file", path);
+        EXPECT_FALSE(run_module(data, "pvwattsv8"));
+        ssc_number_t annual;
+        ssc_data_get_number(data, "annual_energy", &annual);
+        single.push_back(annual);
+
+        ssc_var_t year = ssc_var_create();
+        ssc_var_set_string(year, path);
+        years.push_back(year);
+    }
+
+    ssc_data_t ensemble = ssc_data_create();
+    ssc_data_set_string(ensemble, "compute_module", "pvwattsv8");
+    ssc_data_set_table(ensemble, "input", data);
+    ssc_data_set_data_array(ensemble, "weather_years", &years[0], (int)years.size());
+    ssc_data_set_number(ensemble, "nthreads", 2);
+    EXPECT_FALSE(run_module(ensemble, "p50p90_ensemble"));
+
+    int n = 0;
+    ssc_number_t* annual = ssc_data_get_array(ensemble, "annual_energy_years", &n);
+    ASSERT_EQ(n, 4);
+    for (int i = 0; i < n; i++)
+        EXPECT_DOUBLE_EQ(annual[i], single[i]) << "weather year " << i;
+
+    std::sort(single.begin(), single.end());
+    ssc_number_t p50, p90;
+    ssc_data_get_number(ensemble, "annual_energy_p50", &p50);
+    ssc_data_get_number(ensemble, "annual_energy_p90", &p90);
+    EXPECT_NEAR(p50, (single[1] + single[2]) / 2., 1e-6);
+    EXPECT_NEAR(p90, single[0] + 0.3 * (single[1] - single[0]), 1e-6);
+
+    ssc_number_t* monthly_p50 = ssc_data_get_array(ensemble, "monthly_energy_p50", &n);
+    ssc_number_t* monthly_p95 = ssc_data_get_array(ensemble, "monthly_energy_p95", &n);
+    ASSERT_EQ(n, 12);
+    for (int m = 0; m < 12; m++)
+        EXPECT_LE(monthly_p95[m], monthly_p50[m]);
+
+    // a year that fails on a worker thread fails the ensemble
+    ssc_var_set_string(years[2], "missing_weather_file.csv");
+    ssc_data_set_data_array(ensemble, "weather_years", &years[0], (int)years.size());
+    EXPECT_TRUE(run_module(ensemble, "p50p90_ensemble"));
+
+    for (size_t i = 0; i < years.size(); i++)
+        ssc_var_free(years[i]);
+    ssc_data_free(ensemble);
+    ssc_data_free(data);
+}
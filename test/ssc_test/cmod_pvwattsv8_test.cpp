@@ -252,6 +252,131 @@ TEST_F(CMPvwattsv8Integration_cmod_pvwattsv8, LifetimeModeTest_cmod_pvwattsv8) {
     EXPECT_TRUE(pvwatts_errors);
 }
 
+/// Test that lifetime years after the first, which reuse the first year DC power, match a full single year calculation
+TEST_F(CMPvwattsv8Integration_cmod_pvwattsv8, LifetimeReuseFirstYearDC_cmod_pvwattsv8) {
+
+    const size_t nyears = 3;
+    double losses = 14.075660705566406;
+    ssc_number_t dc_degradation[1] = { 2.0 };
+    ssc_data_set_number(data, "system_use_lifetime_output", 1);
+    ssc_data_set_number(data, "analysis_period", (ssc_number_t)nyears);
+    ssc_data_set_array(data, "dc_degradation", dc_degradation, 1);
+    ASSERT_FALSE(run_module(data, "pvwattsv8"));
+
+    int n = 0;
+    ssc_number_t* gen = ssc_data_get_array(data, "gen", &n);
+    ASSERT_EQ(n, (int)(8760 * nyears));
+    std::vector<ssc_number_t> lifetime_gen(gen, gen + n);
+
+    // DC degradation multiplies DC power just like the other DC losses, so a single year run with the
+    // degradation folded into the losses input goes through the full calculation for the same result
+    ssc_data_set_number(data, "system_use_lifetime_output", 0);
+    for (size_t y = 1; y < nyears; y++) {
+        double degradation = 1.0 - dc_degradation[0] * y / 100.0;
+        ssc_data_set_number(data, "losses", (ssc_number_t)(100.0 * (1.0 - (1.0 - losses / 100.0) * degradation)));
+        ASSERT_FALSE(run_module(data, "pvwattsv8"));
+        ssc_number_t* gen_year = ssc_data_get_array(data, "gen", &n);
+        ASSERT_EQ(n, 8760);
+        for (size_t i = 0; i < 8760; i++)
+            ASSERT_NEAR(lifetime_gen[y * 8760 + i], gen_year[i], 1e-3) << "year " << y << " hour " << i;
+    }
+}
+
+/// Test the multi-configuration mode against single configuration runs
+TEST_F(CMPvwattsv8Integration_cmod_pvwattsv8, MultiConfiguration_cmod_pvwattsv8) {
+
+    ssc_number_t tilt[3] = { 20, 35, 10 };
+    ssc_number_t azimuth[3] = { 180, 200, 150 };
+    ssc_number_t dc_ac_ratio[3] = { 1.2000000476837158, 1.1, 1.5 };
+
+    // each configuration must match a single run with its tilt, azimuth, and DC to AC ratio,
+    // and gen must match the single run of the first configuration over the analysis period
+    auto compare_to_single_runs = [&](const char* label, std::function<void(ssc_data_t)> set_case_inputs) {
+        std::vector<ssc_number_t> single, single_gen;
+        int n = 0;
+        for (size_t c = 0; c < 3; c++) {
+            ssc_data_t single_data = ssc_data_create();
+            pvwatts_nofinancial_testfile(single_data);
+            set_case_inputs(single_data);
+            ssc_data_set_number(single_data, "tilt", tilt[c]);
+            ssc_data_set_number(single_data, "azimuth", azimuth[c]);
+            ssc_data_set_number(single_data, "dc_ac_ratio", dc_ac_ratio[c]);
+            EXPECT_FALSE(run_module(single_data, "pvwattsv8")) << label;
+            ssc_number_t annual_energy = 0;
+            ssc_data_get_number(single_data, "annual_energy", &annual_energy);
+            single.push_back(annual_energy);
+            if (c == 0) {
+                ssc_number_t* gen = ssc_data_get_array(single_data, "gen", &n);
+                if (gen) single_gen.assign(gen, gen + n);
+            }
+            ssc_data_free(single_data);
+        }
+
+        ssc_data_t batch = ssc_data_create();
+        pvwatts_nofinancial_testfile(batch);
+        set_case_inputs(batch);
+        ssc_data_set_array(batch, "batch_tilt", tilt, 3);
+        ssc_data_set_array(batch, "batch_azimuth", azimuth, 3);
+        ssc_data_set_array(batch, "batch_dc_ac_ratio", dc_ac_ratio, 3);
+        EXPECT_FALSE(run_module(batch, "pvwattsv8")) << label;
+
+        ssc_number_t* batch_energy = ssc_data_get_array(batch, "batch_annual_energy", &n);
+        EXPECT_EQ(n, 3) << label;
+        for (int c = 0; batch_energy && c < n; c++)
+            EXPECT_NEAR(batch_energy[c], single[c], 1e-3) << label << " configuration " << c;
+
+        ssc_number_t* gen = ssc_data_get_array(batch, "gen", &n);
+        EXPECT_EQ(n, (int)single_gen.size()) << label;
+        size_t n_mismatch = 0;
+        for (int i = 0; gen && i < n && i < (int)single_gen.size(); i++)
+            if (std::abs(gen[i] - single_gen[i]) > 1e-6) n_mismatch++;
+        EXPECT_EQ(n_mismatch, 0) << label;
+
+        // time series outputs are skipped, except for generation of the first configuration
+        EXPECT_EQ(ssc_data_get_array(batch, "ac", &n), nullptr) << label;
+        ssc_data_free(batch);
+    };
+
+    compare_to_single_runs("unshaded", [](ssc_data_t) {});
+
+    compare_to_single_runs("shaded", [](ssc_data_t d) {
+        // external beam shading in the morning and evening, and sky diffuse shading
+        ssc_number_t shading_mxh[12 * 24];
+        for (size_t i = 0; i < 12 * 24; i++)
+            shading_mxh[i] = (i % 24 < 9 || i % 24 > 16) ? 30 : 0;
+        ssc_data_set_number(d, "shading_en_mxh", 1);
+        ssc_data_set_matrix(d, "shading_mxh", shading_mxh, 12, 24);
+        ssc_data_set_number(d, "shading_en_diff", 1);
+        ssc_data_set_number(d, "shading_diff", 10);
+    });
+
+    compare_to_single_runs("bifacial", [](ssc_data_t d) {
+        ssc_data_set_number(d, "bifaciality", 0.65);
+    });
+
+    // lifetime years after the first reuse the first year DC power, unless the snow model is enabled
+    auto set_lifetime = [](ssc_data_t d) {
+        ssc_number_t dc_degradation[1] = { 2.0 };
+        ssc_data_set_number(d, "system_use_lifetime_output", 1);
+        ssc_data_set_number(d, "analysis_period", 3);
+        ssc_data_set_array(d, "dc_degradation", dc_degradation, 1);
+    };
+    compare_to_single_runs("multi-year", set_lifetime);
+
+    compare_to_single_runs("multi-year with snow", [&](ssc_data_t d) {
+        set_lifetime(d);
+        char wf_snow[256];
+        sprintf(wf_snow, "%s/test/input_cases/pvsamv1_data/pv_albedo_test.csv", SSCDIR);
+        ssc_data_set_string(d, "solar_resource_file", wf_snow);
+        ssc_data_set_number(d, "en_snowloss", 1);
+    });
+
+    // mismatched configuration arrays are rejected
+    ssc_data_set_array(data, "batch_tilt", tilt, 3);
+    ssc_data_set_array(data, "batch_azimuth", azimuth, 2);
+    EXPECT_TRUE(run_module(data, "pvwattsv8"));
+}
+
 /// Test PVWattsv8 bifacial functionality
 TEST_F(CMPvwattsv8Integration_cmod_pvwattsv8, BifacialTest_cmod_pvwattsv8) {
 
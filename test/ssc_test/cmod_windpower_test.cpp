@@ -136,6 +136,128 @@ TEST_F(CMWindPowerIntegration, WakeModelsUsingFile_cmod_windpower) {
     EXPECT_NEAR(wake_loss, 5, 1e-3) << "Constant: Wake loss";
 }
 
+/// Binned farm response against the wake models run every time step
+TEST_F(CMWindPowerIntegration, WakeModelsUsingResponseBins_cmod_windpower) {
+    for (int wakeModel = 0; wakeModel < 3; wakeModel++) {
+        ssc_data_set_number(data, "wind_farm_wake_model", wakeModel);
+        ssc_data_set_number(data, "wind_farm_response_bins", 0);
+        compute();
+        ssc_number_t exact_energy, exact_loss;
+        ssc_data_get_number(data, "annual_energy", &exact_energy);
+        ssc_data_get_number(data, "wake_losses", &exact_loss);
+
+        ssc_data_set_number(data, "wind_farm_response_bins", 1);
+        compute();
+        ssc_number_t annual_energy, wake_loss, bin_error;
+        ssc_data_get_number(data, "annual_energy", &annual_energy);
+        ssc_data_get_number(data, "wake_losses", &wake_loss);
+        ASSERT_TRUE(ssc_data_get_number(data, "wind_farm_bin_error", &bin_error));
+
+        EXPECT_NEAR(annual_energy / exact_energy, 1., 0.001) << "Wake model " << wakeModel;
+        EXPECT_NEAR(wake_loss, exact_loss, 0.05) << "Wake model " << wakeModel;
+        EXPECT_LT(bin_error, 0.5) << "Wake model " << wakeModel;
+    }
+}
+
+/// Eddy-viscosity wake profiles interpolated from the library against solving each wake
+TEST_F(CMWindPowerIntegration, WakeProfileLibrary_cmod_windpower) {
+    ssc_data_set_number(data, "wind_farm_wake_model", 2);
+    compute();
+    ssc_number_t exact_energy, exact_loss;
+    ssc_data_get_number(data, "annual_energy", &exact_energy);
+    ssc_data_get_number(data, "wake_losses", &exact_loss);
+
+    ssc_data_set_number(data, "wind_farm_wake_profiles", 1);
+    compute();
+    ssc_number_t annual_energy, wake_loss;
+    ssc_data_get_number(data, "annual_energy", &annual_energy);
+    ssc_data_get_number(data, "wake_losses", &wake_loss);
+
+    EXPECT_NEAR(annual_energy / exact_energy, 1., 0.001);
+    EXPECT_NEAR(wake_loss, exact_loss, 0.05);
+}
+
+/// Time steps evaluated across threads give the same results as one thread
+TEST_F(CMWindPowerIntegration, Threads_cmod_windpower) {
+    for (int wakeModel = 0; wakeModel < 3; wakeModel++) {
+        ssc_data_set_number(data, "wind_farm_wake_model", wakeModel);
+        ssc_data_set_number(data, "nthreads", 1);
+        compute();
+        ssc_number_t serial_energy, serial_loss;
+        ssc_data_get_number(data, "annual_energy", &serial_energy);
+        ssc_data_get_number(data, "wake_losses", &serial_loss);
+        int nstep;
+        ssc_number_t *gen = ssc_data_get_array(data, "gen", &nstep);
+        std::vector<ssc_number_t> serial_gen(gen, gen + nstep);
+
+        ssc_data_set_number(data, "nthreads", 4);
+        compute();
+        ssc_number_t annual_energy, wake_loss;
+        ssc_data_get_number(data, "annual_energy", &annual_energy);
+        ssc_data_get_number(data, "wake_losses", &wake_loss);
+        gen = ssc_data_get_array(data, "gen", &nstep);
+
+        EXPECT_EQ(annual_energy, serial_energy) << "Wake model " << wakeModel;
+        EXPECT_EQ(wake_loss, serial_loss) << "Wake model " << wakeModel;
+        ASSERT_EQ((size_t)nstep, serial_gen.size());
+        for (int i = 0; i < nstep; i++)
+            ASSERT_EQ(gen[i], serial_gen[i]) << "Wake model " << wakeModel << ", step " << i;
+    }
+}
+
+/// Candidate layouts evaluated over the resource of one run: the farm's own layout reproduces its results
+TEST_F(CMWindPowerIntegration, LayoutBatch_cmod_windpower) {
+    ssc_data_set_number(data, "wind_farm_wake_model", 1);
+    int nturbines;
+    ssc_number_t *x = ssc_data_get_array(data, "wind_farm_xCoordinates", &nturbines);
+    ssc_number_t *y = ssc_data_get_array(data, "wind_farm_yCoordinates", nullptr);
+
+    // the farm's own layout, then the same layout spread out to five times the spacing
+    std::vector<ssc_number_t> layouts_x(2 * nturbines), layouts_y(2 * nturbines);
+    for (int i = 0; i < nturbines; i++) {
+        layouts_x[i] = x[i];
+        layouts_y[i] = y[i];
+        layouts_x[nturbines + i] = 5 * x[i];
+        layouts_y[nturbines + i] = 5 * y[i];
+    }
+    ssc_data_set_matrix(data, "wind_farm_layouts_x", &layouts_x[0], 2, nturbines);
+    ssc_data_set_matrix(data, "wind_farm_layouts_y", &layouts_y[0], 2, nturbines);
+    EXPECT_TRUE(compute());
+
+    ssc_number_t annual_energy, wake_loss;
+    ssc_data_get_number(data, "annual_energy", &annual_energy);
+    ssc_data_get_number(data, "wake_losses", &wake_loss);
+    int nlayouts, ncols;
+    ssc_number_t *layout_energy = ssc_data_get_array(data, "layout_annual_energy", &nlayouts);
+    ssc_number_t *layout_loss = ssc_data_get_array(data, "layout_wake_losses", nullptr);
+    ssc_number_t *layout_eff = ssc_data_get_matrix(data, "layout_turbine_eff", &nlayouts, &ncols);
+    ASSERT_EQ(nlayouts, 2);
+    ASSERT_EQ(ncols, nturbines);
+
+    EXPECT_NEAR(layout_energy[0] / annual_energy, 1., 1e-5);
+    EXPECT_NEAR(layout_loss[0], wake_loss, 1e-3);
+    EXPECT_LT(layout_loss[1], layout_loss[0]) << "Wider spacing has smaller wake losses";
+    EXPECT_GT(layout_energy[1], layout_energy[0]);
+    double mean_eff = 0;
+    for (int i = 0; i < nturbines; i++) {
+        EXPECT_LE(layout_eff[i], 100. + 1e-6) << "Turbine " << i;
+        mean_eff += layout_eff[i] / nturbines;
+    }
+    EXPECT_NEAR(mean_eff, 100. - layout_loss[0], 1e-3);
+}
+
+/// Candidate layouts are only evaluated with the time series resource
+TEST_F(CMWindPowerIntegration, LayoutBatchWeibull_cmod_windpower) {
+    int nturbines;
+    ssc_number_t *x = ssc_data_get_array(data, "wind_farm_xCoordinates", &nturbines);
+    ssc_number_t *y = ssc_data_get_array(data, "wind_farm_yCoordinates", nullptr);
+    std::vector<ssc_number_t> layouts_x(x, x + nturbines), layouts_y(y, y + nturbines);
+    ssc_data_set_matrix(data, "wind_farm_layouts_x", &layouts_x[0], 1, nturbines);
+    ssc_data_set_matrix(data, "wind_farm_layouts_y", &layouts_y[0], 1, nturbines);
+    ssc_data_set_number(data, "wind_resource_model_choice", 1);
+    EXPECT_FALSE(compute());
+}
+
 /// Using Interpolated Subhourly Wind Data
 TEST_F(CMWindPowerIntegration, UsingInterpolatedSubhourly_cmod_windpower) {
     // Using AR Northwestern-Flat Lands
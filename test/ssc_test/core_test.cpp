@@ -0,0 +1,105 @@
+/*
+BSD 3-Clause License
+
+Copyright Alliance for Sustainable Energy, LLC. See also https://github.com/NREL/ssc/blob/develop/LICENSE
+
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include "core.h"
+#include "vartab.h"
+
+/// Module which only provides its var_table to a timeseries_aggregator
+class aggregator_module : public compute_module {
+public:
+    explicit aggregator_module(var_table *vt) { m_vartab = vt; }
+    void exec() override {}
+};
+
+TEST(timeseries_aggregator_test, SubhourlySums) {
+    size_t step_per_hour = 4;
+    size_t nrec = 8760 * step_per_hour;
+    var_table vt;
+    ssc_number_t *ts = vt.allocate("ts", nrec);
+    ssc_number_t *lifetime = vt.allocate("lifetime", 2 * nrec);
+    for (size_t i = 0; i < nrec; i++) {
+        ts[i] = 2;
+        lifetime[i] = 1;
+        lifetime[nrec + i] = 3;
+    }
+
+    aggregator_module cm(&vt);
+    timeseries_aggregator agg(&cm, step_per_hour);
+    agg.monthly("ts", "ts_monthly", 1. / step_per_hour);
+    agg.annual("ts", "ts_annual", 1. / step_per_hour);
+    agg.monthly_for_year("lifetime", "lifetime_monthly", 1. / step_per_hour, 2);
+    agg.annual_for_year("lifetime", "lifetime_annual", 1. / step_per_hour, 2);
+    agg.compute();
+
+    size_t count = 0;
+    ssc_number_t *monthly = vt.as_array("ts_monthly", &count);
+    ASSERT_EQ(count, 12);
+    ssc_number_t *lifetime_monthly = vt.as_array("lifetime_monthly", &count);
+    ASSERT_EQ(count, 12);
+    for (int m = 0; m < 12; m++) {
+        EXPECT_NEAR(monthly[m], 2. * 24 * util::nday[m], 1e-6) << "month " << m;
+        EXPECT_NEAR(lifetime_monthly[m], 3. * 24 * util::nday[m], 1e-6) << "month " << m;
+    }
+    EXPECT_NEAR(vt.as_number("ts_annual"), 2. * 8760, 1e-3);
+    EXPECT_NEAR(vt.as_number("lifetime_annual"), 3. * 8760, 1e-3);
+    EXPECT_NEAR(agg.annual_value("ts_annual"), 2. * 8760, 1e-3);
+}
+
+TEST(timeseries_aggregator_test, WrongLength) {
+    size_t step_per_hour = 2;
+    size_t nrec = 8760 * step_per_hour;
+    var_table vt;
+    vt.allocate("long", nrec + 1);
+    vt.allocate("short", nrec - 1);
+    aggregator_module cm(&vt);
+
+    // a single year series must have exactly one year of steps
+    timeseries_aggregator single(&cm, step_per_hour);
+    single.monthly("long", "long_monthly");
+    EXPECT_THROW(single.compute(), exec_error);
+
+    // a lifetime series may be longer than the years requested, but not shorter
+    timeseries_aggregator lifetime(&cm, step_per_hour);
+    lifetime.annual_for_year("long", "long_annual");
+    EXPECT_NO_THROW(lifetime.compute());
+
+    timeseries_aggregator short_lifetime(&cm, step_per_hour);
+    short_lifetime.annual_for_year("short", "short_annual");
+    EXPECT_THROW(short_lifetime.compute(), exec_error);
+
+    timeseries_aggregator second_year(&cm, step_per_hour);
+    second_year.annual_for_year("long", "long_annual", 1.0, 2);
+    EXPECT_THROW(second_year.compute(), exec_error);
+}